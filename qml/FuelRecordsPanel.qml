@@ -177,7 +177,7 @@ Rectangle {
                     id: vehicleListView
                     Layout.fillWidth: true
                     Layout.fillHeight: true
-                    model: dataLoader.isLoaded ? dataLoader.vehicles : []
+                    model: dataLoader.isLoaded ? dataLoader.vehicles : null
                     clip: true
                     
                     // 空状态提示
@@ -204,7 +204,7 @@ Rectangle {
                             hoverEnabled: true
                             
                             onClicked: {
-                                fuelRecordsPanel.vehicleSelected(modelData.plateNumber)
+                                fuelRecordsPanel.vehicleSelected(model.plateNumber)
                             }
                         }
                         
@@ -217,7 +217,7 @@ Rectangle {
                             Rectangle {
                                 width: 40
                                 height: 40
-                                color: getVehicleColor(modelData.plateNumber)
+                                color: getVehicleColor(model.plateNumber)
                                 radius: 20
                                 
                                 Text {
@@ -234,20 +234,20 @@ Rectangle {
                                 spacing: 2
                                 
                                 Text {
-                                    text: modelData.plateNumber
+                                    text: model.plateNumber
                                     font.pixelSize: 14
                                     font.bold: true
                                     color: "#2c3e50"
                                 }
                                 
                                 Text {
-                                    text: modelData.records.length + " 条卸油记录"
+                                    text: model.recordCount + " 条卸油记录"
                                     font.pixelSize: 11
                                     color: "#7f8c8d"
                                 }
                                 
                                 Text {
-                                    text: getTotalAmount(modelData.records) + " 吨"
+                                    text: model.totalAmount.toFixed(2) + " 吨"
                                     font.pixelSize: 11
                                     color: "#e74c3c"
                                     font.bold: true
@@ -276,12 +276,4 @@ Rectangle {
         }
         return colors[Math.abs(hash) % colors.length]
     }
-    
-    function getTotalAmount(records) {
-        var total = 0
-        for (var i = 0; i < records.length; i++) {
-            total += records[i].amount
-        }
-        return total.toFixed(2)
-    }
 }
\ No newline at end of file
@@ -314,15 +314,8 @@ Item {
         
         var colors = ["#e74c3c", "#3498db", "#2ecc71", "#f39c12", "#9b59b6"]
         var colorIndex = 0
-        var allRecords = dataLoader.getAllRecords()
-        var vehicleRecords = []
-        
-        // 筛选特定车辆的记录
-        for (var i = 0; i < allRecords.length; i++) {
-            if (allRecords[i].plateNumber === plateNumber) {
-                vehicleRecords.push(allRecords[i])
-            }
-        }
+        // 按车牌索引直接取该车记录
+        var vehicleRecords = dataLoader.getRecordsForVehicle(plateNumber)
         
         // 创建标记
         for (var j = 0; j < vehicleRecords.length; j++) {
@@ -157,17 +157,6 @@ ApplicationWindow {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
                     
-                    // 更新车辆列表 ListView 的 model（按 searchText 前缀过滤）
-                    function updateVehicleListModel() {
-                        if (!controller) {
-                            vehicleListView.model = []
-                            return
-                        }
-                        vehicleListView.model = controller.filteredVehicleList ? controller.filteredVehicleList : []
-                    }
-                    
-                    Component.onCompleted: updateVehicleListModel()
-                    
                     ColumnLayout {
                         anchors.fill: parent
                         spacing: 5
@@ -206,7 +195,6 @@ ApplicationWindow {
                                 onTextChanged: {
                                     if (controller) {
                                         controller.setSearchText(text)
-                                        vehicleListGroupBox.updateVehicleListModel()
                                     }
                                 }
                                 
@@ -246,19 +234,19 @@ ApplicationWindow {
                             Layout.fillWidth: true
                             text: {
                                 if (!controller) return ""
-                                return "找到 " + controller.filteredVehicleList.length + " / " + controller.vehicleList.length + " 辆车"
+                                return "找到 " + controller.vehicleListModel.count + " / " + controller.vehicleListModel.totalCount + " 辆车"
                             }
                             font.pixelSize: 10
                             color: "#7f8c8d"
                             visible: controller && controller.searchText && String(controller.searchText).trim().length > 0
                         }
                         
-                        // 车辆列表：model 由 updateVehicleListModel() 方法更新
+                        // 车辆列表：模型按搜索文本增量过滤，只插入/删除变化的行
                         ListView {
                             id: vehicleListView
                             Layout.fillWidth: true
                             Layout.fillHeight: true
-                            model: []
+                            model: controller ? controller.vehicleListModel : null
                             focus: true
                             keyNavigationEnabled: true
                             clip: true
@@ -289,14 +277,24 @@ ApplicationWindow {
                                 width: vehicleListView.width
                                 height: 60
                                 
-                                plateNumber: modelData
-                                isSelected: controller && typeof controller.selectedVehicle !== 'undefined' && controller.selectedVehicle === modelData
+                                plateNumber: model.plateNumber
+                                vehicleInfo: controller ? controller.getVehicleInfo(model.plateNumber) : ""
+                                isSelected: controller && typeof controller.selectedVehicle !== 'undefined' && controller.selectedVehicle === plateNumber
                                 layoutMode: "horizontal"
                                 showSelectionIndicator: true
                                 
                                 onClicked: {
                                     if (controller && typeof controller.selectVehicle === 'function') {
-                                        controller.selectVehicle(modelData)
+                                        controller.selectVehicle(plateNumber)
+                                    }
+                                }
+                                
+                                // 后台预扫描完成后刷新记录数和时间跨度
+                                Connections {
+                                    target: controller
+                                    function onVehicleInfoUpdated(plate) {
+                                        if (plate === plateNumber)
+                                            vehicleInfo = controller.getVehicleInfo(plateNumber)
                                     }
                                 }
                             }
@@ -386,6 +384,10 @@ ApplicationWindow {
         }
     }
     
+    NotificationDialog {
+        id: validationDialog
+    }
+    
     NotificationDialog {
         id: successDialog
         onOpened: {
@@ -405,14 +407,6 @@ ApplicationWindow {
     Connections {
         target: controller
         
-        function onSearchTextChanged() {
-            vehicleListGroupBox.updateVehicleListModel()
-        }
-        
-        function onVehicleListChanged() {
-            vehicleListGroupBox.updateVehicleListModel()
-        }
-        
         function onFolderScanned(success, message) {
             if (success) {
                 successDialog.showSuccessMessage(message)
@@ -452,6 +446,10 @@ ApplicationWindow {
             errorDialog.showErrorMessage(error)
         }
         
+        function onValidationReportReady(summary) {
+            validationDialog.showMessage("数据校验", summary, false)
+        }
+        
         function onVehiclePositionUpdated(plateNumber, position, direction, speed) {
             // Forward to map display for real-time position updates
             mapDisplay.updateVehiclePosition(plateNumber, position, direction, speed)
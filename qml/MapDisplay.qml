@@ -7,7 +7,7 @@ import CarMove 1.0
 Item {
     id: mapDisplay
     
-    property alias map: mapView.map
+    readonly property var map: mapView ? mapView.map : null
     property var vehicleItems: ({})
     property var trajectoryItems: []
     property string currentVehicle: ""
@@ -27,67 +27,120 @@ Item {
     property int currentMapTypeIndex: 0
     property var availableMapTypes: []
     
-    MapView {
-        id: mapView
-        anchors.fill: parent
-        
-        map.plugin: Plugin {
-            name: "QGroundControl"   // 使用 OpenStreetMap 插件
-            PluginParameter {
-                name: "TiandiTuKey"
-                value: ""
-            }
-            PluginParameter {
-                name: "multiLayer"
-                value: "true"
-            }
+    // 离线瓦片
+    readonly property bool offlineTilesAvailable: typeof controller !== 'undefined' && controller
+                                                  && controller.tileProvider && controller.tileProvider.available
+    
+    // 在线地图：天地图卫星影像 + 注记
+    Plugin {
+        id: onlinePlugin
+        name: "QGroundControl"   // 使用 OpenStreetMap 插件
+        PluginParameter {
+            name: "TiandiTuKey"
+            value: ""
+        }
+        PluginParameter {
+            name: "multiLayer"
+            value: "true"
+        }
 
-            // 直接指定图层列表（按顺序从底到顶）
-            PluginParameter {
-                name: "layers"
-                value: "天地图卫星,天地图卫星注记"
-            }
+        // 直接指定图层列表（按顺序从底到顶）
+        PluginParameter {
+            name: "layers"
+            value: "天地图卫星,天地图卫星注记"
         }
-        map.activeMapType: map.supportedMapTypes[0]
-        map.center: QtPositioning.coordinate(39.9, 116.4) // 北京坐标
-        map.zoomLevel: 12
-        map.minimumZoomLevel: 3
-        map.maximumZoomLevel: 18
-        
-        // 监听用户手动操作地图
-        Connections {
-            target: mapView.map
-            function onCenterChanged() {
-                handleUserMapInteraction("移动地图")
-                // 更新内存中的地图中心位置（不立即保存）
-                updateMapCenter()
-            }
-            function onZoomLevelChanged() {
-                handleUserMapInteraction("缩放地图")
-                // 更新内存中的缩放级别（不立即保存）
-                updateZoomLevel()
-            }
+    }
+
+    // 离线地图：自定义地图类型按需请求 OfflineTileProvider 的本地瓦片服务，瓦片包中没有的瓦片返回 404
+    Plugin {
+        id: offlinePlugin
+        name: "osm"
+        PluginParameter {
+            name: "osm.mapping.providersrepository.disabled"
+            value: "true"
         }
-        
-    Component.onCompleted:{
-        console.log(map.supportedMapTypes)
-        // 初始化可用地图类型列表
-        availableMapTypes = []
-        
-        for (var i = 0; i < map.supportedMapTypes.length; i++) {
-            var mapType = map.supportedMapTypes[i]
-            availableMapTypes.push(mapType)
-            console.log("地图类型 " + i + ":", mapType.name, mapType.description)
+        PluginParameter {
+            name: "osm.mapping.custom.host"
+            value: mapDisplay.offlineTilesAvailable ? controller.tileProvider.tileUrl : ""
         }
+    }
+    
+    // 地图插件只能在地图创建时指定一次：加载地图前按离线瓦片包是否可用选定，
+    // 运行中更换瓦片包只影响本地瓦片服务，插件切换在下次启动时生效
+    property bool useOfflinePlugin: false
+    readonly property var mapView: mapLoader.item
+    
+    Loader {
+        id: mapLoader
+        anchors.fill: parent
+        active: false
+        sourceComponent: mapViewComponent
         
-        // 更新地图类型选择器
-        mapTypeSelector.updateMapTypes(map.supportedMapTypes)
-        
-        // 加载保存的地图配置
-        loadMapConfiguration()
+        Component.onCompleted: {
+            mapDisplay.useOfflinePlugin = mapDisplay.offlineTilesAvailable
+            active = true
+        }
         
-        logMapDisplayMessage("info", "初始化完成，共找到 " + availableMapTypes.length + " 种地图类型")
+        onLoaded: {
+            var loadedMap = item.map
+            console.log(loadedMap.supportedMapTypes)
+            // 初始化可用地图类型列表
+            availableMapTypes = []
+            
+            for (var i = 0; i < loadedMap.supportedMapTypes.length; i++) {
+                var mapType = loadedMap.supportedMapTypes[i]
+                // 离线时只有瓦片包所用的地图类型有本地瓦片
+                if (useOfflinePlugin && mapType.mapId !== controller.tileProvider.mapId) {
+                    continue
+                }
+                availableMapTypes.push(mapType)
+                console.log("地图类型 " + i + ":", mapType.name, mapType.description)
+            }
+            
+            // 更新地图类型选择器
+            mapTypeSelector.updateMapTypes(availableMapTypes)
+            
+            // 设置卸油记录显示的目标地图
+            fuelUnloadingDisplay.setTargetMap(loadedMap)
+            
+            // 加载保存的地图配置
+            loadMapConfiguration()
+            
+            logMapDisplayMessage("info", "初始化完成，共找到 " + availableMapTypes.length + " 种地图类型")
+        }
     }
+    
+    Component {
+        id: mapViewComponent
+        
+        MapView {
+            id: mapView
+            anchors.fill: parent
+        
+            // 有离线瓦片包时使用 osm 插件读取本地瓦片
+            map.plugin: mapDisplay.useOfflinePlugin ? offlinePlugin : onlinePlugin
+            map.activeMapType: map.supportedMapTypes[0]
+            map.center: QtPositioning.coordinate(39.9, 116.4) // 北京坐标
+            map.zoomLevel: 12
+            map.minimumZoomLevel: 3
+            map.maximumZoomLevel: 18
+        
+            // 监听用户手动操作地图（加载完成后才接收，创建过程中的属性初始化不算操作）
+            Connections {
+                target: mapView.map
+                enabled: mapDisplay.mapView !== null
+                function onCenterChanged() {
+                    handleUserMapInteraction("移动地图")
+                    // 更新内存中的地图中心位置（不立即保存）
+                    updateMapCenter()
+                }
+                function onZoomLevelChanged() {
+                    handleUserMapInteraction("缩放地图")
+                    // 更新内存中的缩放级别（不立即保存）
+                    updateZoomLevel()
+                }
+            }
+        }
     }
     
     // 地图定位按钮
@@ -145,6 +198,109 @@ Item {
         }
     }
     
+    // 性能浮层开关
+    StatusButton {
+        id: performanceButton
+        anchors.right: parent.right
+        anchors.top: mapTypeSelector.bottom
+        anchors.rightMargin: 20
+        anchors.topMargin: 10
+        visible: typeof performanceMonitor !== 'undefined'
+        
+        buttonSize: mapDisplay.buttonSize
+        iconText: "📊"
+        buttonColor: performanceOverlay.visible ? "#e67e22" : "#7f8c8d"
+        hoverColor: "#d35400"
+        tooltipText: "显示/隐藏性能指标"
+        
+        onClicked: {
+            performanceOverlay.visible = !performanceOverlay.visible
+        }
+    }
+    
+    // 性能指标浮层（数据来自 PerformanceMonitor，每秒刷新）
+    Rectangle {
+        id: performanceOverlay
+        anchors.left: parent.left
+        anchors.top: parent.top
+        anchors.leftMargin: 20
+        anchors.topMargin: 20
+        width: performanceColumn.implicitWidth + 24
+        height: performanceColumn.implicitHeight + 20
+        color: "#cc2c3e50"
+        radius: 8
+        visible: false
+        z: 1000
+        
+        // 只有浮层可见时才采样
+        onVisibleChanged: {
+            if (typeof performanceMonitor !== 'undefined') {
+                performanceMonitor.active = visible
+            }
+        }
+        
+        Column {
+            id: performanceColumn
+            anchors.centerIn: parent
+            spacing: 4
+            
+            property var monitor: typeof performanceMonitor !== 'undefined' ? performanceMonitor : null
+            
+            Text {
+                color: "white"
+                font.pixelSize: 12
+                font.family: "Consolas"
+                text: performanceColumn.monitor
+                      ? "帧耗时 p50/p99: " + performanceColumn.monitor.frameTimeP50.toFixed(2) + " / "
+                        + performanceColumn.monitor.frameTimeP99.toFixed(2) + " ms"
+                      : ""
+            }
+            Text {
+                color: "white"
+                font.pixelSize: 12
+                font.family: "Consolas"
+                text: performanceColumn.monitor
+                      ? "帧率: " + performanceColumn.monitor.framesPerSecond.toFixed(1) + " fps"
+                      : ""
+            }
+            Text {
+                color: "white"
+                font.pixelSize: 12
+                font.family: "Consolas"
+                text: performanceColumn.monitor
+                      ? "位置更新: " + performanceColumn.monitor.positionsPerSecond.toFixed(0) + " /s"
+                      : ""
+            }
+            Text {
+                color: "white"
+                font.pixelSize: 12
+                font.family: "Consolas"
+                text: performanceColumn.monitor
+                      ? "状态缓存命中率: " + (performanceColumn.monitor.cacheHitRate * 100).toFixed(1) + "% ("
+                        + performanceColumn.monitor.cacheEntries + " 条, "
+                        + performanceColumn.monitor.cacheMemoryMB.toFixed(1) + " MB)"
+                      : ""
+            }
+            Text {
+                color: "white"
+                font.pixelSize: 12
+                font.family: "Consolas"
+                text: performanceColumn.monitor
+                      ? "加载速度: " + performanceColumn.monitor.rowsPerSecond.toFixed(0) + " 行/s ("
+                        + performanceColumn.monitor.lastLoadRows + " 行)"
+                      : ""
+            }
+            Text {
+                color: "white"
+                font.pixelSize: 12
+                font.family: "Consolas"
+                text: performanceColumn.monitor
+                      ? "常驻内存: " + performanceColumn.monitor.residentMemoryMB.toFixed(0) + " MB"
+                      : ""
+            }
+        }
+    }
+    
     // 轨迹线组件
     Component {
         id: trajectoryPolyline
@@ -199,7 +355,7 @@ Item {
     // 动画组件
     MapAnimations {
         id: mapAnimations
-        mapTarget: mapView.map
+        mapTarget: mapDisplay.map
         animationsEnabled: mapDisplay.animationsEnabled
     }
     
@@ -207,11 +363,6 @@ Item {
     FuelUnloadingDisplay {
         id: fuelUnloadingDisplay
         anchors.fill: parent
-        
-        Component.onCompleted: {
-            // 设置目标地图
-            fuelUnloadingDisplay.setTargetMap(mapView.map)
-        }
     }
     
     // 卸油记录相关的代理函数
@@ -244,9 +395,9 @@ Item {
         }
     }
     
-    // Performance monitoring
+    // Marker maintenance
     Timer {
-        id: performanceMonitor
+        id: markerMaintenanceTimer
         interval: 5000 // Check every 5 seconds
         repeat: true
         running: true
@@ -293,6 +293,24 @@ Rectangle {
             }
         }
         
+        // 跳过长时间停留
+        CheckBox {
+            id: skipStopsCheck
+            text: "跳过停留"
+            font.pixelSize: 10
+            checked: controller && typeof controller.skipLongStops !== 'undefined' ? controller.skipLongStops : false
+            enabled: controller && typeof controller.selectedVehicle !== 'undefined' && controller.selectedVehicle
+            
+            onToggled: {
+                if (controller && typeof controller.skipLongStops !== 'undefined') {
+                    controller.skipLongStops = checked
+                }
+            }
+            
+            ToolTip.visible: hovered
+            ToolTip.text: "播放时跳过10分钟以上的停车时段"
+        }
+        
         // 坐标系转换按钮
         Button {
             id: coordinateButton
@@ -80,6 +80,18 @@ Rectangle {
                     wrapMode: Text.NoWrap
                     clip: true
                 }
+                
+                // 记录数和时间跨度（预扫描完成后显示）
+                Text {
+                    anchors.left: parent.left
+                    anchors.right: parent.right
+                    text: vehicleInfo
+                    font.pixelSize: 10
+                    color: isSelected ? selectedTextColor : infoTextColor
+                    elide: Text.ElideRight
+                    wrapMode: Text.NoWrap
+                    visible: vehicleInfo !== ""
+                }
             }
         }
     }
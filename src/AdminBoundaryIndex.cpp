@@ -0,0 +1,367 @@
+#include "AdminBoundaryIndex.h"
+#include "ErrorHandler.h"
+#include <QFile>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool AdminBoundaryIndex::loadGeoJson(const QString& filePath, QString& errorMessage)
+{
+    clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "read");
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    file.close();
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        errorMessage = QString("行政区边界解析失败: %1 (%2)").arg(filePath, parseError.errorString());
+        return false;
+    }
+
+    m_ringOffsets.append(0);
+
+    // 追加一个环，顶点不足 3 个的环忽略
+    auto appendRing = [this](const QJsonArray& ring, Region& region) {
+        if (ring.size() < 3) {
+            return;
+        }
+        for (const QJsonValue& pointValue : ring) {
+            const QJsonArray point = pointValue.toArray();
+            if (point.size() < 2) {
+                continue;
+            }
+            const double longitude = point.at(0).toDouble();
+            const double latitude = point.at(1).toDouble();
+            m_longitudes.append(longitude);
+            m_latitudes.append(latitude);
+            region.minLongitude = qMin(region.minLongitude, longitude);
+            region.maxLongitude = qMax(region.maxLongitude, longitude);
+            region.minLatitude = qMin(region.minLatitude, latitude);
+            region.maxLatitude = qMax(region.maxLatitude, latitude);
+        }
+        m_ringOffsets.append(m_longitudes.size());
+        region.ringCount++;
+    };
+
+    const QJsonArray features = doc.object().value("features").toArray();
+    int skipped = 0;
+    for (const QJsonValue& featureValue : features) {
+        const QJsonObject feature = featureValue.toObject();
+        const QJsonObject properties = feature.value("properties").toObject();
+        const QJsonObject geometry = feature.value("geometry").toObject();
+        const QString type = geometry.value("type").toString();
+        const QJsonArray coordinates = geometry.value("coordinates").toArray();
+
+        Region region;
+        region.code = normalizeCode(properties.value("code"));
+        if (region.code.isEmpty()) {
+            region.code = normalizeCode(properties.value("adcode"));
+        }
+        if (region.code.isEmpty()) {
+            region.code = normalizeCode(properties.value("gb"));
+        }
+        region.name = properties.value("name").toString();
+        region.firstRing = m_ringOffsets.size() - 1;
+        region.minLongitude = region.minLatitude = std::numeric_limits<double>::max();
+        region.maxLongitude = region.maxLatitude = std::numeric_limits<double>::lowest();
+
+        if (type == "Polygon") {
+            for (const QJsonValue& ring : coordinates) {
+                appendRing(ring.toArray(), region);
+            }
+        } else if (type == "MultiPolygon") {
+            for (const QJsonValue& polygon : coordinates) {
+                for (const QJsonValue& ring : polygon.toArray()) {
+                    appendRing(ring.toArray(), region);
+                }
+            }
+        }
+
+        if (region.ringCount == 0 || region.code.isEmpty()) {
+            // 丢弃已追加的顶点，保持环与行政区一一对应
+            m_ringOffsets.resize(region.firstRing + 1);
+            m_longitudes.resize(m_ringOffsets.last());
+            m_latitudes.resize(m_ringOffsets.last());
+            skipped++;
+            continue;
+        }
+        m_regions.append(region);
+    }
+
+    if (m_regions.isEmpty()) {
+        errorMessage = QString("行政区边界文件中没有可用的多边形: %1").arg(filePath);
+        clear();
+        return false;
+    }
+    if (skipped > 0) {
+        qWarning() << "Skipped" << skipped << "boundary features without code or polygon in" << filePath;
+    }
+
+    buildGrid();
+    return true;
+}
+
+void AdminBoundaryIndex::clear()
+{
+    m_regions.clear();
+    m_longitudes.clear();
+    m_latitudes.clear();
+    m_ringOffsets.clear();
+    m_cellOffsets.clear();
+    m_cellRegions.clear();
+    m_gridColumns = 0;
+    m_gridRows = 0;
+}
+
+int AdminBoundaryIndex::locate(double longitude, double latitude, int hint) const
+{
+    const int cell = cellIndex(longitude, latitude);
+    if (cell < 0) {
+        return -1;
+    }
+
+    // 候选按外包框面积升序，第一个命中的就是最小的一级。
+    // 仍在上一个点的行政区内时，只需确认排在它前面（更小）的候选都不含该点，
+    // 这些候选大多在外包框检查时即被排除；从外层进入嵌套的下级区划时不会停留在外层
+    const bool hintContains = hint >= 0 && hint < m_regions.size() && containsPoint(hint, longitude, latitude);
+    for (int i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i) {
+        const int candidate = m_cellRegions[i];
+        if (candidate == hint) {
+            if (hintContains) {
+                return hint;
+            }
+        } else if (containsPoint(candidate, longitude, latitude)) {
+            return candidate;
+        }
+    }
+    return -1;
+}
+
+QVector<int> AdminBoundaryIndex::labelTrajectory(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                                 int threadCount) const
+{
+    const int count = trajectory.size();
+    QVector<int> labels(count, -1);
+    if (count == 0 || m_regions.isEmpty()) {
+        return labels;
+    }
+
+    if (threadCount <= 0) {
+        threadCount = QThread::idealThreadCount();
+    }
+    const int taskCount = qBound(1, count / MIN_POINTS_PER_TASK, threadCount);
+    if (taskCount == 1) {
+        labelRange(trajectory, 0, count, labels.data());
+        return labels;
+    }
+
+    // 按点数均分为连续的段，每段内部仍沿用上一个点的结果
+    int* output = labels.data();
+    QThreadPool pool;
+    pool.setMaxThreadCount(taskCount);
+    const int chunkSize = (count + taskCount - 1) / taskCount;
+    for (int begin = 0; begin < count; begin += chunkSize) {
+        const int end = qMin(begin + chunkSize, count);
+        pool.start([this, &trajectory, begin, end, output]() {
+            labelRange(trajectory, begin, end, output);
+        });
+    }
+    pool.waitForDone();
+
+    return labels;
+}
+
+QList<AdminBoundaryIndex::DayRegion> AdminBoundaryIndex::summarizeDays(
+    const QList<ExcelDataReader::VehicleRecord>& trajectory,
+    const QVector<int>& labels)
+{
+    QList<DayRegion> result;
+    const int count = qMin(trajectory.size(), labels.size());
+
+    QDate currentDate;
+    QHash<int, int> dayEntries;   // 行政区 -> 当天条目在 result 中的下标
+
+    for (int i = 0; i < count; ++i) {
+        const int region = labels[i];
+        if (region < 0) {
+            continue;
+        }
+
+        const auto& record = trajectory[i];
+        const QDate date = record.timestamp.date();
+        if (date != currentDate) {
+            currentDate = date;
+            dayEntries.clear();
+        }
+
+        auto it = dayEntries.constFind(region);
+        if (it == dayEntries.cend()) {
+            DayRegion entry;
+            entry.date = date;
+            entry.region = region;
+            entry.firstTime = record.timestamp;
+            it = dayEntries.insert(region, result.size());
+            result.append(entry);
+        }
+
+        DayRegion& entry = result[it.value()];
+        entry.pointCount++;
+        entry.lastTime = record.timestamp;
+    }
+
+    return result;
+}
+
+bool AdminBoundaryIndex::containsPoint(int regionIndex, double longitude, double latitude) const
+{
+    const Region& region = m_regions[regionIndex];
+    if (!region.boundsContain(longitude, latitude)) {
+        return false;
+    }
+
+    // 奇偶射线法：向东的水平射线与所有环的交点数为奇数则在内
+    bool inside = false;
+    const double* xs = m_longitudes.constData();
+    const double* ys = m_latitudes.constData();
+    const int lastRing = region.firstRing + region.ringCount;
+    for (int ring = region.firstRing; ring < lastRing; ++ring) {
+        const int begin = m_ringOffsets[ring];
+        const int end = m_ringOffsets[ring + 1];
+        for (int i = begin, j = end - 1; i < end; j = i++) {
+            if ((ys[i] > latitude) != (ys[j] > latitude) &&
+                longitude < (xs[j] - xs[i]) * (latitude - ys[i]) / (ys[j] - ys[i]) + xs[i]) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+void AdminBoundaryIndex::labelRange(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                    int begin, int end, int* labels) const
+{
+    int previous = -1;
+    double previousLongitude = std::numeric_limits<double>::quiet_NaN();
+    double previousLatitude = std::numeric_limits<double>::quiet_NaN();
+
+    for (int i = begin; i < end; ++i) {
+        const auto& record = trajectory[i];
+        // 原地不动的点（停车、信号抖动为零）直接复用
+        if (record.longitude != previousLongitude || record.latitude != previousLatitude) {
+            previous = locate(record.longitude, record.latitude, previous);
+            previousLongitude = record.longitude;
+            previousLatitude = record.latitude;
+        }
+        labels[i] = previous;
+    }
+}
+
+int AdminBoundaryIndex::cellIndex(double longitude, double latitude) const
+{
+    if (m_gridColumns == 0 || !qIsFinite(longitude) || !qIsFinite(latitude)) {
+        return -1;
+    }
+
+    const double column = std::floor((longitude - m_gridMinLongitude) / m_cellSize);
+    const double row = std::floor((latitude - m_gridMinLatitude) / m_cellSize);
+    if (column < 0 || row < 0 || column >= m_gridColumns || row >= m_gridRows) {
+        return -1;
+    }
+    return static_cast<int>(row) * m_gridColumns + static_cast<int>(column);
+}
+
+void AdminBoundaryIndex::buildGrid()
+{
+    double minLongitude = std::numeric_limits<double>::max();
+    double minLatitude = std::numeric_limits<double>::max();
+    double maxLongitude = std::numeric_limits<double>::lowest();
+    double maxLatitude = std::numeric_limits<double>::lowest();
+    for (const Region& region : m_regions) {
+        minLongitude = qMin(minLongitude, region.minLongitude);
+        minLatitude = qMin(minLatitude, region.minLatitude);
+        maxLongitude = qMax(maxLongitude, region.maxLongitude);
+        maxLatitude = qMax(maxLatitude, region.maxLatitude);
+    }
+
+    // 网格数约为行政区数的 CELLS_PER_REGION 倍，全国区县约 0.2 度一格
+    const double extentArea = qMax((maxLongitude - minLongitude) * (maxLatitude - minLatitude), 1e-9);
+    m_cellSize = qBound(MIN_CELL_SIZE,
+                        qSqrt(extentArea / (m_regions.size() * CELLS_PER_REGION)),
+                        MAX_CELL_SIZE);
+    m_gridMinLongitude = minLongitude;
+    m_gridMinLatitude = minLatitude;
+    m_gridColumns = static_cast<int>((maxLongitude - minLongitude) / m_cellSize) + 1;
+    m_gridRows = static_cast<int>((maxLatitude - minLatitude) / m_cellSize) + 1;
+
+    auto cellRange = [this](const Region& region, int& column0, int& row0, int& column1, int& row1) {
+        column0 = static_cast<int>((region.minLongitude - m_gridMinLongitude) / m_cellSize);
+        row0 = static_cast<int>((region.minLatitude - m_gridMinLatitude) / m_cellSize);
+        column1 = qMin(static_cast<int>((region.maxLongitude - m_gridMinLongitude) / m_cellSize), m_gridColumns - 1);
+        row1 = qMin(static_cast<int>((region.maxLatitude - m_gridMinLatitude) / m_cellSize), m_gridRows - 1);
+    };
+
+    // 面积小的先放入，每个网格内的候选自然按面积升序
+    QVector<int> order(m_regions.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_regions[a].boundsArea() < m_regions[b].boundsArea();
+    });
+
+    // 两遍构建压缩存储：先计数，再填充
+    const int cellCount = m_gridColumns * m_gridRows;
+    m_cellOffsets.fill(0, cellCount + 1);
+    int column0, row0, column1, row1;
+    for (int index : order) {
+        cellRange(m_regions[index], column0, row0, column1, row1);
+        for (int row = row0; row <= row1; ++row) {
+            for (int column = column0; column <= column1; ++column) {
+                m_cellOffsets[row * m_gridColumns + column + 1]++;
+            }
+        }
+    }
+    for (int c = 0; c < cellCount; ++c) {
+        m_cellOffsets[c + 1] += m_cellOffsets[c];
+    }
+
+    m_cellRegions.resize(m_cellOffsets[cellCount]);
+    QVector<int> cursor(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+    for (int index : order) {
+        cellRange(m_regions[index], column0, row0, column1, row1);
+        for (int row = row0; row <= row1; ++row) {
+            for (int column = column0; column <= column1; ++column) {
+                m_cellRegions[cursor[row * m_gridColumns + column]++] = index;
+            }
+        }
+    }
+}
+
+QString AdminBoundaryIndex::normalizeCode(const QJsonValue& value)
+{
+    QString code;
+    if (value.isString()) {
+        code = value.toString().trimmed();
+    } else if (value.isDouble()) {
+        code = QString::number(static_cast<qint64>(value.toDouble()));
+    }
+
+    // 民政部 6 位行政区划代码 -> AdminCode.csv 的 9 位国标码
+    if (code.size() == 6) {
+        code.prepend("156");
+    }
+    return code;
+}
@@ -0,0 +1,120 @@
+#ifndef ADMINBOUNDARYINDEX_H
+#define ADMINBOUNDARYINDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QDate>
+#include <QDateTime>
+#include <QJsonValue>
+#include "ExcelDataReader.h"
+
+/**
+ * @class AdminBoundaryIndex
+ * @brief 离线逆地理编码：由行政区边界多边形判断轨迹点所在的行政区
+ *
+ * 边界从 GeoJSON FeatureCollection 加载（Polygon / MultiPolygon），每个要素的
+ * 国标码取 properties 中的 code / adcode / gb 字段，6 位行政区划代码自动补 "156"
+ * 前缀，与 AdminCode.csv 的 9 位国标码一致。边界坐标须与轨迹同一坐标系（WGS84 /
+ * CGCS2000），即在 GCJ-02 转换之前查询。
+ *
+ * - 规则网格空间索引：每个网格只保存外包框与之相交的行政区，按外包框面积升序，
+ *   同一点落在多级区划中时返回最小的一级（区县优先于地市、省）
+ * - 点在多边形内用奇偶射线法，同一要素的所有环一起计数，洞和多部件自然处理
+ * - 连续轨迹点大多在同一行政区内，标注时沿用上一个点的结果，只需排除网格中
+ *   比它更小的候选，不必对更大的候选做点在多边形内判断
+ * - 加载后只读，可被多个线程同时查询
+ */
+class AdminBoundaryIndex
+{
+public:
+    struct Region {
+        QString code;                 // 9 位国标码
+        QString name;
+        double minLongitude = 0.0;
+        double minLatitude = 0.0;
+        double maxLongitude = 0.0;
+        double maxLatitude = 0.0;
+        int firstRing = 0;            // 环在 m_ringOffsets 中的起始下标
+        int ringCount = 0;
+
+        bool boundsContain(double longitude, double latitude) const {
+            return longitude >= minLongitude && longitude <= maxLongitude &&
+                   latitude >= minLatitude && latitude <= maxLatitude;
+        }
+        double boundsArea() const {
+            return (maxLongitude - minLongitude) * (maxLatitude - minLatitude);
+        }
+    };
+
+    // 某天在某行政区内的轨迹点
+    struct DayRegion {
+        QDate date;
+        int region = -1;
+        int pointCount = 0;
+        QDateTime firstTime;
+        QDateTime lastTime;
+    };
+
+    bool loadGeoJson(const QString& filePath, QString& errorMessage);
+    void clear();
+
+    bool isEmpty() const { return m_regions.isEmpty(); }
+    int size() const { return m_regions.size(); }
+    const Region& region(int index) const { return m_regions.at(index); }
+
+    /**
+     * @brief 查询点所在的行政区
+     * @param hint 上一个点的结果，点仍在该区内且不在更小的区划内时返回
+     * @return 行政区下标，不在任何行政区内返回 -1
+     */
+    int locate(double longitude, double latitude, int hint = -1) const;
+
+    /**
+     * @brief 为整条轨迹逐点标注行政区
+     * @param threadCount 并行分段数，0 = 全部核心，1 = 在调用线程内完成
+     *                    （在线程池任务中调用时应传 1，避免嵌套占满线程池）
+     * @return 与 trajectory 等长的行政区下标
+     */
+    QVector<int> labelTrajectory(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                 int threadCount = 0) const;
+
+    /**
+     * @brief 按天汇总标注结果（每天每个行政区一条，按日期、首次进入时间排序）
+     * @note 不在任何行政区内的点不计入
+     */
+    static QList<DayRegion> summarizeDays(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                          const QVector<int>& labels);
+
+private:
+    bool containsPoint(int regionIndex, double longitude, double latitude) const;
+    void labelRange(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                    int begin, int end, int* labels) const;
+    int cellIndex(double longitude, double latitude) const;
+    void buildGrid();
+
+    static QString normalizeCode(const QJsonValue& value);
+
+    QVector<Region> m_regions;
+
+    // 所有环的顶点连续存放：第 i 个环为 [m_ringOffsets[i], m_ringOffsets[i + 1])
+    QVector<double> m_longitudes;
+    QVector<double> m_latitudes;
+    QVector<int> m_ringOffsets;
+
+    // 规则网格，第 c 个网格的候选行政区为 m_cellRegions[m_cellOffsets[c] .. m_cellOffsets[c + 1])
+    double m_gridMinLongitude = 0.0;
+    double m_gridMinLatitude = 0.0;
+    double m_cellSize = 1.0;
+    int m_gridColumns = 0;
+    int m_gridRows = 0;
+    QVector<int> m_cellOffsets;
+    QVector<int> m_cellRegions;
+
+    static constexpr double MIN_CELL_SIZE = 0.05;     // 度
+    static constexpr double MAX_CELL_SIZE = 1.0;
+    static constexpr int CELLS_PER_REGION = 4;
+    static constexpr int MIN_POINTS_PER_TASK = 16384; // 太短的轨迹不拆分
+};
+
+#endif // ADMINBOUNDARYINDEX_H
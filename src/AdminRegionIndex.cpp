@@ -0,0 +1,167 @@
+#include "AdminRegionIndex.h"
+#include <QFile>
+#include <algorithm>
+#include <cstring>
+
+bool AdminRegionIndex::load(const QString &filePath) {
+    m_regions.clear();
+    m_foldedNames.clear();
+    m_byName.clear();
+    m_byBaseName.clear();
+    m_sortedByName.clear();
+    m_loaded = false;
+
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = f.readAll();
+
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    if (data.startsWith("\xEF\xBB\xBF"))
+        p += 3;
+
+    // 每行：名称,?,国标码,...，只取第 0 列和第 2 列
+    QHash<QString, int> baseNameRank;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd)
+            lineEnd = end;
+
+        const char *fieldStart[3] = {p, nullptr, nullptr};
+        const char *fieldEnd[3] = {nullptr, nullptr, lineEnd};
+        int field = 0;
+        for (const char *q = p; q < lineEnd && field < 3; ++q) {
+            if (*q != ',')
+                continue;
+            fieldEnd[field] = q;
+            if (++field < 3)
+                fieldStart[field] = q + 1;
+        }
+
+        if (field >= 2) {
+            const QString name =
+                QString::fromUtf8(fieldStart[0], fieldEnd[0] - fieldStart[0]).trimmed();
+            const QString code =
+                QString::fromUtf8(fieldStart[2], fieldEnd[2] - fieldStart[2]).trimmed();
+            if (!name.isEmpty() && code.length() == 9) {
+                const int index = m_regions.size();
+                m_regions.append({name, code});
+                m_foldedNames.append(name.toCaseFolded());
+                m_byName.insert(name, index);
+
+                QString baseName;
+                const int rank = suffixRank(name, &baseName);
+                if (rank > 0 && rank >= baseNameRank.value(baseName, 0)) {
+                    baseNameRank.insert(baseName, rank);
+                    m_byBaseName.insert(baseName, index);
+                }
+            }
+        }
+        p = lineEnd + 1;
+    }
+
+    m_sortedByName.resize(m_regions.size());
+    for (int i = 0; i < m_sortedByName.size(); ++i)
+        m_sortedByName[i] = i;
+    std::stable_sort(m_sortedByName.begin(), m_sortedByName.end(), [this](int a, int b) {
+        return m_regions.at(a).name < m_regions.at(b).name;
+    });
+
+    m_loaded = true;
+    return true;
+}
+
+int AdminRegionIndex::indexOfName(const QString &name) const {
+    return m_byName.value(name, -1);
+}
+
+int AdminRegionIndex::resolveName(const QString &name) const {
+    const int index = indexOfName(name);
+    return index >= 0 ? index : m_byBaseName.value(name, -1);
+}
+
+QVector<int> AdminRegionIndex::prefixMatches(const QString &prefix, int limit) const {
+    QVector<int> result;
+    auto it = std::lower_bound(m_sortedByName.cbegin(), m_sortedByName.cend(), prefix,
+                               [this](int index, const QString &value) {
+                                   return m_regions.at(index).name < value;
+                               });
+    for (; it != m_sortedByName.cend() && result.size() < limit; ++it) {
+        if (!m_regions.at(*it).name.startsWith(prefix))
+            break;
+        result.append(*it);
+    }
+    return result;
+}
+
+QVector<int> AdminRegionIndex::fuzzyMatches(const QString &query, int limit) const {
+    const QString folded = query.simplified().toCaseFolded();
+    if (folded.isEmpty() || limit <= 0)
+        return {};
+
+    struct Candidate {
+        int rank;
+        int length;
+        int index;
+        bool operator<(const Candidate &other) const {
+            if (rank != other.rank)
+                return rank < other.rank;
+            if (length != other.length)
+                return length < other.length;
+            return index < other.index;
+        }
+    };
+
+    QVector<Candidate> candidates;
+    for (int i = 0; i < m_foldedNames.size(); ++i) {
+        const QString &name = m_foldedNames.at(i);
+        int rank;
+        if (name == folded)
+            rank = 0;
+        else if (name.startsWith(folded))
+            rank = 1;
+        else if (name.contains(folded))
+            rank = 2;
+        else if (isSubsequence(folded, name))
+            rank = 3;
+        else
+            continue;
+        candidates.append({rank, int(name.size()), i});
+    }
+
+    const int count = qMin(limit, int(candidates.size()));
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+    QVector<int> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i)
+        result.append(candidates.at(i).index);
+    return result;
+}
+
+int AdminRegionIndex::suffixRank(const QString &name, QString *baseName) {
+    // 与原先的后缀猜测顺序一致：市 > 省 > 自治区
+    static const struct {
+        const char *suffix;
+        int rank;
+    } kSuffixes[] = {{"市", 3}, {"省", 2}, {"自治区", 1}};
+
+    for (const auto &entry : kSuffixes) {
+        const QString suffix = QString::fromUtf8(entry.suffix);
+        if (name.size() > suffix.size() && name.endsWith(suffix)) {
+            *baseName = name.left(name.size() - suffix.size());
+            return entry.rank;
+        }
+    }
+    return 0;
+}
+
+bool AdminRegionIndex::isSubsequence(const QString &query, const QString &text) {
+    int q = 0;
+    for (int i = 0; i < text.size() && q < query.size(); ++i) {
+        if (text.at(i) == query.at(q))
+            ++q;
+    }
+    return q == query.size();
+}
@@ -0,0 +1,51 @@
+#ifndef ADMIN_REGION_INDEX_H
+#define ADMIN_REGION_INDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief AdminCode.csv 行政区表的索引（名称 -> 9 位国标码）
+ * - 按字节一次扫描整个文件，只解码名称和国标码两列
+ * - 名称精确查找 + 去掉「市/省/自治区」后的简称查找，各一次哈希
+ * - 按名称排序的下标数组做前缀查找（二分定位后顺序扫描）
+ * - 模糊匹配按 精确 > 前缀 > 包含 > 按序包含所有字符 排序，供下拉搜索使用
+ */
+class AdminRegionIndex
+{
+public:
+    struct Region {
+        QString name;
+        QString code;
+    };
+
+    bool load(const QString &filePath);
+    bool isLoaded() const { return m_loaded; }
+
+    int size() const { return m_regions.size(); }
+    const Region &at(int index) const { return m_regions.at(index); }
+
+    /// 名称精确匹配，未找到返回 -1（重名时取 CSV 中最后一个，与原先哈希覆盖一致）
+    int indexOfName(const QString &name) const;
+    /// 精确匹配，否则按简称匹配（北京 -> 北京市，优先级 市 > 省 > 自治区）
+    int resolveName(const QString &name) const;
+
+    /// 名称以 prefix 开头的行政区，按名称排序
+    QVector<int> prefixMatches(const QString &prefix, int limit) const;
+    /// 模糊匹配，按匹配程度和名称长度排序
+    QVector<int> fuzzyMatches(const QString &query, int limit) const;
+
+private:
+    static int suffixRank(const QString &name, QString *baseName);
+    static bool isSubsequence(const QString &query, const QString &text);
+
+    QVector<Region> m_regions;                 ///< CSV 顺序
+    QVector<QString> m_foldedNames;            ///< 大小写折叠后的名称，用于模糊匹配
+    QHash<QString, int> m_byName;
+    QHash<QString, int> m_byBaseName;          ///< 简称 -> 下标
+    QVector<int> m_sortedByName;               ///< 按名称排序的下标
+    bool m_loaded = false;
+};
+
+#endif // ADMIN_REGION_INDEX_H
@@ -0,0 +1,96 @@
+#include "AdminRegionListModel.h"
+#include "AdminRegionIndex.h"
+
+AdminRegionListModel::AdminRegionListModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int AdminRegionListModel::rowCount(const QModelIndex &parent) const {
+    const AdminRegionIndex *regions = regionIndex();
+    if (parent.isValid() || !regions)
+        return 0;
+    return m_filtered ? m_rows.size() : regions->size();
+}
+
+QVariant AdminRegionListModel::data(const QModelIndex &index, int role) const {
+    const int region = index.isValid() ? regionAt(index.row()) : -1;
+    if (region < 0)
+        return QVariant();
+
+    switch (role) {
+    case NameRole:
+    case Qt::DisplayRole:
+        return regionIndex()->at(region).name;
+    case CodeRole:
+        return regionIndex()->at(region).code;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> AdminRegionListModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[CodeRole] = "code";
+    return roles;
+}
+
+void AdminRegionListModel::setGeocoder(TiandituGeocoder *geocoder) {
+    if (m_geocoder == geocoder)
+        return;
+    m_geocoder = geocoder;
+    applyFilter();
+    emit geocoderChanged();
+}
+
+void AdminRegionListModel::setFilterText(const QString &text) {
+    if (m_filterText == text)
+        return;
+    m_filterText = text;
+    applyFilter();
+    emit filterTextChanged();
+}
+
+void AdminRegionListModel::setMaxResults(int maxResults) {
+    maxResults = qMax(1, maxResults);
+    if (m_maxResults == maxResults)
+        return;
+    m_maxResults = maxResults;
+    if (m_filtered)
+        applyFilter();
+    emit maxResultsChanged();
+}
+
+QString AdminRegionListModel::nameAt(int row) const {
+    const int region = regionAt(row);
+    return region >= 0 ? regionIndex()->at(region).name : QString();
+}
+
+QString AdminRegionListModel::codeAt(int row) const {
+    const int region = regionAt(row);
+    return region >= 0 ? regionIndex()->at(region).code : QString();
+}
+
+const AdminRegionIndex *AdminRegionListModel::regionIndex() const {
+    return m_geocoder ? &m_geocoder->adminIndex() : nullptr;
+}
+
+int AdminRegionListModel::regionAt(int row) const {
+    if (row < 0 || row >= rowCount())
+        return -1;
+    return m_filtered ? m_rows.at(row) : row;
+}
+
+void AdminRegionListModel::applyFilter() {
+    beginResetModel();
+    const AdminRegionIndex *regions = regionIndex();
+    const QString query = m_filterText.trimmed();
+    m_filtered = !query.isEmpty();
+    m_rows.clear();
+    if (m_filtered && regions) {
+        // 前缀查找只访问匹配区间；没有前缀匹配时才扫描全表做模糊匹配
+        m_rows = regions->prefixMatches(query, m_maxResults);
+        if (m_rows.isEmpty())
+            m_rows = regions->fuzzyMatches(query, m_maxResults);
+    }
+    endResetModel();
+    emit countChanged();
+}
@@ -0,0 +1,68 @@
+#ifndef ADMIN_REGION_LIST_MODEL_H
+#define ADMIN_REGION_LIST_MODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QVector>
+#include "TiandituGeocoder.h"
+
+/**
+ * @brief 行政区下拉列表模型，直接读取 TiandituGeocoder 的 AdminRegionIndex，不复制名称列表
+ * - 在 QML 中创建并设置 geocoder，行政区表在此时才加载
+ * - filterText 为空时按 CSV 顺序列出全部行政区
+ * - 否则按名称前缀查找（二分，按名称排序，最多 maxResults 条）；
+ *   没有前缀匹配时才退回模糊匹配，匹配程度高、名称短的排在前面
+ */
+class AdminRegionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(TiandituGeocoder *geocoder READ geocoder WRITE setGeocoder NOTIFY geocoderChanged)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+    Q_PROPERTY(int maxResults READ maxResults WRITE setMaxResults NOTIFY maxResultsChanged)
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        CodeRole
+    };
+
+    explicit AdminRegionListModel(QObject *parent = nullptr);
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    TiandituGeocoder *geocoder() const { return m_geocoder; }
+    void setGeocoder(TiandituGeocoder *geocoder);
+
+    QString filterText() const { return m_filterText; }
+    void setFilterText(const QString &text);
+
+    int maxResults() const { return m_maxResults; }
+    void setMaxResults(int maxResults);
+
+    Q_INVOKABLE QString nameAt(int row) const;
+    Q_INVOKABLE QString codeAt(int row) const;
+
+signals:
+    void geocoderChanged();
+    void countChanged();
+    void filterTextChanged();
+    void maxResultsChanged();
+
+private:
+    const AdminRegionIndex *regionIndex() const; ///< 未设置 geocoder 时为 nullptr
+    int regionAt(int row) const;
+    void applyFilter();
+
+    QPointer<TiandituGeocoder> m_geocoder;
+    QString m_filterText;
+    int m_maxResults = 50;
+    bool m_filtered = false;
+    QVector<int> m_rows; ///< 过滤时可见行对应的行政区下标
+};
+
+#endif // ADMIN_REGION_LIST_MODEL_H
@@ -0,0 +1,511 @@
+#include "BatchProcessor.h"
+#include "VehicleManager.h"
+#include "ErrorHandler.h"
+#include "ConfigManager.h"
+#include "Tracer.h"
+#include "StringPool.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QMutexLocker>
+#include <algorithm>
+
+BatchProcessor::BatchProcessor(const Options& options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+}
+
+BatchProcessor::~BatchProcessor()
+{
+    m_statsStream.flush();
+    m_visitStream.flush();
+}
+
+int BatchProcessor::run()
+{
+    // Scan folder (synchronous, only collects file paths per plate)
+    FolderScanner scanner;
+    QString scanErrorMessage;
+    connect(&scanner, &FolderScanner::scanError,
+            [&scanErrorMessage](const QString& error) {
+        scanErrorMessage = error;
+    });
+
+    scanner.scanFolder(m_options.inputFolder);
+    QList<FolderScanner::VehicleInfo> vehicles = scanner.getVehicleList();
+
+    if (vehicles.isEmpty()) {
+        return fail(ErrorHandler::FileAccessError,
+                    scanErrorMessage.isEmpty() ? QString("没有找到车辆数据: %1").arg(m_options.inputFolder)
+                                               : scanErrorMessage);
+    }
+
+    QDir outputDir(m_options.outputFolder);
+    if (!outputDir.mkpath(".") ||
+        (m_options.writeTrajectories && !outputDir.mkpath("trajectories"))) {
+        return fail(ErrorHandler::FileAccessError, HANDLE_FILE_ERROR(m_options.outputFolder, "创建输出目录"));
+    }
+
+    QString errorMessage;
+    if (!loadFuelRecords(errorMessage) ||
+        (!m_options.regionBoundariesFile.isEmpty() &&
+         !m_regionIndex.loadGeoJson(m_options.regionBoundariesFile, errorMessage)) ||
+        !openSummaryFiles(errorMessage)) {
+        return fail(ErrorHandler::FileAccessError, errorMessage);
+    }
+
+    // 整个批处理使用同一份配置快照（单例必须先在主线程创建）
+    m_config = ConfigManager::GetInstance()->snapshot();
+
+    m_totalCount = vehicles.size();
+    m_processedCount = 0;
+    m_failedCount = 0;
+
+    // One task per vehicle; each task owns only its own records, so peak memory
+    // is bounded by the number of worker threads rather than by the fleet size.
+    QThreadPool pool;
+    if (m_options.threadCount > 0) {
+        pool.setMaxThreadCount(m_options.threadCount);
+    }
+
+    for (const auto& info : vehicles) {
+        pool.start([this, info]() {
+            processVehicle(info);
+        });
+    }
+
+    while (!pool.waitForDone(ERROR_DRAIN_INTERVAL_MS)) {
+        m_errorHandler.drain();
+    }
+
+    // 卸油记录中有、但没有可用轨迹（含处理失败）的车辆
+    for (auto it = m_fuelRecordsByPlate.cbegin(); it != m_fuelRecordsByPlate.cend(); ++it) {
+        if (m_fuelMatchedPlates.contains(it.key())) {
+            continue;
+        }
+        QList<FuelTrajectoryMatcher::MatchResult> unmatchedResults;
+        for (const auto& record : it.value()) {
+            unmatchedResults.append(FuelTrajectoryMatcher::unmatched(record));
+        }
+        appendFuelMatches(it.key(), unmatchedResults);
+    }
+
+    {
+        QMutexLocker locker(&m_summaryMutex);
+        m_statsStream.flush();
+        m_visitStream.flush();
+        m_tripStream.flush();
+        m_fuelMatchStream.flush();
+        m_regionDayStream.flush();
+        m_statsFile.close();
+        m_visitFile.close();
+        m_tripFile.close();
+        m_fuelMatchFile.close();
+        m_regionDayFile.close();
+    }
+
+    // 所有车辆的数据校验问题只输出一次
+    ErrorHandler::handleValidationReport(m_validationReport, QString("批处理 %1").arg(m_options.inputFolder));
+    m_errorHandler.drain();
+
+    return m_failedCount > 0 ? 2 : 0;
+}
+
+int BatchProcessor::fail(ErrorHandler::ErrorType type, const QString& message)
+{
+    m_errorHandler.reportError(type, ErrorHandler::Critical, message, message,
+                               m_options.inputFolder, "BatchProcessor");
+    m_errorHandler.drain();
+    return 1;
+}
+
+void BatchProcessor::processVehicle(const FolderScanner::VehicleInfo& info)
+{
+    TRACE_SCOPE("BatchProcessor::processVehicle");
+    try {
+        // 每个任务使用独立的读取器，避免跨线程共享 QObject；
+        // 车辆之间已经并行，文件内不再并行解析，线程数不随核心数相乘
+        ExcelDataReader reader;
+        reader.setParseThreadCount(1);
+        QList<ExcelDataReader::VehicleRecord> allRecords;
+        QString lastError;
+        connect(&reader, &ExcelDataReader::errorOccurred,
+                [&lastError](const QString& error) {
+            lastError = error;
+        });
+
+        ValidationReport validationReport;
+        for (const QString& filePath : info.filePaths) {
+            const bool loaded = reader.loadExcelFile(filePath, m_config);
+            validationReport.merge(reader.validationReport());
+            if (!loaded) {
+                m_errorHandler.reportError(ErrorHandler::DataFormatError, ErrorHandler::Warning,
+                                           QString("Failed to load file: %1").arg(lastError), lastError,
+                                           filePath, "BatchProcessor");
+                continue;
+            }
+
+            const QList<ExcelDataReader::VehicleRecord> fileRecords = reader.getVehicleData();
+            const int plateId = StringPool::plates().find(info.plateNumber);
+            for (const auto& record : fileRecords) {
+                if (plateId >= 0 && record.plateId == plateId) {
+                    allRecords.append(record);
+                }
+            }
+        }
+
+        {
+            QMutexLocker locker(&m_summaryMutex);
+            m_validationReport.merge(validationReport);
+        }
+
+        if (allRecords.isEmpty()) {
+            m_failedCount++;
+            emit vehicleFailed(info.plateNumber,
+                               lastError.isEmpty() ? QString("没有有效记录") : lastError);
+            emit vehicleProcessed(info.plateNumber, ++m_processedCount, m_totalCount);
+            return;
+        }
+
+        // Same pipeline as VehicleManager::loadVehicleTrajectory
+        std::sort(allRecords.begin(), allRecords.end(),
+                  [](const ExcelDataReader::VehicleRecord& a, const ExcelDataReader::VehicleRecord& b) {
+                      return a.timestamp < b.timestamp;
+                  });
+
+        int rawRecordCount = allRecords.size();
+        QList<StopDetector::StopEvent> stops;
+        QList<ExcelDataReader::VehicleRecord> trajectory = StopDetector::detect(allRecords, stops);
+        allRecords.clear();
+
+        // 统计与到访天数基于原始（WGS84）坐标
+        VehicleStats stats = computeStats(info.plateNumber, info.filePaths.size(), rawRecordCount, trajectory);
+        const QList<TripSegmenter::TripSummary> trips = TripSegmenter::segment(trajectory, stops);
+        stats.tripCount = trips.size();
+
+        // 卸油核对使用原始坐标，需在坐标转换之前完成
+        // （轨迹写出成功后才与其他汇总一起追加）
+        auto fuelIt = m_fuelRecordsByPlate.constFind(info.plateNumber);
+        const bool hasFuelRecords = fuelIt != m_fuelRecordsByPlate.cend();
+        QList<FuelTrajectoryMatcher::MatchResult> fuelMatches;
+        if (hasFuelRecords) {
+            FuelTrajectoryMatcher::Options matchOptions{m_options.fuelTimeWindowSecs, m_options.fuelToleranceMeters};
+            fuelMatches = FuelTrajectoryMatcher::matchVehicle(fuelIt.value(), trajectory, stops, matchOptions);
+        }
+
+        // 逆地理编码同样基于原始坐标；已在线程池任务中，单线程标注
+        QList<AdminBoundaryIndex::DayRegion> regionDays;
+        if (!m_regionIndex.isEmpty()) {
+            regionDays = AdminBoundaryIndex::summarizeDays(trajectory, m_regionIndex.labelTrajectory(trajectory, 1));
+        }
+
+        // 网格索引每辆车建立一次，所有目标共用
+        QList<int> visitDays;
+        if (!m_options.visitTargets.isEmpty()) {
+            const PointGrid trajectoryGrid = VehicleManager::buildTrajectoryGrid(trajectory);
+            StopDetector stopIndex;
+            stopIndex.setStops(stops);
+            for (const auto& target : m_options.visitTargets) {
+                visitDays.append(VehicleManager::countVisitDays(trajectory, trajectoryGrid, stopIndex,
+                                                                target.center, target.radiusMeters));
+            }
+        }
+
+        if (m_options.writeTrajectories) {
+            if (m_options.convertToGcj02) {
+                trajectory = VehicleManager::convertToGcj02(trajectory);
+            }
+
+            QString writeError;
+            if (!writeTrajectory(info.plateNumber, trajectory, writeError)) {
+                // 轨迹未写出的车辆计为失败，不进入任何汇总（含卸油核对）
+                m_failedCount++;
+                emit vehicleFailed(info.plateNumber, writeError);
+                emit vehicleProcessed(info.plateNumber, ++m_processedCount, m_totalCount);
+                return;
+            }
+        }
+
+        appendStats(stats);
+        appendTrips(info.plateNumber, trips);
+        if (hasFuelRecords) {
+            appendFuelMatches(info.plateNumber, fuelMatches);
+        }
+        if (!m_options.visitTargets.isEmpty()) {
+            appendVisitDays(info.plateNumber, visitDays);
+        }
+        if (!m_regionIndex.isEmpty()) {
+            appendRegionDays(info.plateNumber, regionDays);
+        }
+
+    } catch (const std::bad_alloc&) {
+        m_failedCount++;
+        emit vehicleFailed(info.plateNumber, HANDLE_MEMORY_ERROR("批处理车辆数据"));
+    } catch (const std::exception& e) {
+        m_failedCount++;
+        emit vehicleFailed(info.plateNumber, HANDLE_SYSTEM_ERROR("批处理车辆数据", e.what()));
+    } catch (...) {
+        m_failedCount++;
+        emit vehicleFailed(info.plateNumber, HANDLE_SYSTEM_ERROR("批处理车辆数据", "未知异常"));
+    }
+
+    emit vehicleProcessed(info.plateNumber, ++m_processedCount, m_totalCount);
+}
+
+BatchProcessor::VehicleStats BatchProcessor::computeStats(const QString& plateNumber, int fileCount,
+                                                          int rawRecordCount,
+                                                          const QList<ExcelDataReader::VehicleRecord>& trajectory)
+{
+    VehicleStats stats;
+    stats.plateNumber = plateNumber;
+    stats.fileCount = fileCount;
+    stats.rawRecordCount = rawRecordCount;
+    stats.recordCount = trajectory.size();
+
+    if (trajectory.isEmpty()) {
+        return stats;
+    }
+
+    stats.firstTimestamp = trajectory.first().timestamp;
+    stats.lastTimestamp = trajectory.last().timestamp;
+
+    double totalMeters = 0.0;
+    double movingSpeedSum = 0.0;
+    int movingCount = 0;
+
+    for (int i = 0; i < trajectory.size(); ++i) {
+        const auto& record = trajectory[i];
+
+        if (i > 0) {
+            totalMeters += trajectory[i - 1].coordinate().distanceTo(record.coordinate());
+        }
+
+        stats.maxSpeed = qMax(stats.maxSpeed, record.speed);
+        if (record.speed > 0.0) {
+            movingSpeedSum += record.speed;
+            movingCount++;
+        }
+    }
+
+    stats.distanceKm = totalMeters / 1000.0;
+    stats.avgMovingSpeed = movingCount > 0 ? movingSpeedSum / movingCount : 0.0;
+
+    return stats;
+}
+
+bool BatchProcessor::writeTrajectory(const QString& plateNumber,
+                                     const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                     QString& errorMessage) const
+{
+    QString filePath = QDir(m_options.outputFolder).filePath(QString("trajectories/%1.csv").arg(plateNumber));
+
+    // QSaveFile 写临时文件后原子替换，中途失败不会留下半个文件
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "write");
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out << "plateNumber,vehicleColor,timestamp,latitude,longitude,speed,direction,distance,totalMileage\n";
+
+    for (const auto& record : trajectory) {
+        out << record.plateNumber << ','
+            << record.vehicleColor << ','
+            << record.timestamp.toString("yyyy-MM-dd hh:mm:ss") << ','
+            << qSetRealNumberPrecision(6) << record.latitude << ','
+            << record.longitude << ','
+            << qSetRealNumberPrecision(1) << record.speed << ','
+            << record.direction << ','
+            << record.distance << ','
+            << record.totalMileage << '\n';
+    }
+
+    out.flush();
+    if (!file.commit()) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "write");
+        return false;
+    }
+
+    return true;
+}
+
+bool BatchProcessor::openSummaryFiles(QString& errorMessage)
+{
+    QDir outputDir(m_options.outputFolder);
+
+    m_statsFile.setFileName(outputDir.filePath("vehicle_stats.csv"));
+    if (!m_statsFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        errorMessage = HANDLE_FILE_ERROR(m_statsFile.fileName(), "write");
+        return false;
+    }
+    m_statsStream.setDevice(&m_statsFile);
+    m_statsStream.setRealNumberNotation(QTextStream::FixedNotation);
+    m_statsStream.setRealNumberPrecision(3);
+    m_statsStream << "plateNumber,files,rawRecords,records,firstTimestamp,lastTimestamp,"
+                     "distanceKm,maxSpeed,avgMovingSpeed,trips\n";
+
+    m_tripFile.setFileName(outputDir.filePath("trips.csv"));
+    if (!m_tripFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        errorMessage = HANDLE_FILE_ERROR(m_tripFile.fileName(), "write");
+        return false;
+    }
+    m_tripStream.setDevice(&m_tripFile);
+    m_tripStream.setRealNumberNotation(QTextStream::FixedNotation);
+    m_tripStream.setRealNumberPrecision(3);
+    m_tripStream << "plateNumber,trip,startTime,endTime,durationSecs,distanceKm,maxSpeed,avgSpeed,"
+                    "minLatitude,maxLatitude,minLongitude,maxLongitude,points\n";
+
+    if (!m_options.fuelRecordsFile.isEmpty()) {
+        m_fuelMatchFile.setFileName(outputDir.filePath("fuel_matches.csv"));
+        if (!m_fuelMatchFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            errorMessage = HANDLE_FILE_ERROR(m_fuelMatchFile.fileName(), "write");
+            return false;
+        }
+        m_fuelMatchStream.setDevice(&m_fuelMatchFile);
+        m_fuelMatchStream.setRealNumberNotation(QTextStream::FixedNotation);
+        m_fuelMatchStream << "plateNumber,dateTime,fuelType,amount,latitude,longitude,"
+                             "status,distanceMeters,nearestTime,atStop\n";
+    }
+
+    if (!m_regionIndex.isEmpty()) {
+        m_regionDayFile.setFileName(outputDir.filePath("region_days.csv"));
+        if (!m_regionDayFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            errorMessage = HANDLE_FILE_ERROR(m_regionDayFile.fileName(), "write");
+            return false;
+        }
+        m_regionDayStream.setDevice(&m_regionDayFile);
+        m_regionDayStream << "plateNumber,date,code,name,points,firstTime,lastTime\n";
+    }
+
+    if (!m_options.visitTargets.isEmpty()) {
+        m_visitFile.setFileName(outputDir.filePath("visit_days.csv"));
+        if (!m_visitFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            errorMessage = HANDLE_FILE_ERROR(m_visitFile.fileName(), "write");
+            return false;
+        }
+        m_visitStream.setDevice(&m_visitFile);
+        m_visitStream << "plateNumber";
+        for (const auto& target : m_options.visitTargets) {
+            m_visitStream << QString(",%1:%2:%3")
+                             .arg(target.center.latitude(), 0, 'f', 6)
+                             .arg(target.center.longitude(), 0, 'f', 6)
+                             .arg(target.radiusMeters, 0, 'f', 0);
+        }
+        m_visitStream << '\n';
+    }
+
+    return true;
+}
+
+void BatchProcessor::appendStats(const VehicleStats& stats)
+{
+    QMutexLocker locker(&m_summaryMutex);
+    m_statsStream << stats.plateNumber << ','
+                  << stats.fileCount << ','
+                  << stats.rawRecordCount << ','
+                  << stats.recordCount << ','
+                  << stats.firstTimestamp.toString("yyyy-MM-dd hh:mm:ss") << ','
+                  << stats.lastTimestamp.toString("yyyy-MM-dd hh:mm:ss") << ','
+                  << stats.distanceKm << ','
+                  << stats.maxSpeed << ','
+                  << stats.avgMovingSpeed << ','
+                  << stats.tripCount << '\n';
+    m_statsStream.flush();
+}
+
+void BatchProcessor::appendVisitDays(const QString& plateNumber, const QList<int>& days)
+{
+    QMutexLocker locker(&m_summaryMutex);
+    m_visitStream << plateNumber;
+    for (int count : days) {
+        m_visitStream << ',' << count;
+    }
+    m_visitStream << '\n';
+    m_visitStream.flush();
+}
+
+void BatchProcessor::appendTrips(const QString& plateNumber, const QList<TripSegmenter::TripSummary>& trips)
+{
+    QMutexLocker locker(&m_summaryMutex);
+    for (int i = 0; i < trips.size(); ++i) {
+        const auto& trip = trips[i];
+        m_tripStream << qSetRealNumberPrecision(3)
+                     << plateNumber << ','
+                     << i + 1 << ','
+                     << trip.startTime.toString("yyyy-MM-dd hh:mm:ss") << ','
+                     << trip.endTime.toString("yyyy-MM-dd hh:mm:ss") << ','
+                     << trip.durationSecs << ','
+                     << trip.distanceKm << ','
+                     << trip.maxSpeed << ','
+                     << trip.avgSpeed << ','
+                     << qSetRealNumberPrecision(6) << trip.minLatitude << ','
+                     << trip.maxLatitude << ','
+                     << trip.minLongitude << ','
+                     << trip.maxLongitude << ','
+                     << trip.pointCount() << '\n';
+    }
+    m_tripStream.flush();
+}
+
+void BatchProcessor::appendRegionDays(const QString& plateNumber,
+                                      const QList<AdminBoundaryIndex::DayRegion>& days)
+{
+    QMutexLocker locker(&m_summaryMutex);
+    for (const auto& day : days) {
+        const auto& region = m_regionIndex.region(day.region);
+        m_regionDayStream << plateNumber << ','
+                          << day.date.toString("yyyy-MM-dd") << ','
+                          << region.code << ','
+                          << region.name << ','
+                          << day.pointCount << ','
+                          << day.firstTime.toString("hh:mm:ss") << ','
+                          << day.lastTime.toString("hh:mm:ss") << '\n';
+    }
+    m_regionDayStream.flush();
+}
+
+bool BatchProcessor::loadFuelRecords(QString& errorMessage)
+{
+    m_fuelRecordsByPlate.clear();
+    m_fuelMatchedPlates.clear();
+
+    if (m_options.fuelRecordsFile.isEmpty()) {
+        return true;
+    }
+
+    QList<FuelUnloadingDataLoader::FuelRecord> records;
+    if (!FuelUnloadingDataLoader::readRecords(m_options.fuelRecordsFile, records, errorMessage)) {
+        return false;
+    }
+
+    for (const auto& record : records) {
+        m_fuelRecordsByPlate[record.plateNumber].append(record);
+    }
+    return true;
+}
+
+void BatchProcessor::appendFuelMatches(const QString& plateNumber,
+                                       const QList<FuelTrajectoryMatcher::MatchResult>& matches)
+{
+    QMutexLocker locker(&m_summaryMutex);
+    m_fuelMatchedPlates.insert(plateNumber);
+
+    for (const auto& match : matches) {
+        const auto& record = match.record;
+        m_fuelMatchStream << plateNumber << ','
+                          << record.dateTime.toString(record.hasTime ? "yyyy-MM-dd hh:mm:ss" : "yyyy-MM-dd") << ','
+                          << record.fuelType << ','
+                          << qSetRealNumberPrecision(3) << record.amount << ','
+                          << qSetRealNumberPrecision(6) << record.latitude << ','
+                          << record.longitude << ','
+                          << FuelTrajectoryMatcher::statusToString(match.status) << ','
+                          << qSetRealNumberPrecision(1) << match.distanceMeters << ','
+                          << match.nearestTime.toString("yyyy-MM-dd hh:mm:ss") << ','
+                          << (match.atStop ? 1 : 0) << '\n';
+    }
+    m_fuelMatchStream.flush();
+}
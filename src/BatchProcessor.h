@@ -0,0 +1,152 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QGeoCoordinate>
+#include <QMutex>
+#include <QFile>
+#include <QTextStream>
+#include <QHash>
+#include <QSet>
+#include <atomic>
+#include "FolderScanner.h"
+#include "ExcelDataReader.h"
+#include "TripSegmenter.h"
+#include "FuelTrajectoryMatcher.h"
+#include "AdminBoundaryIndex.h"
+#include "ErrorHandler.h"
+
+/**
+ * @class BatchProcessor
+ * @brief 无界面批处理：扫描文件夹并行解析所有车辆，结果按车辆流式写盘
+ *
+ * 每个车辆作为一个任务提交到线程池，任务内只持有该车辆的记录，
+ * 写完即释放，因此内存占用只与并发任务数有关，与车队规模无关。
+ * 工作线程的错误写入 ErrorHandler 队列，run() 等待任务时定期取出写日志。
+ *
+ * 输出目录结构：
+ * - trajectories/<车牌号>.csv  转换后的轨迹点
+ * - vehicle_stats.csv          每车统计（记录数、时间跨度、里程、速度、行程数）
+ * - trips.csv                  每个行程一行的汇总（见 TripSegmenter）
+ * - visit_days.csv             目标区域到访天数（仅当指定了目标点时）
+ * - fuel_matches.csv           卸油记录与轨迹的逐条核对结果（仅当指定了卸油记录文件时）
+ * - region_days.csv            每车每天所在的行政区（仅当指定了行政区边界文件时）
+ *
+ * @see FolderScanner
+ * @see VehicleManager::countVisitDays
+ * @see FuelTrajectoryMatcher
+ * @see AdminBoundaryIndex
+ */
+class BatchProcessor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct VisitTarget
+     * @brief 到访天数统计的目标区域
+     */
+    struct VisitTarget {
+        QGeoCoordinate center;
+        double radiusMeters = 0.0;
+    };
+
+    /**
+     * @struct Options
+     * @brief 批处理参数
+     */
+    struct Options {
+        QString inputFolder;
+        QString outputFolder;
+        int threadCount = 0;                  // 0 = 使用全部核心
+        bool convertToGcj02 = false;          // 输出轨迹是否转换为火星坐标
+        bool writeTrajectories = true;
+        QList<VisitTarget> visitTargets;
+        QString fuelRecordsFile;              // 卸油记录 JSON，为空则不做核对
+        qint64 fuelTimeWindowSecs = FuelTrajectoryMatcher::DEFAULT_TIME_WINDOW_SECS;
+        double fuelToleranceMeters = FuelTrajectoryMatcher::DEFAULT_TOLERANCE_METERS;
+        QString regionBoundariesFile;         // 行政区边界 GeoJSON，为空则不做逆地理编码
+    };
+
+    /**
+     * @struct VehicleStats
+     * @brief 单车统计结果
+     */
+    struct VehicleStats {
+        QString plateNumber;
+        int fileCount = 0;
+        int rawRecordCount = 0;       // 合并后的原始记录数
+        int recordCount = 0;          // 过滤静止点后的记录数
+        QDateTime firstTimestamp;
+        QDateTime lastTimestamp;
+        double distanceKm = 0.0;      // 轨迹点间球面距离累加
+        double maxSpeed = 0.0;
+        double avgMovingSpeed = 0.0;  // 速度>0 的记录的平均速度
+        int tripCount = 0;
+    };
+
+    explicit BatchProcessor(const Options& options, QObject *parent = nullptr);
+    ~BatchProcessor();
+
+    /**
+     * @brief 执行批处理，阻塞直到所有车辆处理完成
+     * @return 0 全部成功，1 扫描或输出目录失败，2 部分车辆处理失败
+     */
+    int run();
+
+    static VehicleStats computeStats(const QString& plateNumber, int fileCount, int rawRecordCount,
+                                     const QList<ExcelDataReader::VehicleRecord>& trajectory);
+
+signals:
+    void vehicleProcessed(const QString& plateNumber, int processed, int total);
+    void vehicleFailed(const QString& plateNumber, const QString& error);
+
+private:
+    void processVehicle(const FolderScanner::VehicleInfo& info);
+    bool writeTrajectory(const QString& plateNumber,
+                         const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                         QString& errorMessage) const;
+    void appendStats(const VehicleStats& stats);
+    void appendVisitDays(const QString& plateNumber, const QList<int>& days);
+    void appendTrips(const QString& plateNumber, const QList<TripSegmenter::TripSummary>& trips);
+    void appendFuelMatches(const QString& plateNumber, const QList<FuelTrajectoryMatcher::MatchResult>& matches);
+    void appendRegionDays(const QString& plateNumber, const QList<AdminBoundaryIndex::DayRegion>& days);
+    bool loadFuelRecords(QString& errorMessage);
+    bool openSummaryFiles(QString& errorMessage);
+    int fail(ErrorHandler::ErrorType type, const QString& message);
+
+    Options m_options;
+    ConfigManager::SnapshotPtr m_config;    // 列映射快照，任务开始前获取，之后只读
+    ErrorHandler m_errorHandler;            // 命令行没有事件循环，由 run() 取出队列
+
+    // 汇总文件由所有工作线程共享，逐行追加
+    QMutex m_summaryMutex;
+    QFile m_statsFile;
+    QFile m_visitFile;
+    QFile m_tripFile;
+    QFile m_fuelMatchFile;
+    QFile m_regionDayFile;
+    QTextStream m_statsStream;
+    QTextStream m_visitStream;
+    QTextStream m_tripStream;
+    QTextStream m_fuelMatchStream;
+    QTextStream m_regionDayStream;
+
+    // 卸油记录按车牌分组，任务开始前加载，之后只读
+    QHash<QString, QList<FuelUnloadingDataLoader::FuelRecord>> m_fuelRecordsByPlate;
+    QSet<QString> m_fuelMatchedPlates;    // 已写出核对结果的车牌（受 m_summaryMutex 保护）
+    ValidationReport m_validationReport;  // 各任务的校验汇总合并于此（受 m_summaryMutex 保护）
+
+    // 行政区边界，任务开始前加载，之后只读
+    AdminBoundaryIndex m_regionIndex;
+
+    std::atomic<int> m_processedCount{0};
+    std::atomic<int> m_failedCount{0};
+    int m_totalCount = 0;
+
+    static constexpr int ERROR_DRAIN_INTERVAL_MS = 100;
+};
+
+#endif // BATCHPROCESSOR_H
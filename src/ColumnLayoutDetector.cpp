@@ -0,0 +1,281 @@
+#include "ColumnLayoutDetector.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <cmath>
+
+// QXlsx includes
+#include "xlsxdocument.h"
+
+namespace {
+
+QMutex s_cacheMutex;
+QHash<QString, ColumnLayoutDetector::Layout> s_cache;
+
+} // namespace
+
+ColumnLayoutDetector::Layout ColumnLayoutDetector::resolve(QXlsx::Document& xlsx, int lastRow, int lastColumn,
+                                                           const ConfigManager::Snapshot& config,
+                                                           const QString& fileName)
+{
+    return resolve([&xlsx](int row, int column) { return xlsx.read(row, column); },
+                   lastRow, lastColumn, config, fileName);
+}
+
+ColumnLayoutDetector::Layout ColumnLayoutDetector::resolve(const CellReader& readCell, int lastRow, int lastColumn,
+                                                           const ConfigManager::Snapshot& config,
+                                                           const QString& fileName)
+{
+    Layout configLayout;
+    configLayout.dataStartRow = config.dataStartRow;
+    configLayout.fieldMappings = config.fieldMappings;
+
+    // 在前几行中找识别字段名最多的一行作为表头
+    int headerRow = 0;
+    int bestRecognized = 0;
+    QStringList headerCells;
+    const int scanRows = qMin(lastRow, MAX_HEADER_SCAN_ROWS);
+    for (int row = 1; row <= scanRows; ++row) {
+        QStringList cells;
+        int recognized = 0;
+        for (int column = 1; column <= lastColumn; ++column) {
+            const QString text = readCell(row, column).toString();
+            cells.append(text);
+            if (matchField(text) >= 0) {
+                recognized++;
+            }
+        }
+        if (recognized > bestRecognized) {
+            bestRecognized = recognized;
+            headerRow = row;
+            headerCells = cells;
+        }
+    }
+
+    // 没有表头的导出文件只能使用配置
+    if (bestRecognized < MIN_RECOGNIZED_HEADERS) {
+        return configLayout;
+    }
+
+    const QString cacheKey = fingerprint(headerRow, headerCells) + ":" + QString::number(config.version);
+    {
+        QMutexLocker locker(&s_cacheMutex);
+        auto it = s_cache.constFind(cacheKey);
+        if (it != s_cache.cend()) {
+            return it.value();
+        }
+    }
+
+    Layout layout = configLayout;
+    if (!configMatchesHeader(config, headerRow, headerCells)) {
+        Layout detectedLayout;
+        if (detectColumns(readCell, headerRow, lastRow, headerCells, detectedLayout)) {
+            layout = detectedLayout;
+            QStringList columns;
+            for (const auto& mapping : layout.fieldMappings) {
+                columns.append(QString("%1=%2").arg(mapping.fieldName).arg(mapping.columnIndex));
+            }
+            qInfo().noquote() << QString("识别到新的列布局（%1）：数据起始行 %2，%3")
+                                 .arg(fileName).arg(layout.dataStartRow).arg(columns.join(", "));
+        } else {
+            qWarning().noquote() << QString("无法识别列布局（%1），使用配置中的列映射").arg(fileName);
+        }
+    }
+
+    QMutexLocker locker(&s_cacheMutex);
+    s_cache.insert(cacheKey, layout);
+    return layout;
+}
+
+QString ColumnLayoutDetector::fingerprint(int headerRow, const QStringList& headerCells)
+{
+    QStringList normalized;
+    normalized.reserve(headerCells.size());
+    for (const QString& cell : headerCells) {
+        normalized.append(normalize(cell));
+    }
+    const QByteArray signature = QByteArray::number(headerRow) + '\n' + normalized.join('|').toUtf8();
+    return QString::fromLatin1(QCryptographicHash::hash(signature, QCryptographicHash::Sha1).toHex().left(16));
+}
+
+void ColumnLayoutDetector::clearCache()
+{
+    QMutexLocker locker(&s_cacheMutex);
+    s_cache.clear();
+}
+
+const QList<ColumnLayoutDetector::FieldSpec>& ColumnLayoutDetector::fieldSpecs()
+{
+    // 同义词已规范化（小写、去空白和括号内单位）
+    static const QList<FieldSpec> specs = {
+        {"车牌号", "text", {"车牌号", "车牌", "车牌号码", "车号", "plate", "plateno", "platenumber", "vehicleno"}},
+        {"车牌颜色", "text", {"车牌颜色", "颜色", "platecolor", "color"}},
+        {"速度", "number", {"速度", "车速", "gps速度", "speed"}},
+        {"经度", "number", {"经度", "lng", "lon", "longitude"}},
+        {"纬度", "number", {"纬度", "lat", "latitude"}},
+        {"方向", "number", {"方向", "方向角", "航向", "direction", "heading", "course"}},
+        {"上报时间", "datetime", {"上报时间", "定位时间", "gps时间", "时间", "time", "gpstime", "timestamp"}},
+        {"总里程", "text", {"总里程", "里程", "mileage", "odometer"}},
+        {"距离", "number", {"距离", "distance"}},
+        {"海拔", "number", {"海拔", "高程", "altitude", "elevation"}},
+    };
+    return specs;
+}
+
+QString ColumnLayoutDetector::normalize(const QString& text)
+{
+    static const QRegularExpression unitPattern("[\\(（\\[].*[\\)）\\]]");
+    static const QRegularExpression spacePattern("[\\s_\\-:：]");
+    QString normalized = text.toLower();
+    normalized.remove(unitPattern);
+    normalized.remove(spacePattern);
+    return normalized;
+}
+
+int ColumnLayoutDetector::matchField(const QString& headerText)
+{
+    const QString normalized = normalize(headerText);
+    if (normalized.isEmpty()) {
+        return -1;
+    }
+
+    const QList<FieldSpec>& specs = fieldSpecs();
+    for (int i = 0; i < specs.size(); ++i) {
+        if (specs[i].synonyms.contains(normalized)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ColumnLayoutDetector::configMatchesHeader(const ConfigManager::Snapshot& config, int headerRow,
+                                               const QStringList& headerCells)
+{
+    if (config.dataStartRow != headerRow + 1) {
+        return false;
+    }
+
+    const QStringList requiredFields = ConfigManager::getRequiredFieldNames();
+    const QList<FieldSpec>& specs = fieldSpecs();
+    for (const auto& mapping : config.fieldMappings) {
+        if (!mapping.isMapped()) {
+            if (requiredFields.contains(mapping.fieldName)) {
+                return false;
+            }
+            continue;
+        }
+        if (mapping.columnIndex > headerCells.size()) {
+            return false;
+        }
+
+        // 表头名无法识别时信任用户配置；识别为其他字段说明列顺序不同
+        const int fieldIndex = matchField(headerCells[mapping.columnIndex - 1]);
+        if (fieldIndex >= 0 && specs[fieldIndex].fieldName != mapping.fieldName) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ColumnLayoutDetector::detectColumns(const CellReader& readCell, int headerRow, int lastRow,
+                                         const QStringList& headerCells, Layout& layout)
+{
+    const QList<FieldSpec>& specs = fieldSpecs();
+    QList<int> columnForSpec(specs.size(), 0);
+    QList<bool> columnUsed(headerCells.size() + 1, false);
+
+    // 1. 按表头名
+    for (int column = 1; column <= headerCells.size(); ++column) {
+        const int fieldIndex = matchField(headerCells[column - 1]);
+        if (fieldIndex >= 0 && columnForSpec[fieldIndex] == 0) {
+            columnForSpec[fieldIndex] = column;
+            columnUsed[column] = true;
+        }
+    }
+
+    // 2. 关键字段仍缺失时按取值判断，只读取表头下方 SNIFF_ROWS 行
+    const QStringList keyFields = {"经度", "纬度", "上报时间", "车牌号"};
+    QHash<int, QList<QVariant>> sampledValues;
+    for (int i = 0; i < specs.size(); ++i) {
+        if (columnForSpec[i] > 0 || !keyFields.contains(specs[i].fieldName)) {
+            continue;
+        }
+        for (int column = 1; column <= headerCells.size(); ++column) {
+            if (columnUsed[column]) {
+                continue;
+            }
+            auto it = sampledValues.find(column);
+            if (it == sampledValues.end()) {
+                QList<QVariant> values;
+                const int lastSampleRow = qMin(lastRow, headerRow + SNIFF_ROWS);
+                for (int row = headerRow + 1; row <= lastSampleRow; ++row) {
+                    values.append(readCell(row, column));
+                }
+                it = sampledValues.insert(column, values);
+            }
+            if (valuesLookLike(specs[i].fieldName, it.value())) {
+                columnForSpec[i] = column;
+                columnUsed[column] = true;
+                break;
+            }
+        }
+    }
+
+    const QStringList requiredFields = ConfigManager::getRequiredFieldNames();
+    layout.dataStartRow = headerRow + 1;
+    layout.fieldMappings.clear();
+    layout.detected = true;
+    for (int i = 0; i < specs.size(); ++i) {
+        const bool required = requiredFields.contains(specs[i].fieldName);
+        if (columnForSpec[i] == 0) {
+            // 车牌号不是配置中的必需字段，但没有车牌号的记录都无效
+            if (required || specs[i].fieldName == "车牌号") {
+                return false;
+            }
+            continue;
+        }
+        layout.fieldMappings.append(ConfigManager::FieldMapping(
+            specs[i].fieldName, columnForSpec[i], required, specs[i].fieldName, specs[i].dataType));
+    }
+    return true;
+}
+
+bool ColumnLayoutDetector::valuesLookLike(const QString& fieldName, const QList<QVariant>& values)
+{
+    static const QRegularExpression platePattern("^[\\x{4e00}-\\x{9fa5}][A-Z][A-Z0-9]{4,6}$");
+    static const QRegularExpression dateTimePattern("^\\d{4}[-/年]\\d{1,2}[-/月]\\d{1,2}日?\\s+\\d{1,2}:\\d{2}");
+
+    int checked = 0;
+    bool hasFraction = false;   // 经纬度总带小数，避免把整数的速度、方向列误判为坐标
+    for (const QVariant& value : values) {
+        const QString text = value.toString().trimmed();
+        if (text.isEmpty()) {
+            continue;
+        }
+        checked++;
+
+        bool matches = false;
+        if (fieldName == "经度" || fieldName == "纬度") {
+            bool ok = false;
+            const double number = value.toDouble(&ok);
+            matches = ok && (fieldName == "经度" ? (number >= 73.0 && number <= 135.0)
+                                                 : (number >= 18.0 && number <= 54.0));
+            hasFraction = hasFraction || (ok && number != std::floor(number));
+        } else if (fieldName == "上报时间") {
+            matches = value.typeId() == QMetaType::QDateTime || dateTimePattern.match(text).hasMatch();
+        } else if (fieldName == "车牌号") {
+            matches = platePattern.match(text).hasMatch();
+        }
+
+        if (!matches) {
+            return false;
+        }
+    }
+    if (fieldName == "经度" || fieldName == "纬度") {
+        return checked > 0 && hasFraction;
+    }
+    return checked > 0;
+}
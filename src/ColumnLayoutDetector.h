@@ -0,0 +1,85 @@
+#ifndef COLUMNLAYOUTDETECTOR_H
+#define COLUMNLAYOUTDETECTOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVariant>
+#include <functional>
+#include "ConfigManager.h"
+
+// Forward declarations
+namespace QXlsx {
+    class Document;
+}
+
+/**
+ * @class ColumnLayoutDetector
+ * @brief 按表头签名识别 Excel 列布局，同一布局的文件复用识别结果
+ *
+ * 同一文件夹中常混有不同厂商导出的文件，列顺序和数据起始行各不相同。
+ * 每个文件先读取前 MAX_HEADER_SCAN_ROWS 行，选出识别字段名最多的一行作为表头：
+ * - 配置中的映射与表头一致（配置列上的表头名未被识别为其他字段、起始行相同）时沿用配置
+ * - 否则按表头名匹配字段，仍缺少的车牌号、经纬度、时间列再按表头下方若干行的取值判断
+ * - 识别不全时退回配置映射，由逐行校验报告问题
+ *
+ * 结果按“表头签名 + 配置版本”缓存在进程内（线程安全），同一布局的后续文件
+ * 只需读取表头行；修改列映射后配置版本变化，旧结果自然失效。
+ *
+ * @see ExcelDataReader
+ * @see ConfigManager::Snapshot
+ */
+class ColumnLayoutDetector
+{
+public:
+    struct Layout {
+        int dataStartRow = 0;
+        QList<ConfigManager::FieldMapping> fieldMappings;
+        bool detected = false;      // false 表示沿用配置中的映射
+    };
+
+    // 按行号、列号（从 1 开始）读取单元格，供不经过 QXlsx 的读取路径使用
+    using CellReader = std::function<QVariant(int row, int column)>;
+
+    /**
+     * @brief 确定一个工作表的数据起始行和列映射
+     * @param xlsx 已加载的文档（读取当前工作表）
+     * @param lastRow 工作表最后一行
+     * @param lastColumn 工作表最后一列
+     * @param config 配置快照，无法识别时使用其中的映射
+     * @param fileName 仅用于日志
+     */
+    static Layout resolve(QXlsx::Document& xlsx, int lastRow, int lastColumn,
+                          const ConfigManager::Snapshot& config, const QString& fileName);
+    static Layout resolve(const CellReader& readCell, int lastRow, int lastColumn,
+                          const ConfigManager::Snapshot& config, const QString& fileName);
+
+    // 表头签名：表头行号和规范化后的表头文本
+    static QString fingerprint(int headerRow, const QStringList& headerCells);
+
+    static void clearCache();
+
+    static constexpr int MAX_HEADER_SCAN_ROWS = 5;
+    static constexpr int SNIFF_ROWS = 20;
+    static constexpr int MIN_RECOGNIZED_HEADERS = 2;
+
+private:
+    struct FieldSpec {
+        QString fieldName;
+        QString dataType;
+        QStringList synonyms;       // 已规范化
+    };
+
+    static const QList<FieldSpec>& fieldSpecs();
+    static QString normalize(const QString& text);
+    static int matchField(const QString& headerText);       // fieldSpecs() 下标，未识别为 -1
+
+    static bool configMatchesHeader(const ConfigManager::Snapshot& config, int headerRow,
+                                    const QStringList& headerCells);
+    static bool detectColumns(const CellReader& readCell, int headerRow, int lastRow,
+                              const QStringList& headerCells, Layout& layout);
+    // 表头下方的取值是否符合该字段（经纬度在中国范围内、时间、车牌号格式）
+    static bool valuesLookLike(const QString& fieldName, const QList<QVariant>& values);
+};
+
+#endif // COLUMNLAYOUTDETECTOR_H
@@ -19,18 +19,34 @@ ConfigManager::ConfigManager(QObject *parent)
     QString configPath = QCoreApplication::applicationDirPath();
     
     // 初始化QSettings
-    QString configFile = configPath + "/CarMoveTracker.ini";
-    m_settings = new QSettings(configFile, QSettings::IniFormat, this);
+    m_settingsFile = configPath + "/CarMoveTracker.ini";
+    m_settings = new QSettings(m_settingsFile, QSettings::IniFormat, this);
     
     // 加载保存的设置
     loadSettings();
     loadExcelSettings();
+    publishSnapshot();
+    
+    // 延迟写入：连续修改合并为一次后台写入，写入按提交顺序执行
+    m_persistPool.setMaxThreadCount(1);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_DEBOUNCE_MS);
+    connect(&m_saveTimer, &QTimer::timeout, this, [this]() {
+        flushSettings();
+    });
+    
+    // 单例不会被析构，退出时在这里写完待保存的设置
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            flushSettings(true);
+        });
+    }
 }
 
 ConfigManager::~ConfigManager()
 {
     // 保存当前设置
-    saveSettings();
+    flushSettings(true);
 }
 
 ConfigManager *ConfigManager::GetInstance()
@@ -46,6 +62,7 @@ void ConfigManager::setMapTypeIndex(int index)
 {
     if (m_mapTypeIndex != index) {
         m_mapTypeIndex = index;
+        scheduleSave();
         emit mapTypeIndexChanged();
     }
 }
@@ -54,6 +71,7 @@ void ConfigManager::setZoomLevel(double level)
 {
     if (qAbs(m_zoomLevel - level) > 0.01) { // 避免浮点数精度问题
         m_zoomLevel = level;
+        scheduleSave();
         emit zoomLevelChanged();
     }
 }
@@ -62,6 +80,7 @@ void ConfigManager::setMapCenter(const QGeoCoordinate& center)
 {
     if (m_mapCenter != center) {
         m_mapCenter = center;
+        scheduleSave();
         emit mapCenterChanged();
     }
 }
@@ -70,35 +89,67 @@ void ConfigManager::setCoordinateConversionEnabled(bool enabled)
 {
     if (m_coordinateConversionEnabled != enabled) {
         m_coordinateConversionEnabled = enabled;
+        publishSnapshot();
+        scheduleSave();
         emit coordinateConversionEnabledChanged();
     }
 }
 
+void ConfigManager::setOfflineTilesFile(const QString& filePath)
+{
+    if (m_offlineTilesFile != filePath) {
+        m_offlineTilesFile = filePath;
+        scheduleSave();
+        emit offlineTilesFileChanged();
+    }
+}
+
+void ConfigManager::setExcelDataStartRow(int row)
+{
+    m_excelDataStartRow = row;
+    publishSnapshot();
+    scheduleSave();
+}
+
+void ConfigManager::setExcelFieldMappings(const QList<FieldMapping>& mappings)
+{
+    m_excelFieldMappings = mappings;
+    publishSnapshot();
+    scheduleSave();
+}
+
 void ConfigManager::addFieldMapping(const QString& fieldName, int columnIndex, bool isRequired,
                                    const QString& displayName, const QString& dataType)
 {
-    FieldMapping mapping(fieldName, columnIndex, isRequired, displayName, dataType);
-    
-    // 移除已存在的同名字段映射
-    removeFieldMapping(fieldName);
-    
-    // 添加新的映射
-    m_excelFieldMappings.append(mapping);
+    // 先替换同名字段映射，再发布一次快照，读取方不会看到删除了一半的映射
+    eraseFieldMapping(fieldName);
+    m_excelFieldMappings.append(FieldMapping(fieldName, columnIndex, isRequired, displayName, dataType));
+    publishSnapshot();
+    scheduleSave();
     
     emit excelColumnMappingChanged();
 }
 
 void ConfigManager::removeFieldMapping(const QString& fieldName)
+{
+    if (eraseFieldMapping(fieldName)) {
+        publishSnapshot();
+        scheduleSave();
+        emit excelColumnMappingChanged();
+    }
+}
+
+bool ConfigManager::eraseFieldMapping(const QString& fieldName)
 {
     auto it = std::remove_if(m_excelFieldMappings.begin(), m_excelFieldMappings.end(),
                             [&fieldName](const FieldMapping& mapping) {
                                 return mapping.fieldName == fieldName;
                             });
-    
-    if (it != m_excelFieldMappings.end()) {
-        m_excelFieldMappings.erase(it, m_excelFieldMappings.end());
-        emit excelColumnMappingChanged();
+    if (it == m_excelFieldMappings.end()) {
+        return false;
     }
+    m_excelFieldMappings.erase(it, m_excelFieldMappings.end());
+    return true;
 }
 
 ConfigManager::FieldMapping ConfigManager::getFieldMapping(const QString& fieldName) const
@@ -203,12 +254,17 @@ QStringList ConfigManager::getRequiredFields() const
 
 void ConfigManager::saveMapState()
 {
-    saveSettings();
+    m_savePending = true;
+    flushSettings();
 }
 
 void ConfigManager::loadMapState()
 {
+    // 等待未完成的后台写入，再从磁盘重新读取
+    flushSettings(true);
+    m_settings->sync();
     loadSettings();
+    publishSnapshot();
     emit mapStateLoaded();
 }
 
@@ -218,8 +274,10 @@ void ConfigManager::resetToDefaults()
     m_zoomLevel = DEFAULT_ZOOM_LEVEL;
     m_mapCenter = QGeoCoordinate(DEFAULT_LATITUDE, DEFAULT_LONGITUDE);
     m_coordinateConversionEnabled = DEFAULT_COORDINATE_CONVERSION;
+    publishSnapshot();
     
-    saveSettings();
+    m_savePending = true;
+    flushSettings();
     
     emit mapTypeIndexChanged();
     emit zoomLevelChanged();
@@ -230,20 +288,22 @@ void ConfigManager::resetToDefaults()
 void ConfigManager::createDefaultExcelMapping()
 {
     m_excelDataStartRow = DEFAULT_EXCEL_DATA_START_ROW;
-    m_excelFieldMappings.clear();
     
-    // 添加标准字段映射（未指定列，需要用户配置）
-    addFieldMapping("车牌号", 0, false, "车牌号", "text");
-    addFieldMapping("车牌颜色", 0, false, "车牌颜色", "text");
-    addFieldMapping("速度", 0, false, "速度", "number");
-    addFieldMapping("经度", 0, true, "经度", "number");
-    addFieldMapping("纬度", 0, true, "纬度", "number");
-    addFieldMapping("方向", 0, false, "方向", "number");
-    addFieldMapping("上报时间", 0, true, "上报时间", "datetime");
-    addFieldMapping("总里程", 0, false, "总里程", "text");
-    
-    saveExcelSettings();
-    m_settings->sync();
+    // 标准字段映射（未指定列，需要用户配置）；全部替换后只发布一次快照
+    m_excelFieldMappings = {
+        FieldMapping("车牌号", 0, false, "车牌号", "text"),
+        FieldMapping("车牌颜色", 0, false, "车牌颜色", "text"),
+        FieldMapping("速度", 0, false, "速度", "number"),
+        FieldMapping("经度", 0, true, "经度", "number"),
+        FieldMapping("纬度", 0, true, "纬度", "number"),
+        FieldMapping("方向", 0, false, "方向", "number"),
+        FieldMapping("上报时间", 0, true, "上报时间", "datetime"),
+        FieldMapping("总里程", 0, false, "总里程", "text"),
+    };
+    publishSnapshot();
+    
+    m_savePending = true;
+    flushSettings();
     
     emit excelColumnMappingChanged();
 }
@@ -274,49 +334,86 @@ void ConfigManager::loadSettings()
     m_mapCenter = QGeoCoordinate(latitude, longitude);
     
     m_coordinateConversionEnabled = m_settings->value("coordinateConversionEnabled", DEFAULT_COORDINATE_CONVERSION).toBool();
+    m_offlineTilesFile = m_settings->value("offlineTilesFile").toString();
     
     m_settings->endGroup();
 }
 
-void ConfigManager::saveSettings()
+void ConfigManager::scheduleSave()
 {
-    m_settings->beginGroup("MapSettings");
-    
-    m_settings->setValue("mapTypeIndex", m_mapTypeIndex);
-    m_settings->setValue("zoomLevel", m_zoomLevel);
-    m_settings->setValue("centerLatitude", m_mapCenter.latitude());
-    m_settings->setValue("centerLongitude", m_mapCenter.longitude());
-    m_settings->setValue("coordinateConversionEnabled", m_coordinateConversionEnabled);
-    
-    m_settings->endGroup();
-    
-    // 同时保存 Excel 设置
-    saveExcelSettings();
-    
-    m_settings->sync(); // 立即写入文件
+    m_savePending = true;
+    m_saveTimer.start();
 }
 
-void ConfigManager::saveExcelSettings()
+void ConfigManager::flushSettings(bool wait)
 {
-    m_settings->beginGroup("ExcelSettings");
-    
-    m_settings->setValue("dataStartRow", m_excelDataStartRow);
+    m_saveTimer.stop();
+    if (m_savePending) {
+        m_savePending = false;
+        // 在主线程复制状态，后台线程只接触副本
+        const PersistedState state = currentState();
+        const QString filePath = m_settingsFile;
+        m_persistPool.start([filePath, state]() {
+            writeSettings(filePath, state);
+        });
+    }
     
-    // 保存字段映射
-    m_settings->beginWriteArray("fieldMappings");
+    if (wait) {
+        m_persistPool.waitForDone();
+    }
+}
+
+ConfigManager::PersistedState ConfigManager::currentState() const
+{
+    PersistedState state;
+    state.mapTypeIndex = m_mapTypeIndex;
+    state.zoomLevel = m_zoomLevel;
+    state.mapCenter = m_mapCenter;
+    state.coordinateConversionEnabled = m_coordinateConversionEnabled;
+    state.offlineTilesFile = m_offlineTilesFile;
+    state.excelDataStartRow = m_excelDataStartRow;
+    state.excelFieldMappings = m_excelFieldMappings;
+    return state;
+}
+
+void ConfigManager::writeSettings(const QString& filePath, const PersistedState& state)
+{
+    // 每次写入使用独立实例；原子同步：先写临时文件再替换，写到一半不会损坏原配置
+    QSettings settings(filePath, QSettings::IniFormat);
+    settings.setAtomicSyncRequired(true);
+    
+    settings.beginGroup("MapSettings");
+    settings.setValue("mapTypeIndex", state.mapTypeIndex);
+    settings.setValue("zoomLevel", state.zoomLevel);
+    settings.setValue("centerLatitude", state.mapCenter.latitude());
+    settings.setValue("centerLongitude", state.mapCenter.longitude());
+    settings.setValue("coordinateConversionEnabled", state.coordinateConversionEnabled);
+    settings.setValue("offlineTilesFile", state.offlineTilesFile);
+    settings.endGroup();
+    
+    settings.beginGroup("ExcelSettings");
+    settings.setValue("dataStartRow", state.excelDataStartRow);
+    
+    // 保存字段映射；先清除旧数组，映射变少时不残留多余条目
+    settings.remove("fieldMappings");
+    settings.beginWriteArray("fieldMappings");
     int index = 0;
-    for (const auto& mapping : m_excelFieldMappings) {
-        m_settings->setArrayIndex(index);
-        m_settings->setValue("fieldName", mapping.fieldName);
-        m_settings->setValue("columnIndex", mapping.columnIndex);
-        m_settings->setValue("isRequired", mapping.isRequired);
-        m_settings->setValue("displayName", mapping.displayName);
-        m_settings->setValue("dataType", mapping.dataType);
+    for (const auto& mapping : state.excelFieldMappings) {
+        settings.setArrayIndex(index);
+        settings.setValue("fieldName", mapping.fieldName);
+        settings.setValue("columnIndex", mapping.columnIndex);
+        settings.setValue("isRequired", mapping.isRequired);
+        settings.setValue("displayName", mapping.displayName);
+        settings.setValue("dataType", mapping.dataType);
         index++;
     }
-    m_settings->endArray();
+    settings.endArray();
+    settings.endGroup();
     
-    m_settings->endGroup();
+    settings.sync();
+    if (settings.status() != QSettings::NoError) {
+        qWarning() << "Failed to write settings:" << filePath << settings.status();
+    }
 }
 
 void ConfigManager::loadExcelSettings()
@@ -362,9 +459,10 @@ void ConfigManager::saveExcelColumnMapping(int dataStartRow, const QVariantMap&
         mapping.dataType = fieldMap.value("dataType").toString();
         m_excelFieldMappings.append(mapping);
     }
+    publishSnapshot();
     
-    saveExcelSettings();
-    m_settings->sync();
+    m_savePending = true;
+    flushSettings();
     
     emit excelColumnMappingChanged();
 }
@@ -401,3 +499,23 @@ QVariantMap ConfigManager::getExcelFieldMappingsVariant() const
     }
     return fieldMappings;
 }
+
+int ConfigManager::Snapshot::columnForField(const QString& fieldName) const
+{
+    for (const auto& mapping : fieldMappings) {
+        if (mapping.fieldName == fieldName) {
+            return mapping.columnIndex;
+        }
+    }
+    return 0; // 未映射
+}
+
+void ConfigManager::publishSnapshot()
+{
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->version = ++m_snapshotVersion;
+    snapshot->dataStartRow = m_excelDataStartRow;
+    snapshot->fieldMappings = m_excelFieldMappings;
+    snapshot->coordinateConversionEnabled = m_coordinateConversionEnabled;
+    std::atomic_store(&m_snapshot, SnapshotPtr(std::move(snapshot)));
+}
@@ -10,10 +10,24 @@
 #include <QVariantMap>
 #include <QList>
 #include <QDateTime>
+#include <QTimer>
+#include <QThreadPool>
+#include <memory>
 
 /**
  * @class ConfigManager
  * @brief 统一配置管理器，管理地图配置和Excel列映射配置
+ *
+ * 读取器所需的配置（数据起始行、列映射、坐标转换开关）另外以不可变快照发布：
+ * 每个修改操作完成后在主线程生成一次带递增版本号的新 Snapshot，通过原子 shared_ptr 替换，
+ * 读取方看不到操作进行到一半的配置。
+ * 加载任务开始时取一次快照并在整个任务中使用，界面修改列映射不影响进行中的加载，
+ * 工作线程读取也无需加锁。
+ *
+ * 设置持久化采用延迟写入：修改只标记待保存并重启 SAVE_DEBOUNCE_MS 防抖定时器，
+ * 定时器到期（或 saveMapState、程序退出）时在主线程复制一份当前状态，
+ * 由单线程后台池写入 ini（QSettings 原子写入：先写临时文件再替换），
+ * 平移、缩放地图时主线程不做磁盘 I/O。
  */
 class ConfigManager : public QObject
 {
@@ -24,6 +38,7 @@ class ConfigManager : public QObject
     Q_PROPERTY(double zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY zoomLevelChanged)
     Q_PROPERTY(QGeoCoordinate mapCenter READ mapCenter WRITE setMapCenter NOTIFY mapCenterChanged)
     Q_PROPERTY(bool coordinateConversionEnabled READ coordinateConversionEnabled WRITE setCoordinateConversionEnabled NOTIFY coordinateConversionEnabledChanged)
+    Q_PROPERTY(QString offlineTilesFile READ offlineTilesFile WRITE setOfflineTilesFile NOTIFY offlineTilesFileChanged)
     
 public:
     /**
@@ -69,25 +84,47 @@ public:
         }
     };
 
+    /**
+     * @struct Snapshot
+     * @brief 读取器配置的不可变快照，发布后不再修改，可在任意线程共享
+     */
+    struct Snapshot {
+        quint64 version = 0;
+        int dataStartRow = 0;
+        QList<FieldMapping> fieldMappings;
+        bool coordinateConversionEnabled = false;
+        
+        int columnForField(const QString& fieldName) const;
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
     static ConfigManager* GetInstance();
     
+    // 当前配置快照（任意线程，无锁）
+    SnapshotPtr snapshot() const { return std::atomic_load(&m_snapshot); }
+    
     // Map property getters
     int mapTypeIndex() const { return m_mapTypeIndex; }
     double zoomLevel() const { return m_zoomLevel; }
     QGeoCoordinate mapCenter() const { return m_mapCenter; }
     bool coordinateConversionEnabled() const { return m_coordinateConversionEnabled; }
+    QString offlineTilesFile() const { return m_offlineTilesFile; }
     
     // Map property setters
     void setMapTypeIndex(int index);
     void setZoomLevel(double level);
     void setMapCenter(const QGeoCoordinate& center);
     void setCoordinateConversionEnabled(bool enabled);
+    void setOfflineTilesFile(const QString& filePath);
+    
+    // 提交待保存的设置；wait 为 true 时等待写入完成（退出时使用）
+    void flushSettings(bool wait = false);
     
     // Excel column mapping methods
     int getExcelDataStartRow() const { return m_excelDataStartRow; }
-    void setExcelDataStartRow(int row) { m_excelDataStartRow = row; }
+    void setExcelDataStartRow(int row);
     QList<FieldMapping> getExcelFieldMappings() const { return m_excelFieldMappings; }
-    void setExcelFieldMappings(const QList<FieldMapping>& mappings) { m_excelFieldMappings = mappings; }
+    void setExcelFieldMappings(const QList<FieldMapping>& mappings);
     
     // Field mapping management
     void addFieldMapping(const QString& fieldName, int columnIndex, bool isRequired,
@@ -103,7 +140,7 @@ public:
     QStringList getRequiredFields() const;
     
     // Invokable methods for QML
-    Q_INVOKABLE void saveMapState();
+    Q_INVOKABLE void saveMapState();        // 立即提交后台写入，不等待完成
     Q_INVOKABLE void loadMapState();
     Q_INVOKABLE void resetToDefaults();
     Q_INVOKABLE void saveExcelColumnMapping(int dataStartRow, const QVariantMap& fieldMappings);
@@ -120,29 +157,56 @@ signals:
     void zoomLevelChanged();
     void mapCenterChanged();
     void coordinateConversionEnabledChanged();
+    void offlineTilesFileChanged();
     void mapStateLoaded();
     void excelColumnMappingChanged();
     
 private:
     explicit ConfigManager(QObject *parent = nullptr);
     ~ConfigManager();
+    /**
+     * @struct PersistedState
+     * @brief 一次写入的设置副本，在主线程生成后交给后台线程
+     */
+    struct PersistedState {
+        int mapTypeIndex = 0;
+        double zoomLevel = 0.0;
+        QGeoCoordinate mapCenter;
+        bool coordinateConversionEnabled = false;
+        QString offlineTilesFile;
+        int excelDataStartRow = 0;
+        QList<FieldMapping> excelFieldMappings;
+    };
+    
     void loadSettings();
-    void saveSettings();
     void loadExcelSettings();
-    void saveExcelSettings();
+    void scheduleSave();        // 标记待保存并重启防抖定时器
+    PersistedState currentState() const;
+    static void writeSettings(const QString& filePath, const PersistedState& state);
+    void publishSnapshot();     // 每个公开的修改操作完成后调用一次，只在主线程
+    bool eraseFieldMapping(const QString& fieldName);   // 只修改列表，不发布快照
     
     // Map configuration properties
     int m_mapTypeIndex;
     double m_zoomLevel;
     QGeoCoordinate m_mapCenter;
     bool m_coordinateConversionEnabled;
+    QString m_offlineTilesFile;         // 离线瓦片包（MBTiles），为空则使用默认位置
     
     // Excel configuration properties
     int m_excelDataStartRow;
     QList<FieldMapping> m_excelFieldMappings;
     
-    // Settings instance
+    // 供工作线程读取的配置快照
+    SnapshotPtr m_snapshot;
+    quint64 m_snapshotVersion = 0;
+    
+    // Settings instance（只用于读取，写入在后台线程另建实例）
     QSettings* m_settings;
+    QString m_settingsFile;
+    QTimer m_saveTimer;
+    QThreadPool m_persistPool;
+    bool m_savePending = false;
     
     // Default values
     static const int DEFAULT_MAP_TYPE_INDEX = 0;
@@ -151,6 +215,7 @@ private:
     static inline const double DEFAULT_LONGITUDE = 116.4;
     static const bool DEFAULT_COORDINATE_CONVERSION = false;
     static const int DEFAULT_EXCEL_DATA_START_ROW = 2;
+    static const int SAVE_DEBOUNCE_MS = 1500;
     static ConfigManager* m_pManager;
 };
 
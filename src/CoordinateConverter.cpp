@@ -1,4 +1,5 @@
 #include "CoordinateConverter.h"
+#include "Tracer.h"
 #include "ErrorHandler.h"
 #include <QtMath>
 
@@ -117,6 +118,7 @@ QList<QGeoCoordinate> CoordinateConverter::convertTrajectory(const QList<QGeoCoo
                                                            CoordinateSystem from, 
                                                            CoordinateSystem to)
 {
+    TRACE_SCOPE("CoordinateConverter::convertTrajectory");
     QList<QGeoCoordinate> result;
     
     // 如果源坐标系和目标坐标系相同，直接返回原坐标
@@ -1,10 +1,38 @@
 #include "ErrorHandler.h"
+#include "ValidationReport.h"
 #include <QFileInfo>
 #include <QDir>
 
+std::atomic<ErrorHandler*> ErrorHandler::s_instance{nullptr};
+
 ErrorHandler::ErrorHandler(QObject *parent)
     : QObject(parent)
+    , m_slots(new Slot[QUEUE_CAPACITY])
+    , m_history(HISTORY_CAPACITY)
+{
+    static_assert((QUEUE_CAPACITY & (QUEUE_CAPACITY - 1)) == 0, "QUEUE_CAPACITY must be a power of two");
+    for (int i = 0; i < QUEUE_CAPACITY; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    
+    m_drainTimer.setInterval(DRAIN_INTERVAL_MS);
+    connect(&m_drainTimer, &QTimer::timeout, this, &ErrorHandler::drain);
+    m_forwardWindow.start();
+    
+    ErrorHandler* expected = nullptr;
+    s_instance.compare_exchange_strong(expected, this);
+}
+
+ErrorHandler::~ErrorHandler()
 {
+    ErrorHandler* self = this;
+    s_instance.compare_exchange_strong(self, nullptr);
+    
+    // 退出前把队列中剩余的错误写入日志
+    ErrorInfo error;
+    while (tryDequeue(error)) {
+        logError(error);
+    }
 }
 
 QString ErrorHandler::handleFileAccessError(const QString& filePath, const QString& operation)
@@ -25,7 +53,7 @@ QString ErrorHandler::handleFileAccessError(const QString& filePath, const QStri
         userMessage = QString("文件访问错误：%1\n操作：%2\n请稍后重试或联系技术支持。").arg(fileName).arg(operation);
     }
     
-    qWarning() << "File access error:" << filePath << "Operation:" << operation;
+    report(FileAccessError, Warning, QString("%1 (%2)").arg(filePath, operation), userMessage);
     return userMessage;
 }
 
@@ -67,7 +95,7 @@ QString ErrorHandler::handleDataFormatError(const QString& fileName, const QStri
                              "• 尝试重新保存文件").arg(fileName).arg(issue);
     }
     
-    qWarning() << "Data format error in file:" << fileName << "Issue:" << issue;
+    report(DataFormatError, Warning, QString("%1: %2").arg(fileName, issue), userMessage);
     return userMessage;
 }
 
@@ -83,7 +111,7 @@ QString ErrorHandler::handleCoordinateConversionError(const QString& details)
                                  "• 尝试关闭坐标转换功能\n"
                                  "• 联系技术支持").arg(details);
     
-    qWarning() << "Coordinate conversion error:" << details;
+    report(CoordinateConversionError, Warning, details, userMessage);
     return userMessage;
 }
 
@@ -124,7 +152,7 @@ QString ErrorHandler::handleValidationError(const QString& field, const QString&
                              "请检查数据格式是否正确。").arg(field).arg(value).arg(expected);
     }
     
-    qWarning() << "Validation error - Field:" << field << "Value:" << value << "Expected:" << expected;
+    report(ValidationError, Warning, QString("%1 = %2, expected %3").arg(field, value, expected), userMessage);
     return userMessage;
 }
 
@@ -153,7 +181,7 @@ QString ErrorHandler::handleNetworkError(const QString& service, const QString&
                              "• 联系网络管理员").arg(service).arg(details);
     }
     
-    qWarning() << "Network error - Service:" << service << "Details:" << details;
+    report(NetworkError, Warning, QString("%1: %2").arg(service, details), userMessage);
     return userMessage;
 }
 
@@ -168,7 +196,7 @@ QString ErrorHandler::handleMemoryError(const QString& operation)
                                  "• 重启应用程序\n"
                                  "• 考虑升级系统内存").arg(operation);
     
-    qCritical() << "Memory error during operation:" << operation;
+    report(MemoryError, Error, operation, userMessage);
     return userMessage;
 }
 
@@ -184,15 +212,201 @@ QString ErrorHandler::handleSystemError(const QString& operation, const QString&
                                  "• 联系技术支持\n"
                                  "• 查看系统日志").arg(operation).arg(details);
     
-    qCritical() << "System error - Operation:" << operation << "Details:" << details;
+    report(SystemError, Error, QString("%1: %2").arg(operation, details), userMessage);
     return userMessage;
 }
 
+QString ErrorHandler::handleValidationReport(const ValidationReport& validationReport, const QString& context)
+{
+    if (validationReport.isEmpty()) {
+        return QString();
+    }
+    
+    QString userMessage = QString("数据校验提示：%1\n\n"
+                                 "共处理 %2 个文件、%3 行数据，跳过 %4 行无效数据。\n")
+                         .arg(context)
+                         .arg(validationReport.fileCount())
+                         .arg(validationReport.processedRows())
+                         .arg(validationReport.skippedRows());
+    
+    for (int i = 0; i < ValidationReport::RuleCount; ++i) {
+        const auto rule = static_cast<ValidationReport::Rule>(i);
+        const ValidationReport::RuleStats& stats = validationReport.stats(rule);
+        if (stats.count == 0) {
+            continue;
+        }
+        
+        userMessage += QString("\n• %1：%2 行\n  位置：%3\n")
+                       .arg(ValidationReport::ruleName(rule))
+                       .arg(stats.count)
+                       .arg(validationReport.formatRanges(rule));
+        for (const ValidationReport::Sample& sample : stats.samples) {
+            userMessage += QString("  示例：%1\n").arg(validationReport.formatSample(sample));
+        }
+    }
+    
+    if (validationReport.skippedRows() > validationReport.processedRows() * 0.1) {
+        userMessage += "\n跳过的数据行较多，请检查数据质量和列映射设置。";
+    }
+    
+    report(ValidationError, Warning, userMessage, userMessage, context);
+    return userMessage;
+}
+
+ErrorHandler* ErrorHandler::instance()
+{
+    return s_instance.load(std::memory_order_acquire);
+}
+
+void ErrorHandler::report(ErrorType type, ErrorSeverity severity,
+                          const QString& technicalMessage, const QString& userMessage,
+                          const QString& context, const QString& component)
+{
+    ErrorInfo error(type, severity, technicalMessage, userMessage, context, component);
+    if (ErrorHandler* handler = instance()) {
+        handler->reportError(error);
+    } else {
+        logError(error);
+    }
+}
+
 void ErrorHandler::reportError(const ErrorInfo& error)
 {
-    m_errorHistory.append(error);
+    // 计数先于入队，队列满被丢弃的错误也计入统计
+    m_typeCounts[error.type].fetch_add(1, std::memory_order_relaxed);
+    m_severityCounts[error.severity].fetch_add(1, std::memory_order_relaxed);
+    m_totalCount.fetch_add(1, std::memory_order_relaxed);
+    
+    if (!tryEnqueue(error)) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    scheduleDrain();
+}
+
+void ErrorHandler::reportError(ErrorType type, ErrorSeverity severity, 
+                              const QString& technicalMessage, const QString& userMessage,
+                              const QString& context, const QString& component)
+{
+    ErrorInfo error(type, severity, technicalMessage, userMessage, context, component);
+    reportError(error);
+}
+
+bool ErrorHandler::tryEnqueue(const ErrorInfo& error)
+{
+    quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_slots[pos & (QUEUE_CAPACITY - 1)];
+        const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(sequence) - static_cast<qint64>(pos);
+        
+        if (diff == 0) {
+            // 槽位可写，抢占该位置；失败时 pos 被更新为最新值后重试
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.error = error;     // QString 隐式共享，只增加引用计数
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;               // 队列已满，消费者还没取走这一圈的数据
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ErrorHandler::tryDequeue(ErrorInfo& error)
+{
+    Slot& slot = m_slots[m_dequeuePos & (QUEUE_CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+        return false;
+    }
     
-    // 输出到日志
+    error = std::move(slot.error);
+    slot.sequence.store(m_dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+    m_dequeuePos++;
+    return true;
+}
+
+bool ErrorHandler::hasPending() const
+{
+    const Slot& slot = m_slots[m_dequeuePos & (QUEUE_CAPACITY - 1)];
+    return slot.sequence.load(std::memory_order_acquire) == m_dequeuePos + 1;
+}
+
+void ErrorHandler::scheduleDrain()
+{
+    // 只有空闲后的第一条错误投递启动请求；定时器只能在所属线程启动
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_drainScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(&m_drainTimer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+    }
+}
+
+void ErrorHandler::drain()
+{
+    // 窗口结束时汇报被限流的数量；定时器空闲停止过，先开新窗口再转发
+    if (m_forwardWindow.elapsed() >= 1000) {
+        if (m_suppressedInWindow > 0) {
+            emit errorsSuppressed(m_suppressedInWindow);
+        }
+        m_forwardWindow.restart();
+        m_forwardedInWindow = 0;
+        m_suppressedInWindow = 0;
+    }
+    
+    ErrorInfo error;
+    while (tryDequeue(error)) {
+        logError(error);
+        forward(error);
+        appendToHistory(std::move(error));
+    }
+    
+    // 队列已空且没有待汇报的限流计数时停止轮询。先清除标志再检查队列：
+    // 与 scheduleDrain 的入队后检查标志配对，两边至少有一方看到对方的写入
+    if (m_suppressedInWindow == 0) {
+        m_drainScheduled.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (hasPending()) {
+            m_drainScheduled.store(true);
+            if (!m_drainTimer.isActive()) {
+                m_drainTimer.start();
+            }
+        } else {
+            m_drainTimer.stop();
+        }
+    }
+}
+
+void ErrorHandler::appendToHistory(ErrorInfo&& error)
+{
+    if (m_historySize < HISTORY_CAPACITY) {
+        m_history[(m_historyStart + m_historySize) % HISTORY_CAPACITY] = std::move(error);
+        m_historySize++;
+    } else {
+        // 覆盖最旧的一条
+        m_history[m_historyStart] = std::move(error);
+        m_historyStart = (m_historyStart + 1) % HISTORY_CAPACITY;
+    }
+}
+
+void ErrorHandler::forward(const ErrorInfo& error)
+{
+    if (error.severity == Critical) {
+        emit criticalErrorOccurred(error);
+        emit errorReported(error);
+        return;
+    }
+    
+    if (m_forwardedInWindow >= MAX_FORWARDED_PER_SECOND) {
+        m_suppressedInWindow++;
+        return;
+    }
+    m_forwardedInWindow++;
+    emit errorReported(error);
+}
+
+void ErrorHandler::logError(const ErrorInfo& error)
+{
     QString logMessage = QString("[%1] %2 - %3: %4")
                         .arg(getSeverityString(error.severity))
                         .arg(getErrorTypeString(error.type))
@@ -201,40 +415,35 @@ void ErrorHandler::reportError(const ErrorInfo& error)
     
     switch (error.severity) {
         case Info:
-            qInfo() << logMessage;
+            qInfo().noquote() << logMessage;
             break;
         case Warning:
-            qWarning() << logMessage;
+            qWarning().noquote() << logMessage;
             break;
         case Error:
-            qWarning() << logMessage;
+            qWarning().noquote() << logMessage;
             break;
         case Critical:
-            qCritical() << logMessage;
-            emit criticalErrorOccurred(error);
+            qCritical().noquote() << logMessage;
             break;
     }
-    
-    emit errorReported(error);
-}
-
-void ErrorHandler::reportError(ErrorType type, ErrorSeverity severity, 
-                              const QString& technicalMessage, const QString& userMessage,
-                              const QString& context, const QString& component)
-{
-    ErrorInfo error(type, severity, technicalMessage, userMessage, context, component);
-    reportError(error);
 }
 
 QList<ErrorHandler::ErrorInfo> ErrorHandler::getErrorHistory() const
 {
-    return m_errorHistory;
+    QList<ErrorInfo> result;
+    result.reserve(m_historySize);
+    for (int i = 0; i < m_historySize; ++i) {
+        result.append(m_history[(m_historyStart + i) % HISTORY_CAPACITY]);
+    }
+    return result;
 }
 
 QList<ErrorHandler::ErrorInfo> ErrorHandler::getErrorsByType(ErrorType type) const
 {
     QList<ErrorInfo> result;
-    for (const ErrorInfo& error : m_errorHistory) {
+    for (int i = 0; i < m_historySize; ++i) {
+        const ErrorInfo& error = m_history[(m_historyStart + i) % HISTORY_CAPACITY];
         if (error.type == type) {
             result.append(error);
         }
@@ -245,7 +454,8 @@ QList<ErrorHandler::ErrorInfo> ErrorHandler::getErrorsByType(ErrorType type) con
 QList<ErrorHandler::ErrorInfo> ErrorHandler::getErrorsBySeverity(ErrorSeverity severity) const
 {
     QList<ErrorInfo> result;
-    for (const ErrorInfo& error : m_errorHistory) {
+    for (int i = 0; i < m_historySize; ++i) {
+        const ErrorInfo& error = m_history[(m_historyStart + i) % HISTORY_CAPACITY];
         if (error.severity == severity) {
             result.append(error);
         }
@@ -255,37 +465,38 @@ QList<ErrorHandler::ErrorInfo> ErrorHandler::getErrorsBySeverity(ErrorSeverity s
 
 void ErrorHandler::clearErrorHistory()
 {
-    m_errorHistory.clear();
+    for (ErrorInfo& error : m_history) {
+        error = ErrorInfo();
+    }
+    m_historyStart = 0;
+    m_historySize = 0;
+    
+    for (auto& count : m_typeCounts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    for (auto& count : m_severityCounts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    m_totalCount.store(0, std::memory_order_relaxed);
+    m_droppedCount.store(0, std::memory_order_relaxed);
 }
 
 int ErrorHandler::getErrorCount(ErrorType type) const
 {
     if (type == UnknownError) {
-        return m_errorHistory.size();
+        return m_totalCount.load(std::memory_order_relaxed);
     }
-    
-    int count = 0;
-    for (const ErrorInfo& error : m_errorHistory) {
-        if (error.type == type) {
-            count++;
-        }
-    }
-    return count;
+    return m_typeCounts[type].load(std::memory_order_relaxed);
 }
 
 bool ErrorHandler::hasErrors() const
 {
-    return !m_errorHistory.isEmpty();
+    return m_totalCount.load(std::memory_order_relaxed) > 0;
 }
 
 bool ErrorHandler::hasCriticalErrors() const
 {
-    for (const ErrorInfo& error : m_errorHistory) {
-        if (error.severity == Critical) {
-            return true;
-        }
-    }
-    return false;
+    return m_severityCounts[Critical].load(std::memory_order_relaxed) > 0;
 }
 
 QString ErrorHandler::generateUserFriendlyMessage(ErrorType type, const QString& context)
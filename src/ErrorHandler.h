@@ -4,6 +4,15 @@
 #include <QObject>
 #include <QString>
 #include <QDateTime>
+#include <QList>
+#include <QVector>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <array>
+#include <atomic>
+#include <memory>
+
+class ValidationReport;
 
 /**
  * @class ErrorHandler
@@ -11,6 +20,18 @@
  * 
  * ErrorHandler类提供统一的错误分类、记录和用户友好消息生成功能。
  * 支持不同类型的错误处理和本地化消息。
+ *
+ * reportError 可在任意线程调用且不会阻塞：错误写入固定容量的无锁队列（多生产者、单消费者），
+ * 并更新按类型/严重程度的原子计数；队列满时丢弃并计入 droppedCount()。
+ * 队列非空时所属线程每 DRAIN_INTERVAL_MS 取出队列，写日志、存入固定容量的历史环形缓冲区
+ * （只保留最近 HISTORY_CAPACITY 条），再按每秒 MAX_FORWARDED_PER_SECOND 条的上限
+ * 发出 errorReported；超出的合并为一次 errorsSuppressed。严重错误不受限流。
+ * 队列取空且限流窗口结束后定时器停止，下一条错误入队时再启动。
+ *
+ * 第一个创建的实例登记为进程级实例：静态 handle* 方法和没有实例指针的工作线程通过 report()
+ * 写入它；没有实例时 report() 直接写日志。
+ *
+ * 历史查询方法只能在所属线程调用；计数查询可在任意线程调用。
  */
 class ErrorHandler : public QObject
 {
@@ -55,6 +76,7 @@ public:
     };
     
     explicit ErrorHandler(QObject *parent = nullptr);
+    ~ErrorHandler() override;
     
     // 静态方法用于快速错误处理
     static QString handleFileAccessError(const QString& filePath, const QString& operation);
@@ -64,35 +86,90 @@ public:
     static QString handleNetworkError(const QString& service, const QString& details);
     static QString handleMemoryError(const QString& operation);
     static QString handleSystemError(const QString& operation, const QString& details);
+    // 一次加载的校验汇总：只输出一条日志，返回用户消息；没有问题时返回空字符串
+    static QString handleValidationReport(const ValidationReport& validationReport, const QString& context);
+    
+    // 进程级实例（任意线程），没有时为 nullptr
+    static ErrorHandler* instance();
+    // 写入进程级实例；没有实例时直接写日志
+    static void report(ErrorType type, ErrorSeverity severity,
+                       const QString& technicalMessage, const QString& userMessage,
+                       const QString& context = QString(), const QString& component = QString());
     
-    // 实例方法用于详细错误管理
+    // 实例方法用于详细错误管理（任意线程，不阻塞）
     void reportError(const ErrorInfo& error);
     void reportError(ErrorType type, ErrorSeverity severity, 
                     const QString& technicalMessage, const QString& userMessage,
                     const QString& context = QString(), const QString& component = QString());
     
-    // 获取错误历史
+    // 获取错误历史（最近 HISTORY_CAPACITY 条，按时间顺序；仅所属线程）
     QList<ErrorInfo> getErrorHistory() const;
     QList<ErrorInfo> getErrorsByType(ErrorType type) const;
     QList<ErrorInfo> getErrorsBySeverity(ErrorSeverity severity) const;
     void clearErrorHistory();
     
-    // 错误统计
+    // 错误统计（自上次清空以来的累计数，包括已滚出历史的条目；任意线程）
     int getErrorCount(ErrorType type = UnknownError) const;
     bool hasErrors() const;
     bool hasCriticalErrors() const;
+    int droppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+    
+public slots:
+    // 立即取出队列中的错误（定时器也会调用；没有事件循环的线程可定期直接调用）
+    void drain();
     
 signals:
     void errorReported(const ErrorInfo& error);
     void criticalErrorOccurred(const ErrorInfo& error);
+    void errorsSuppressed(int count);   // 限流窗口内未转发的错误数
     
 private:
-    QList<ErrorInfo> m_errorHistory;
+    // 有界无锁队列的槽位：sequence 表示槽位状态（可写 / 可读），生产者之间只竞争 m_enqueuePos
+    struct Slot {
+        std::atomic<quint64> sequence{0};
+        ErrorInfo error;
+    };
+    
+    bool tryEnqueue(const ErrorInfo& error);
+    bool tryDequeue(ErrorInfo& error);
+    bool hasPending() const;
+    void scheduleDrain();
+    void appendToHistory(ErrorInfo&& error);
+    void forward(const ErrorInfo& error);
+    static void logError(const ErrorInfo& error);
+    
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<quint64> m_enqueuePos{0};
+    quint64 m_dequeuePos = 0;                   // 仅所属线程
+    
+    std::array<std::atomic<int>, UnknownError + 1> m_typeCounts{};
+    std::array<std::atomic<int>, Critical + 1> m_severityCounts{};
+    std::atomic<int> m_totalCount{0};
+    std::atomic<int> m_droppedCount{0};
+    
+    // 历史环形缓冲区（仅所属线程）
+    QVector<ErrorInfo> m_history;
+    int m_historyStart = 0;
+    int m_historySize = 0;
+    
+    // 转发限流
+    QTimer m_drainTimer;
+    std::atomic<bool> m_drainScheduled{false};  // 定时器已启动或启动请求已投递
+    QElapsedTimer m_forwardWindow;
+    int m_forwardedInWindow = 0;
+    int m_suppressedInWindow = 0;
     
     // 生成用户友好消息的辅助方法
     static QString generateUserFriendlyMessage(ErrorType type, const QString& context);
     static QString getErrorTypeString(ErrorType type);
     static QString getSeverityString(ErrorSeverity severity);
+    
+    static std::atomic<ErrorHandler*> s_instance;
+    
+    static constexpr int QUEUE_CAPACITY = 1024;       // 必须是 2 的幂
+    static constexpr int HISTORY_CAPACITY = 1000;
+    static constexpr int DRAIN_INTERVAL_MS = 100;
+    static constexpr int MAX_FORWARDED_PER_SECOND = 5;
 };
 
 // 便利宏定义
@@ -1,25 +1,75 @@
 #include "ExcelDataReader.h"
+#include "Tracer.h"
 #include "ErrorHandler.h"
+#include "ColumnLayoutDetector.h"
+#include "WorksheetReader.h"
+#include "StringPool.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QStandardPaths>
 #include <QCoreApplication>
+#include <QHash>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
 #include <algorithm>
+#include <memory>
 
 // QXlsx includes
 #include "xlsxdocument.h"
 
 QXLSX_USE_NAMESPACE
 #include "ConfigManager.h"
+
+namespace {
+
+// 表头识别只需要前几十行，在第一块中顺序解析
+ColumnLayoutDetector::Layout resolveLayout(const WorksheetReader& sheet, const QByteArray& chunk, int previousRow,
+                                           const ConfigManager::Snapshot& config, const QString& fileName)
+{
+    const int headRowLimit = ColumnLayoutDetector::MAX_HEADER_SCAN_ROWS + ColumnLayoutDetector::SNIFF_ROWS;
+    QHash<int, WorksheetReader::RowCells> headRows;
+    int headLastRow = 0;
+    int headLastColumn = 0;
+    WorksheetReader::parseRows(chunk, previousRow, sheet.sharedStrings(), 0,
+                               [&](int row, const WorksheetReader::RowCells& cells) {
+        if (row > headRowLimit) {
+            return false;
+        }
+        headRows.insert(row, cells);
+        headLastRow = row;
+        headLastColumn = qMax(headLastColumn, static_cast<int>(cells.size()));
+        return true;
+    });
+    
+    return ColumnLayoutDetector::resolve(
+        [&headRows](int row, int column) {
+            const auto it = headRows.constFind(row);
+            return it != headRows.cend() && column <= it->size() ? it->at(column - 1) : QVariant();
+        },
+        sheet.lastRow() > 0 ? sheet.lastRow() : headLastRow,
+        sheet.lastColumn() > 0 ? sheet.lastColumn() : headLastColumn,
+        config, fileName);
+}
+
+} // namespace
+
 ExcelDataReader::ExcelDataReader(QObject *parent)
     : QObject(parent)
 {
 }
 
-bool ExcelDataReader::loadExcelFile(const QString& filePath)
+bool ExcelDataReader::loadExcelFile(const QString& filePath, ConfigManager::SnapshotPtr config)
 {
+    TRACE_SCOPE("ExcelDataReader::loadExcelFile");
+    // 整个文件使用同一份配置快照，行循环中不再访问 ConfigManager
+    if (!config) {
+        config = ConfigManager::GetInstance()->snapshot();
+    }
+    
     // Clear previous data
     m_vehicleData.clear();
+    m_validationReport.clear();
     
     // Comprehensive file access validation
     QFileInfo fileInfo(filePath);
@@ -55,7 +105,9 @@ bool ExcelDataReader::loadExcelFile(const QString& filePath)
     
     // Warn about very large files (>100MB)
     if (fileSize > 100 * 1024 * 1024) {
-        qWarning() << "Large file detected:" << filePath << "Size:" << fileSize << "bytes";
+        ErrorHandler::report(ErrorHandler::MemoryError, ErrorHandler::Info,
+                             QString("Large file detected: %1 (%2 bytes)").arg(filePath).arg(fileSize),
+                             QString(), fileInfo.fileName(), "ExcelDataReader");
         // Continue processing but warn user
     }
     
@@ -68,7 +120,18 @@ bool ExcelDataReader::loadExcelFile(const QString& filePath)
         return false;
     }
     
+    m_validationReport.beginFile(fileInfo.fileName());
+    
     try {
+        // xlsx 直接读取 zip 容器并行解析；.xls 或无法按 zip 打开的文件交给 QXlsx
+        if (suffix == "xlsx") {
+            WorksheetReader sheet;
+            QString openError;
+            if (sheet.open(filePath, openError)) {
+                return loadWorksheet(sheet, fileInfo, *config);
+            }
+        }
+        
         // Open Excel document with error handling
         Document xlsx(filePath);
         if (!xlsx.load()) {
@@ -87,10 +150,15 @@ bool ExcelDataReader::loadExcelFile(const QString& filePath)
         
         // Get the dimension of the worksheet
         CellRange range = worksheet->dimension();
-        if (range.rowCount() < ConfigManager::GetInstance()->getExcelDataStartRow()) {
+        
+        // 按表头识别本文件的列布局（不同厂商的导出列顺序不同），同一布局只识别一次
+        const ColumnLayoutDetector::Layout layout = ColumnLayoutDetector::resolve(
+            xlsx, range.lastRow(), range.lastColumn(), *config, fileInfo.fileName());
+        const int dataStartRow = layout.dataStartRow;
+        if (range.rowCount() < dataStartRow) {
             QString errorMsg = HANDLE_DATA_ERROR(fileInfo.fileName(), 
                                                QString("Excel文件行数不足。数据起始行为%1，但文件只有%2行")
-                                               .arg(ConfigManager::GetInstance()->getExcelDataStartRow())
+                                               .arg(dataStartRow)
                                                .arg(range.rowCount()));
             emit errorOccurred(errorMsg);
             return false;
@@ -99,61 +167,30 @@ bool ExcelDataReader::loadExcelFile(const QString& filePath)
         // Check for reasonable data size to prevent memory issues
         int totalCells = range.rowCount() * range.columnCount();
         if (totalCells > 1000000) { // More than 1M cells
-            qWarning() << "Large dataset detected:" << totalCells << "cells. This may take some time to process.";
+            ErrorHandler::report(ErrorHandler::MemoryError, ErrorHandler::Info,
+                                 QString("Large dataset detected: %1 cells").arg(totalCells),
+                                 QString(), fileInfo.fileName(), "ExcelDataReader");
         }
         
         // Parse data rows using column mapping with comprehensive error handling
         int totalRows = range.rowCount();
-        int processedRows = 0;
-        int validRecords = 0;
-        int skippedRows = 0;
-        QStringList errorSummary;
+        ChunkResult result;
         
         emit loadingProgress(0);
         
-        for (int row = ConfigManager::GetInstance()->getExcelDataStartRow(); row <= totalRows; ++row) {
+        for (int row = dataStartRow; row <= totalRows; ++row) {
             VehicleRecord record;
             QString rowError;
+            const bool parsed = parseDataRowWithMapping(
+                [&xlsx, row](int column) { return xlsx.read(row, column); },
+                layout.fieldMappings, record, rowError);
+            collectRow(row, parsed, record, rowError, result);
             
-            if (parseDataRowWithMapping(xlsx, row, record, rowError)) {
-                if (record.isValid()) {
-                    // Additional validation for coordinate ranges
-                    if (!record.isInChinaRange()) {
-                        qWarning() << QString("警告：车辆 %1 在第 %2 行的坐标可能不在中国境内: (%3, %4)")
-                                     .arg(record.plateNumber).arg(row).arg(record.latitude).arg(record.longitude);
-                    }
-                    
-                    // Check for reasonable speed values (0-300 km/h)
-                    if (record.speed > 300.0) {
-                        qWarning() << QString("警告：车辆 %1 在第 %2 行的速度异常高: %3 km/h")
-                                     .arg(record.plateNumber).arg(row).arg(record.speed);
-                    }
-                    
-                    m_vehicleData.append(record);
-                    validRecords++;
-                } else {
-                    skippedRows++;
-                    QString validationError = QString("第%1行数据验证失败：车牌号=%2").arg(row).arg(record.plateNumber);
-                    if (errorSummary.size() < 10) { // Limit error summary to prevent spam
-                        errorSummary.append(validationError);
-                    }
-                }
-            } else {
-                skippedRows++;
-                QString parseError = QString("第%1行数据解析失败").arg(row);
-                if (!rowError.isEmpty()) {
-                    parseError += QString("：%1").arg(rowError);
-                }
-                if (errorSummary.size() < 10) {
-                    errorSummary.append(parseError);
-                }
-            }
-            
-            processedRows++;
+            const int processedRows = static_cast<int>(result.report.processedRows());
             
             // Update progress every 100 rows or at the end
             if (processedRows % 100 == 0 || row == totalRows) {
-                int progress = (processedRows * 100) / (totalRows - ConfigManager::GetInstance()->getExcelDataStartRow() + 1);
+                int progress = (processedRows * 100) / (totalRows - dataStartRow + 1);
                 emit loadingProgress(progress);
                 
                 // Allow UI updates and prevent freezing for large datasets
@@ -163,46 +200,10 @@ bool ExcelDataReader::loadExcelFile(const QString& filePath)
             }
         }
         
-        // Validate final results
-        if (validRecords == 0) {
-            QString errorMsg = HANDLE_DATA_ERROR(fileInfo.fileName(), 
-                                               QString("文件中没有有效的车辆数据。处理了%1行，跳过了%2行无效数据。")
-                                               .arg(processedRows).arg(skippedRows));
-            if (!errorSummary.isEmpty()) {
-                errorMsg += QString("\n\n错误示例：\n%1").arg(errorSummary.join("\n"));
-            }
-            emit errorOccurred(errorMsg);
-            return false;
-        }
-        
-        // Sort data by timestamp (按时间顺序排序数据)
-        try {
-            std::sort(m_vehicleData.begin(), m_vehicleData.end(), 
-                      [](const VehicleRecord& a, const VehicleRecord& b) {
-                          return a.timestamp < b.timestamp;
-                      });
-        } catch (const std::exception& e) {
-            qWarning() << "Error sorting data by timestamp:" << e.what();
-            // Continue without sorting - data is still usable
-        }
-        
-        // Log success with statistics
-        QString successMsg = QString("成功加载 %1 条有效记录，共处理 %2 行数据")
-                            .arg(validRecords).arg(processedRows);
-        if (skippedRows > 0) {
-            successMsg += QString("，跳过 %1 行无效数据").arg(skippedRows);
-        }
-        
-        // Show warning if too many rows were skipped
-        if (skippedRows > processedRows * 0.1) { // More than 10% skipped
-            qWarning() << QString("警告：跳过了较多无效数据行 (%1/%2)，请检查数据质量")
-                         .arg(skippedRows).arg(processedRows);
-        }
-        
-        emit dataLoaded(m_vehicleData);
-        emit loadingProgress(100);
-        
-        return validRecords > 0;
+        const int processedRows = static_cast<int>(result.report.processedRows());
+        const int skippedRows = static_cast<int>(result.report.skippedRows());
+        appendChunk(result);
+        return finishLoad(fileInfo, processedRows, skippedRows);
         
     } catch (const std::bad_alloc& e) {
         QString errorMsg = HANDLE_MEMORY_ERROR("加载Excel文件");
@@ -219,6 +220,226 @@ bool ExcelDataReader::loadExcelFile(const QString& filePath)
     }
 }
 
+bool ExcelDataReader::loadWorksheet(WorksheetReader& sheet, const QFileInfo& fileInfo,
+                                    const ConfigManager::Snapshot& config)
+{
+    TRACE_SCOPE("ExcelDataReader::loadWorksheet");
+    
+    // 小文件只有一块，不值得启动多个线程；调用方已并行时由 setParseThreadCount(1) 关闭文件内并行
+    const qint64 sheetSize = qMax<qint64>(1, sheet.sheetSize());
+    const int maxThreads = m_parseThreadCount > 0 ? m_parseThreadCount : QThread::idealThreadCount();
+    const int threadCount = static_cast<int>(qBound<qint64>(1, sheetSize / PARSE_CHUNK_SIZE, maxThreads));
+    // 解压比解析快，限制排队的块数以控制内存
+    QSemaphore freeSlots(threadCount * 2);
+    
+    QList<std::shared_ptr<ChunkResult>> results;
+    ColumnLayoutDetector::Layout layout;
+    int maxColumn = 0;
+    bool layoutResolved = false;
+    QString errorMsg;
+    
+    // 线程池最后声明、最先析构（等待任务结束），任务引用的局部变量都在它之前
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    
+    emit loadingProgress(0);
+    
+    auto dispatchChunk = [&](const QByteArray& chunk, int previousRow) {
+        if (!layoutResolved) {
+            layout = resolveLayout(sheet, chunk, previousRow, config, fileInfo.fileName());
+            for (const auto& mapping : layout.fieldMappings) {
+                if (mapping.isMapped()) {
+                    maxColumn = qMax(maxColumn, mapping.columnIndex);
+                }
+            }
+            layoutResolved = true;
+            
+            if (sheet.lastRow() > 0 && sheet.lastRow() < layout.dataStartRow) {
+                errorMsg = HANDLE_DATA_ERROR(fileInfo.fileName(), 
+                                             QString("Excel文件行数不足。数据起始行为%1，但文件只有%2行")
+                                             .arg(layout.dataStartRow)
+                                             .arg(sheet.lastRow()));
+                return false;
+            }
+        }
+        
+        auto result = std::make_shared<ChunkResult>();
+        results.append(result);
+        if (threadCount == 1) {
+            // 顺序解析：不经过线程池，块解析完即释放，内存中最多一块 XML
+            parseChunk(chunk, previousRow, sheet.sharedStrings(), layout.dataStartRow, layout.fieldMappings,
+                       maxColumn, *result);
+        } else {
+            freeSlots.acquire();
+            pool.start([this, chunk, previousRow, result, &sheet, &layout, maxColumn, &freeSlots]() {
+                parseChunk(chunk, previousRow, sheet.sharedStrings(), layout.dataStartRow, layout.fieldMappings,
+                           maxColumn, *result);
+                freeSlots.release();
+            });
+        }
+        
+        // 进度按已解压的字节数估算，合并和排序留到最后
+        emit loadingProgress(static_cast<int>(qMin<qint64>(99, sheet.bytesRead() * 100 / sheetSize)));
+        QCoreApplication::processEvents();
+        return true;
+    };
+    
+    const bool read = sheet.readChunks(PARSE_CHUNK_SIZE, dispatchChunk, errorMsg);
+    pool.waitForDone();
+    if (!read || !errorMsg.isEmpty()) {
+        emit errorOccurred(errorMsg);
+        return false;
+    }
+    
+    // 按块顺序合并，记录和校验问题的行号保持升序
+    int processedRows = 0;
+    int skippedRows = 0;
+    for (const auto& result : results) {
+        if (!result->error.isEmpty()) {
+            emit errorOccurred(result->error);
+            return false;
+        }
+        processedRows += static_cast<int>(result->report.processedRows());
+        skippedRows += static_cast<int>(result->report.skippedRows());
+        appendChunk(*result);
+    }
+    return finishLoad(fileInfo, processedRows, skippedRows);
+}
+
+void ExcelDataReader::parseChunk(const QByteArray& chunk, int previousRow, const QStringList& sharedStrings,
+                                 int dataStartRow, const QList<ConfigManager::FieldMapping>& mappings,
+                                 int maxColumn, ChunkResult& result) const
+{
+    try {
+        WorksheetReader::parseRows(chunk, previousRow, sharedStrings, maxColumn,
+                                   [&](int row, const WorksheetReader::RowCells& cells) {
+            if (row < dataStartRow) {
+                return true;
+            }
+            VehicleRecord record;
+            QString rowError;
+            const bool parsed = parseDataRowWithMapping(
+                [&cells](int column) { return column <= cells.size() ? cells[column - 1] : QVariant(); },
+                mappings, record, rowError);
+            collectRow(row, parsed, record, rowError, result);
+            return true;
+        });
+    } catch (const std::bad_alloc&) {
+        result.error = HANDLE_MEMORY_ERROR("解析工作表");
+    } catch (const std::exception& e) {
+        result.error = HANDLE_SYSTEM_ERROR("解析工作表", e.what());
+    }
+}
+
+void ExcelDataReader::collectRow(int row, bool parsed, VehicleRecord& record, const QString& rowError,
+                                 ChunkResult& result) const
+{
+    // 问题行只计数和扩展区间，示例文本在本块示例未满时才生成
+    ValidationReport& report = result.report;
+    report.addProcessedRows(1);
+    
+    if (!parsed) {
+        report.record(ValidationReport::ParseFailed, row);
+        report.addSample(ValidationReport::ParseFailed, row, QString(), rowError);
+        return;
+    }
+    
+    if (!record.isValid()) {
+        report.record(ValidationReport::InvalidRecord, row);
+        if (report.needsSample(ValidationReport::InvalidRecord)) {
+            report.addSample(ValidationReport::InvalidRecord, row, record.plateNumber, invalidRecordReason(record));
+        }
+        return;
+    }
+    
+    // Additional validation for coordinate ranges
+    if (!record.isInChinaRange()) {
+        report.record(ValidationReport::OutOfChinaRange, row);
+        if (report.needsSample(ValidationReport::OutOfChinaRange)) {
+            report.addSample(ValidationReport::OutOfChinaRange, row, record.plateNumber,
+                             QString("(%1, %2)").arg(record.latitude).arg(record.longitude));
+        }
+    }
+    
+    // Check for reasonable speed values (0-300 km/h)
+    if (record.speed > ValidationReport::MAX_REASONABLE_SPEED) {
+        report.record(ValidationReport::SpeedTooHigh, row);
+        if (report.needsSample(ValidationReport::SpeedTooHigh)) {
+            report.addSample(ValidationReport::SpeedTooHigh, row, record.plateNumber,
+                             QString("%1 km/h").arg(record.speed));
+        }
+    }
+    
+    result.records.append(std::move(record));
+}
+
+void ExcelDataReader::appendChunk(ChunkResult& result)
+{
+    m_validationReport.merge(result.report);
+    
+    if (m_vehicleData.isEmpty()) {
+        m_vehicleData = std::move(result.records);
+    } else {
+        m_vehicleData.append(std::move(result.records));
+    }
+    result = ChunkResult();
+}
+
+bool ExcelDataReader::finishLoad(const QFileInfo& fileInfo, int processedRows, int skippedRows)
+{
+    // Validate final results
+    if (m_vehicleData.isEmpty()) {
+        QString errorMsg = HANDLE_DATA_ERROR(fileInfo.fileName(), 
+                                           QString("文件中没有有效的车辆数据。处理了%1行，跳过了%2行无效数据。")
+                                           .arg(processedRows).arg(skippedRows));
+        const QStringList errorSummary = m_validationReport.skippedSamples(10);
+        if (!errorSummary.isEmpty()) {
+            errorMsg += QString("\n\n错误示例：\n%1").arg(errorSummary.join("\n"));
+        }
+        emit errorOccurred(errorMsg);
+        return false;
+    }
+    
+    // Sort data by timestamp (按时间顺序排序数据)
+    try {
+        std::sort(m_vehicleData.begin(), m_vehicleData.end(), 
+                  [](const VehicleRecord& a, const VehicleRecord& b) {
+                      return a.timestamp < b.timestamp;
+                  });
+    } catch (const std::exception& e) {
+        ErrorHandler::report(ErrorHandler::SystemError, ErrorHandler::Warning,
+                             QString("Error sorting data by timestamp: %1").arg(e.what()),
+                             QString(), fileInfo.fileName(), "ExcelDataReader");
+        // Continue without sorting - data is still usable
+    }
+    
+    emit dataLoaded(m_vehicleData);
+    emit loadingProgress(100);
+    
+    return true;
+}
+
+QString ExcelDataReader::invalidRecordReason(const VehicleRecord& record)
+{
+    if (record.plateNumber.isEmpty()) {
+        return "车牌号为空";
+    }
+    if (record.longitude < -180.0 || record.longitude > 180.0 ||
+        record.latitude < -90.0 || record.latitude > 90.0) {
+        return QString("坐标超出范围 (%1, %2)").arg(record.latitude).arg(record.longitude);
+    }
+    if (record.direction < 0 || record.direction > 360) {
+        return QString("方向超出范围 %1").arg(record.direction);
+    }
+    if (record.speed < 0.0) {
+        return QString("速度为负 %1").arg(record.speed);
+    }
+    if (!record.timestamp.isValid()) {
+        return "上报时间无效";
+    }
+    return QString();
+}
+
 QList<ExcelDataReader::VehicleRecord> ExcelDataReader::getVehicleData() const
 {
     return m_vehicleData;
@@ -246,24 +467,190 @@ QList<ExcelDataReader::VehicleRecord> ExcelDataReader::getVehicleRecords(const Q
     return vehicleRecords;
 }
 
-bool ExcelDataReader::parseDataRowWithMapping(Document& xlsx, int row,
-                                              VehicleRecord& record, QString& errorMessage)
+bool ExcelDataReader::prescanFile(const QString& filePath, int& recordCount,
+                                  QDateTime& firstTimestamp, QDateTime& lastTimestamp,
+                                  ConfigManager::SnapshotPtr config) const
+{
+    recordCount = 0;
+    firstTimestamp = QDateTime();
+    lastTimestamp = QDateTime();
+    
+    if (!config) {
+        config = ConfigManager::GetInstance()->snapshot();
+    }
+    
+    try {
+        // xlsx 只解压工作表 XML，不构建单元格对象；.xls 或无法按 zip 打开的文件交给 QXlsx
+        if (QFileInfo(filePath).suffix().toLower() == "xlsx") {
+            WorksheetReader sheet;
+            QString openError;
+            if (sheet.open(filePath, openError)) {
+                return prescanWorksheet(sheet, QFileInfo(filePath).fileName(), *config,
+                                        recordCount, firstTimestamp, lastTimestamp);
+            }
+        }
+        
+        Document xlsx(filePath);
+        if (!xlsx.load()) {
+            return false;
+        }
+        
+        Worksheet* worksheet = xlsx.currentWorksheet();
+        if (!worksheet) {
+            return false;
+        }
+        
+        // 只使用工作表尺寸、表头和首、尾两行，不做逐行解析
+        CellRange range = worksheet->dimension();
+        int lastRow = range.lastRow();
+        const ColumnLayoutDetector::Layout layout = ColumnLayoutDetector::resolve(
+            xlsx, lastRow, range.lastColumn(), *config, QFileInfo(filePath).fileName());
+        int dataStartRow = layout.dataStartRow;
+        int timeColumn = 0;
+        for (const auto& mapping : layout.fieldMappings) {
+            if (mapping.fieldName == "上报时间") {
+                timeColumn = mapping.columnIndex;
+            }
+        }
+        if (lastRow < dataStartRow) {
+            return true; // 没有数据行
+        }
+        
+        recordCount = lastRow - dataStartRow + 1;
+        
+        if (timeColumn <= 0) {
+            return true; // 未映射时间列，只能给出行数
+        }
+        
+        QDateTime firstRowTime = parseTimestamp(xlsx.read(dataStartRow, timeColumn));
+        QDateTime lastRowTime = parseTimestamp(xlsx.read(lastRow, timeColumn));
+        
+        // 导出文件通常按时间排序，但也可能倒序
+        if (firstRowTime.isValid() && lastRowTime.isValid() && lastRowTime < firstRowTime) {
+            std::swap(firstRowTime, lastRowTime);
+        }
+        firstTimestamp = firstRowTime.isValid() ? firstRowTime : lastRowTime;
+        lastTimestamp = lastRowTime.isValid() ? lastRowTime : firstRowTime;
+        
+        return true;
+        
+    } catch (const std::exception& e) {
+        ErrorHandler::report(ErrorHandler::SystemError, ErrorHandler::Warning,
+                             QString("Exception prescanning file: %1").arg(e.what()),
+                             QString(), filePath, "ExcelDataReader");
+        return false;
+    } catch (...) {
+        ErrorHandler::report(ErrorHandler::SystemError, ErrorHandler::Warning,
+                             "Unknown exception prescanning file", QString(), filePath, "ExcelDataReader");
+        return false;
+    }
+}
+
+bool ExcelDataReader::prescanWorksheet(WorksheetReader& sheet, const QString& fileName,
+                                       const ConfigManager::Snapshot& config, int& recordCount,
+                                       QDateTime& firstTimestamp, QDateTime& lastTimestamp) const
+{
+    // 表头和首个数据行取自开头的块，尾行只解析最后一块；中间的块只解压、不解析
+    ColumnLayoutDetector::Layout layout;
+    int timeColumn = 0;
+    bool layoutResolved = false;
+    int firstRow = 0;
+    QVariant firstTime;
+    QByteArray lastChunk;
+    int lastChunkPreviousRow = 0;
+    QString errorMessage;
+    
+    const bool read = sheet.readChunks(PARSE_CHUNK_SIZE, [&](const QByteArray& chunk, int previousRow) {
+        if (!layoutResolved) {
+            layout = resolveLayout(sheet, chunk, previousRow, config, fileName);
+            for (const auto& mapping : layout.fieldMappings) {
+                if (mapping.fieldName == "上报时间") {
+                    timeColumn = mapping.columnIndex;
+                }
+            }
+            layoutResolved = true;
+            
+            // 有 <dimension> 且未映射时间列时，行数已知，不必继续解压
+            if (timeColumn <= 0 && sheet.lastRow() > 0) {
+                return false;
+            }
+        }
+        
+        if (firstRow == 0 && timeColumn > 0) {
+            WorksheetReader::parseRows(chunk, previousRow, sheet.sharedStrings(), timeColumn,
+                                       [&](int row, const WorksheetReader::RowCells& cells) {
+                if (row < layout.dataStartRow) {
+                    return true;
+                }
+                firstRow = row;
+                firstTime = timeColumn <= cells.size() ? cells[timeColumn - 1] : QVariant();
+                return false;
+            });
+        }
+        
+        lastChunk = chunk;
+        lastChunkPreviousRow = previousRow;
+        return true;
+    }, errorMessage);
+    if (!read) {
+        return false;   // 错误已由 WorksheetReader 报告
+    }
+    
+    int lastRow = 0;
+    QVariant lastTime;
+    if (!lastChunk.isEmpty()) {
+        WorksheetReader::parseRows(lastChunk, lastChunkPreviousRow, sheet.sharedStrings(), qMax(1, timeColumn),
+                                   [&](int row, const WorksheetReader::RowCells& cells) {
+            lastRow = row;
+            if (row >= layout.dataStartRow && timeColumn > 0 && timeColumn <= cells.size() &&
+                cells[timeColumn - 1].isValid()) {
+                lastTime = cells[timeColumn - 1];
+            }
+            return true;
+        });
+    }
+    
+    // 行数按 <dimension> 估算，与 QXlsx 的工作表尺寸一致；没有该元素时取最后一行的行号
+    if (sheet.lastRow() > 0) {
+        lastRow = sheet.lastRow();
+    }
+    if (lastRow < layout.dataStartRow) {
+        return true; // 没有数据行
+    }
+    recordCount = lastRow - layout.dataStartRow + 1;
+    
+    QDateTime firstRowTime = parseTimestamp(firstTime);
+    QDateTime lastRowTime = parseTimestamp(lastTime);
+    
+    // 导出文件通常按时间排序，但也可能倒序
+    if (firstRowTime.isValid() && lastRowTime.isValid() && lastRowTime < firstRowTime) {
+        std::swap(firstRowTime, lastRowTime);
+    }
+    firstTimestamp = firstRowTime.isValid() ? firstRowTime : lastRowTime;
+    lastTimestamp = lastRowTime.isValid() ? lastRowTime : firstRowTime;
+    return true;
+}
+
+bool ExcelDataReader::parseDataRowWithMapping(const CellReader& readCell,
+                                              const QList<ConfigManager::FieldMapping>& mappings,
+                                              VehicleRecord& record, QString& errorMessage) const
 {
     errorMessage.clear();
     
     try {
         // Parse each field based on the column mapping
-        for (const auto& mapping : ConfigManager::GetInstance()->getExcelFieldMappings()) {
+        for (const auto& mapping : mappings) {
             if (!mapping.isMapped()) {
                 continue; // Skip unmapped fields
             }
             
-            QVariant cellValue = xlsx.read(row, mapping.columnIndex);
+            QVariant cellValue = readCell(mapping.columnIndex);
             QString fieldError;
             
             // Parse and validate the field based on its type and name
             if (mapping.fieldName == "车牌号") {
-                record.plateNumber = cellValue.toString().trimmed();
+                // 直接用单元格原文查找驻留池，记录中的车牌与池共享数据
+                record.plateId = StringPool::plates().intern(cellValue.toString(), record.plateNumber);
                 if (record.plateNumber.isEmpty() && mapping.isRequired) {
                     errorMessage = "车牌号为空";
                     return false;
@@ -277,7 +664,8 @@ bool ExcelDataReader::parseDataRowWithMapping(Document& xlsx, int row,
                 }
             }
             else if (mapping.fieldName == "车牌颜色") {
-                record.vehicleColor = cellValue.toString().trimmed().contains("黄色") ? "yellow" : "blue";
+                const bool yellow = cellValue.toString().contains("黄色");
+                record.colorId = StringPool::colors().intern(yellow ? u"yellow" : u"blue", record.vehicleColor);
             }
             else if (mapping.fieldName == "速度") {
                 QVariant validatedValue = parseAndValidateField(cellValue, mapping.dataType, mapping.fieldName, fieldError);
@@ -482,7 +870,8 @@ QDateTime ExcelDataReader::parseTimestamp(const QVariant& value) const
             
             // Add fractional part as time
             double fractionalPart = serialDate - static_cast<int>(serialDate);
-            int totalSeconds = static_cast<int>(fractionalPart * 24 * 60 * 60);
+            // 四舍五入到秒，避免 13:42:07 因浮点误差变成 13:42:06
+            int totalSeconds = qRound(fractionalPart * 24 * 60 * 60);
             dt = dt.addSecs(totalSeconds);
             
             if (dt.isValid()) {
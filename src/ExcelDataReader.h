@@ -8,18 +8,27 @@
 #include <QGeoCoordinate>
 #include <QMap>
 #include <QVariant>
+#include <functional>
+#include "ValidationReport.h"
+#include "ConfigManager.h"
 
 // Forward declarations
 namespace QXlsx {
     class Document;
     class Worksheet;
 }
+class WorksheetReader;
+class QFileInfo;
 
 /**
  * @class ExcelDataReader
  * @brief 使用用户定义的列映射读取和解析Excel格式的车辆轨迹数据
  * 
+ * .xlsx 文件直接读取 zip 容器（WorksheetReader），工作表 XML 按行切块后在多个线程中解析，
+ * 各块的记录和校验问题按行号顺序合并；无法按 zip 打开的文件退回 QXlsx 逐行读取。
+ * 
  * @see VehicleRecord
+ * @see WorksheetReader
  * @see ConfigManager
  */
 class ExcelDataReader : public QObject
@@ -44,6 +53,8 @@ public:
         double distance;         // 距离 (如: 11)
         QDateTime timestamp;     // 上报时间 (如: 2025-05-23 13:42:07)
         QString totalMileage;    // 总里程 (如: 55511)
+        int plateId = -1;        // StringPool::plates() 中的 id，按车辆比较时使用
+        int colorId = -1;        // StringPool::colors() 中的 id
         
         // 坐标访问方法
         QGeoCoordinate coordinate() const { 
@@ -77,12 +88,23 @@ public:
     
     explicit ExcelDataReader(QObject *parent = nullptr);
     
+    /**
+     * @brief 单个文件内并行解析使用的线程数
+     * @param threadCount 0 = 按文件大小自动选择（不超过核心数），1 = 在调用线程内顺序解析
+     * 
+     * @note 调用方已在线程池中为每个文件/车辆各开一个任务时应设为 1，避免线程数相乘
+     */
+    void setParseThreadCount(int threadCount) { m_parseThreadCount = qMax(0, threadCount); }
+    int parseThreadCount() const { return m_parseThreadCount; }
+    
     /**
      * @brief 使用列映射配置加载Excel文件
+     * @param filePath Excel文件路径
+     * @param config 配置快照；为空时取 ConfigManager 的当前快照。批量加载应在任务开始时取一次并传入
      * 
      * @note 加载成功后会发射 dataLoaded 信号，加载过程中会发射 loadingProgress 信号
      */
-    bool loadExcelFile(const QString& filePath);
+    bool loadExcelFile(const QString& filePath, ConfigManager::SnapshotPtr config = nullptr);
     
     // 数据访问方法
     /**
@@ -104,6 +126,30 @@ public:
      */
     QList<VehicleRecord> getVehicleRecords(const QString& plateNumber) const;
     
+    /**
+     * @brief 最近一次 loadExcelFile 的数据校验汇总
+     * @return 按规则计数的问题行、示例和行区间；调用方负责跨文件合并和输出
+     */
+    const ValidationReport& validationReport() const { return m_validationReport; }
+    
+    /**
+     * @brief 轻量预扫描：只读取工作表尺寸以及首、尾数据行的上报时间
+     * 
+     * xlsx 通过 WorksheetReader 流式解压工作表，只解析表头、首行和最后一块中的行；
+     * QXlsx 只用于 .xls 等无法按 zip 打开的文件。
+     * @param filePath Excel文件路径
+     * @param recordCount 输出数据行数（按工作表尺寸估算，不逐行校验）
+     * @param firstTimestamp 输出首行与尾行中较早的时间
+     * @param lastTimestamp 输出首行与尾行中较晚的时间
+     * @param config 配置快照；为空时取 ConfigManager 的当前快照
+     * @return 是否成功读取
+     * 
+     * @note 不发射任何信号，可在工作线程中调用
+     */
+    bool prescanFile(const QString& filePath, int& recordCount,
+                     QDateTime& firstTimestamp, QDateTime& lastTimestamp,
+                     ConfigManager::SnapshotPtr config = nullptr) const;
+    
 signals:
     void dataLoaded(const QList<VehicleRecord>& records);
     void loadingProgress(int percentage);
@@ -111,14 +157,38 @@ signals:
     void columnMappingValidated(bool isValid, const QStringList& errors);
     
 private:
+    // 一块数据行的解析结果，在工作线程中填充，按块顺序合并到读取器
+    struct ChunkResult {
+        QList<VehicleRecord> records;
+        ValidationReport report;    // 不调用 beginFile，合并时归入当前文件；内存只随示例和区间上限增长
+        QString error;
+    };
+    
+    using CellReader = std::function<QVariant(int column)>;
+    
     QList<VehicleRecord> m_vehicleData;
+    ValidationReport m_validationReport;
+    int m_parseThreadCount = 0;
     
-    // 核心解析方法
-    bool parseDataRowWithMapping(QXlsx::Document& xlsx, int row,
-                                VehicleRecord& record, QString& errorMessage);
+    bool loadWorksheet(WorksheetReader& sheet, const QFileInfo& fileInfo, const ConfigManager::Snapshot& config);
+    bool prescanWorksheet(WorksheetReader& sheet, const QString& fileName, const ConfigManager::Snapshot& config,
+                          int& recordCount, QDateTime& firstTimestamp, QDateTime& lastTimestamp) const;
+    void parseChunk(const QByteArray& chunk, int previousRow, const QStringList& sharedStrings, int dataStartRow,
+                    const QList<ConfigManager::FieldMapping>& mappings, int maxColumn, ChunkResult& result) const;
+    void collectRow(int row, bool parsed, VehicleRecord& record, const QString& rowError, ChunkResult& result) const;
+    void appendChunk(ChunkResult& result);
+    bool finishLoad(const QFileInfo& fileInfo, int processedRows, int skippedRows);
+    
+    // 核心解析方法（不访问成员，可在工作线程中调用）
+    bool parseDataRowWithMapping(const CellReader& readCell,
+                                const QList<ConfigManager::FieldMapping>& mappings,
+                                VehicleRecord& record, QString& errorMessage) const;
     QDateTime parseTimestamp(const QVariant& value) const;
+    static QString invalidRecordReason(const VehicleRecord& record);
     QVariant parseAndValidateField(const QVariant& cellValue, const QString& dataType, 
                                   const QString& fieldName, QString& errorMessage) const;
+    
+    static constexpr qsizetype PARSE_CHUNK_SIZE = 4 * 1024 * 1024;     // 每个解析任务的工作表 XML 字节数
 };
 
 #endif // EXCELDATAREADER_H
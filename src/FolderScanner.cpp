@@ -1,23 +1,41 @@
 #include "FolderScanner.h"
 #include "ExcelDataReader.h"
 #include "ErrorHandler.h"
+#include "ConfigManager.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QMap>
 #include <QSet>
 #include <QCoreApplication>
 #include <QRegularExpression>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
 #include <algorithm>
 #include <numeric>
 
 FolderScanner::FolderScanner(QObject *parent)
     : QObject(parent)
 {
+    // 预扫描只占用一半核心，避免影响界面和正在进行的轨迹加载
+    m_prescanPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    
+    loadManifest();
+}
+
+FolderScanner::~FolderScanner()
+{
+    cancelPrescan();
+    m_prescanPool.waitForDone();
 }
 
 void FolderScanner::scanFolder(const QString& folderPath)
 {
+    cancelPrescan();
     m_vehicleList.clear();
+    m_fileToVehicleIndex.clear();
     
     // Comprehensive folder validation
     if (folderPath.isEmpty()) {
@@ -108,23 +126,27 @@ void FolderScanner::scanFolder(const QString& folderPath)
             if (match.hasMatch()) {
                 QString plateNumber = match.captured(1);
                 
+                // 文件被修改过则扫描清单中的预扫描结果失效
+                auto summaryIt = m_fileSummaries.find(filePath);
+                if (summaryIt != m_fileSummaries.end() &&
+                    (summaryIt->fileSize != fileInfo.size() ||
+                     summaryIt->lastModified != fileInfo.lastModified())) {
+                    m_fileSummaries.erase(summaryIt);
+                }
+                
                 // Update or create vehicle info
                 if (vehicleMap.contains(plateNumber)) {
                     // Add this file to existing vehicle's file list
                     VehicleInfo& info = vehicleMap[plateNumber];
                     if (!info.filePaths.contains(filePath)) {
                         info.filePaths.append(filePath);
-                        info.recordCount++; // 简单计数文件数量，实际记录数在加载时才知道
                     }
                 } else {
                     // Create new vehicle info
                     VehicleInfo info;
                     info.plateNumber = plateNumber;
                     info.filePaths.append(filePath);
-                    info.recordCount = 1; // 文件数量
-                    // 时间戳将在实际加载数据时设置
-                    info.firstTimestamp = QDateTime();
-                    info.lastTimestamp = QDateTime();
+                    // 记录数和时间戳来自扫描清单或后台预扫描
                     
                     vehicleMap[plateNumber] = info;
                 }
@@ -180,6 +202,14 @@ void FolderScanner::scanFolder(const QString& folderPath)
                       return a.plateNumber < b.plateNumber;
                   });
         
+        // Fill record counts and time spans from the scan manifest where still valid
+        for (int i = 0; i < m_vehicleList.size(); ++i) {
+            for (const QString& path : m_vehicleList[i].filePaths) {
+                m_fileToVehicleIndex.insert(path, i);
+            }
+            refreshVehicleInfo(m_vehicleList[i]);
+        }
+        
         // Log comprehensive statistics
         int totalFiles = std::accumulate(m_vehicleList.begin(), m_vehicleList.end(), 0,
                                         [](int sum, const VehicleInfo& info) { return sum + info.filePaths.size(); });
@@ -217,3 +247,193 @@ QList<FolderScanner::VehicleInfo> FolderScanner::getVehicleList() const
 {
     return m_vehicleList;
 }
+
+void FolderScanner::startPrescan()
+{
+    cancelPrescan();
+    
+    // 本轮预扫描的所有文件使用同一份配置快照（单例必须先在主线程创建）
+    const ConfigManager::SnapshotPtr config = ConfigManager::GetInstance()->snapshot();
+    
+    QStringList pendingFiles;
+    for (const auto& info : m_vehicleList) {
+        for (const QString& path : info.filePaths) {
+            // 过期记录已在 scanFolder 中移除
+            if (!m_fileSummaries.contains(path)) {
+                pendingFiles.append(path);
+            }
+        }
+    }
+    
+    m_prescanTotal = pendingFiles.size();
+    m_prescanPending = pendingFiles.size();
+    
+    if (pendingFiles.isEmpty()) {
+        emit prescanCompleted();
+        return;
+    }
+    
+    int generation = m_prescanGeneration;
+    for (const QString& path : pendingFiles) {
+        m_prescanPool.start([this, generation, path, config]() {
+            if (generation != m_prescanGeneration) {
+                return; // 已被新的扫描取代
+            }
+            
+            QFileInfo fileInfo(path);
+            FileSummary summary;
+            summary.fileSize = fileInfo.size();
+            summary.lastModified = fileInfo.lastModified();
+            
+            ExcelDataReader reader;
+            const bool succeeded = reader.prescanFile(path, summary.recordCount,
+                                                      summary.firstTimestamp, summary.lastTimestamp, config);
+            if (!succeeded) {
+                qWarning() << "Prescan failed for file:" << path;
+            }
+            
+            // 结果回到对象所在线程合并
+            QMetaObject::invokeMethod(this, [this, generation, path, summary, succeeded]() {
+                applyFileSummary(generation, path, summary, succeeded);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void FolderScanner::cancelPrescan()
+{
+    m_prescanGeneration++;
+    m_prescanPool.clear();
+    m_prescanPending = 0;
+    m_prescanTotal = 0;
+}
+
+void FolderScanner::applyFileSummary(int generation, const QString& filePath, const FileSummary& summary,
+                                     bool succeeded)
+{
+    if (generation != m_prescanGeneration) {
+        return;
+    }
+    
+    // 失败的文件不写入清单，下次扫描时重试，避免把 0 行记录当作有效结果缓存
+    if (succeeded) {
+        m_fileSummaries.insert(filePath, summary);
+    }
+    
+    int index = m_fileToVehicleIndex.value(filePath, -1);
+    if (succeeded && index >= 0 && index < m_vehicleList.size()) {
+        VehicleInfo& info = m_vehicleList[index];
+        refreshVehicleInfo(info);
+        if (info.isPrescanned()) {
+            emit vehicleInfoUpdated(info);
+        }
+    }
+    
+    m_prescanPending--;
+    emit prescanProgress(m_prescanTotal - m_prescanPending, m_prescanTotal);
+    
+    if (m_prescanPending == 0) {
+        saveManifest();
+        emit prescanCompleted();
+    }
+}
+
+void FolderScanner::refreshVehicleInfo(VehicleInfo& info) const
+{
+    info.recordCount = 0;
+    info.prescannedFiles = 0;
+    info.firstTimestamp = QDateTime();
+    info.lastTimestamp = QDateTime();
+    
+    for (const QString& path : info.filePaths) {
+        auto it = m_fileSummaries.constFind(path);
+        if (it == m_fileSummaries.constEnd()) {
+            continue;
+        }
+        
+        info.prescannedFiles++;
+        info.recordCount += it->recordCount;
+        
+        if (it->firstTimestamp.isValid() &&
+            (!info.firstTimestamp.isValid() || it->firstTimestamp < info.firstTimestamp)) {
+            info.firstTimestamp = it->firstTimestamp;
+        }
+        if (it->lastTimestamp.isValid() &&
+            (!info.lastTimestamp.isValid() || it->lastTimestamp > info.lastTimestamp)) {
+            info.lastTimestamp = it->lastTimestamp;
+        }
+    }
+}
+
+QString FolderScanner::manifestPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/scan_manifest.json";
+}
+
+void FolderScanner::loadManifest()
+{
+    m_fileSummaries.clear();
+    
+    QFile file(manifestPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return; // 首次运行没有清单
+    }
+    
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "Ignoring invalid scan manifest:" << parseError.errorString();
+        return;
+    }
+    
+    QJsonObject files = doc.object()["files"].toObject();
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        QJsonObject entry = it.value().toObject();
+        FileSummary summary;
+        summary.fileSize = static_cast<qint64>(entry["size"].toDouble());
+        summary.lastModified = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(entry["modified"].toDouble()));
+        summary.recordCount = entry["records"].toInt();
+        if (entry.contains("first")) {
+            summary.firstTimestamp = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(entry["first"].toDouble()));
+        }
+        if (entry.contains("last")) {
+            summary.lastTimestamp = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(entry["last"].toDouble()));
+        }
+        m_fileSummaries.insert(it.key(), summary);
+    }
+}
+
+void FolderScanner::saveManifest() const
+{
+    QJsonObject files;
+    for (auto it = m_fileSummaries.constBegin(); it != m_fileSummaries.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["size"] = static_cast<double>(it->fileSize);
+        entry["modified"] = static_cast<double>(it->lastModified.toMSecsSinceEpoch());
+        entry["records"] = it->recordCount;
+        if (it->firstTimestamp.isValid()) {
+            entry["first"] = static_cast<double>(it->firstTimestamp.toMSecsSinceEpoch());
+        }
+        if (it->lastTimestamp.isValid()) {
+            entry["last"] = static_cast<double>(it->lastTimestamp.toMSecsSinceEpoch());
+        }
+        files.insert(it.key(), entry);
+    }
+    
+    QJsonObject root;
+    root["version"] = 1;
+    root["files"] = files;
+    
+    QString path = manifestPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write scan manifest:" << path;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Cannot commit scan manifest:" << path;
+    }
+}
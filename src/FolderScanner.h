@@ -5,32 +5,70 @@
 #include <QString>
 #include <QStringList>
 #include <QDateTime>
+#include <QHash>
+#include <QThreadPool>
+#include <atomic>
 
 class FolderScanner : public QObject
 {
     Q_OBJECT
-    
+
 public:
     struct VehicleInfo {
         QString plateNumber;
         QStringList filePaths;        // 改为文件路径列表，支持多个文件
+        QDateTime firstTimestamp;     // 预扫描后填充，未扫描时无效
+        QDateTime lastTimestamp;
+        int recordCount = 0;          // 预扫描得到的数据行数之和，0 表示尚未扫描
+        int prescannedFiles = 0;      // 已有预扫描结果的文件数
+
+        bool isPrescanned() const { return prescannedFiles >= filePaths.size(); }
+    };
+
+    // 单个文件的预扫描结果，持久化到扫描清单中
+    struct FileSummary {
+        qint64 fileSize = 0;
+        QDateTime lastModified;       // 与文件大小一起用于判断缓存是否失效
+        int recordCount = 0;
         QDateTime firstTimestamp;
         QDateTime lastTimestamp;
-        int recordCount;
     };
-    
+
     explicit FolderScanner(QObject *parent = nullptr);
-    
+    ~FolderScanner();
+
     void scanFolder(const QString& folderPath);
     QList<VehicleInfo> getVehicleList() const;
-    
+
+    // 后台预扫描尚无清单记录的文件，只读取工作表尺寸和首尾行
+    void startPrescan();
+    void cancelPrescan();
+    bool isPrescanning() const { return m_prescanPending > 0; }
+
 signals:
     void scanCompleted(const QList<VehicleInfo>& vehicles);
     void scanProgress(int percentage);
     void scanError(const QString& error);
-    
+    void vehicleInfoUpdated(const VehicleInfo& info);
+    void prescanProgress(int processedFiles, int totalFiles);
+    void prescanCompleted();
+
 private:
+    void applyFileSummary(int generation, const QString& filePath, const FileSummary& summary,
+                          bool succeeded);
+    void refreshVehicleInfo(VehicleInfo& info) const;
+    void loadManifest();
+    void saveManifest() const;
+    static QString manifestPath();
+
     QList<VehicleInfo> m_vehicleList;
+    QHash<QString, int> m_fileToVehicleIndex;    // 文件路径 -> m_vehicleList 下标
+    QHash<QString, FileSummary> m_fileSummaries; // 扫描清单：文件路径 -> 预扫描结果
+
+    QThreadPool m_prescanPool;
+    std::atomic<int> m_prescanGeneration{0};     // 每次重新扫描递增，丢弃过期结果
+    int m_prescanPending = 0;
+    int m_prescanTotal = 0;
 };
 
-#endif // FOLDERSCANNER_H
\ No newline at end of file
+#endif // FOLDERSCANNER_H
@@ -0,0 +1,534 @@
+#include "FuelJsonStreamReader.h"
+#include "FuelUnloadingDataLoader.h"
+#include <QFile>
+#include <QByteArray>
+#include <algorithm>
+#include <cstring>
+
+FuelJsonStreamReader::FuelJsonStreamReader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool FuelJsonStreamReader::readFile(const QString& filePath, FuelRecordStore& store, QString& errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("无法打开文件: %1").arg(filePath);
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size > 0) {
+        uchar* mapped = file.map(0, size);
+        if (mapped) {
+            bool success = readData(reinterpret_cast<const char*>(mapped), size, store, errorMessage);
+            file.unmap(mapped);
+            return success;
+        }
+    }
+
+    // 无法映射（如压缩的资源文件）时退回整体读入
+    QByteArray data = file.readAll();
+    return readData(data.constData(), data.size(), store, errorMessage);
+}
+
+bool FuelJsonStreamReader::readData(const char* data, qint64 size, FuelRecordStore& store, QString& errorMessage)
+{
+    m_begin = data;
+    m_pos = data;
+    m_end = data + size;
+    m_store = &store;
+    m_errorMessage.clear();
+    m_nextProgress = PROGRESS_STEP;
+
+    // 跳过 UTF-8 BOM
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        m_pos += 3;
+    }
+
+    bool success = true;
+    skipWhitespace();
+    if (m_pos >= m_end) {
+        success = fail("文件为空");
+    }
+
+    // 顶层为一个或多个对象：标准文档只有一个，NDJSON 每行一个
+    while (success && m_pos < m_end) {
+        if (*m_pos != '{') {
+            success = fail("顶层应为对象");
+            break;
+        }
+        success = parseObject(TopLevel);
+        skipWhitespace();
+    }
+
+    m_store = nullptr;
+    if (!success) {
+        errorMessage = m_errorMessage;
+        return false;
+    }
+
+    emit progress(size, size);
+    return true;
+}
+
+bool FuelJsonStreamReader::parseObject(ObjectContext context)
+{
+    if (!expect('{')) {
+        return false;
+    }
+
+    QString plateNumber;
+    bool hasPlate = false;
+    bool hasVehicles = false;
+    bool hasRecords = false;
+    bool hasRecordFields = false;
+    RawRecord lineRecord;       // NDJSON 单条记录行
+    QList<RawRecord> pending;   // "records" 出现在 "plateNumber" 之前时暂存，只占一辆车的记录
+
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == '}') {
+        ++m_pos;
+    } else {
+        while (true) {
+            Span key;
+            if (!readKey(key) || !expect(':')) {
+                return false;
+            }
+
+            if (context == TopLevel && keyIs(key, "vehicles")) {
+                // 不是数组时按未识别字段跳过
+                if (peekArray()) {
+                    hasVehicles = true;
+                    if (!parseVehiclesArray()) {
+                        return false;
+                    }
+                } else if (!skipValue()) {
+                    return false;
+                }
+            } else if (keyIs(key, "plateNumber")) {
+                if (!readStringOrSkip(plateNumber)) {
+                    return false;
+                }
+                hasPlate = true;
+                m_store->addPlate(plateNumber); // 保持车辆在文件中的出现顺序
+            } else if (keyIs(key, "records")) {
+                if (peekArray()) {
+                    hasRecords = true;
+                    if (!parseRecordsArray(hasPlate ? &plateNumber : nullptr, pending)) {
+                        return false;
+                    }
+                } else if (!skipValue()) {
+                    return false;
+                }
+            } else {
+                bool matched = false;
+                if (!parseRecordField(key, lineRecord, matched)) {
+                    return false;
+                }
+                hasRecordFields = hasRecordFields || matched;
+            }
+
+            skipWhitespace();
+            if (m_pos < m_end && *m_pos == ',') {
+                ++m_pos;
+                continue;
+            }
+            if (!expect('}')) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    // 顶层的记录字段只在没有 vehicles / records 容器时才是一条 NDJSON 记录
+    if (context == TopLevel && hasRecordFields && !hasVehicles && !hasRecords) {
+        lineRecord.plateNumber = plateNumber;
+        appendRecord(lineRecord);
+    } else if (context == VehicleElement || hasPlate || hasRecords) {
+        m_store->addPlate(plateNumber);
+        for (RawRecord& record : pending) {
+            record.plateNumber = plateNumber;
+            appendRecord(record);
+        }
+    }
+
+    return true;
+}
+
+bool FuelJsonStreamReader::parseVehiclesArray()
+{
+    if (!expect('[')) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == ']') {
+        ++m_pos;
+        return true;
+    }
+
+    while (true) {
+        skipWhitespace();
+        // 非对象元素跳过
+        bool success = (m_pos < m_end && *m_pos == '{') ? parseObject(VehicleElement) : skipValue();
+        if (!success) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == ',') {
+            ++m_pos;
+            continue;
+        }
+        return expect(']');
+    }
+}
+
+bool FuelJsonStreamReader::parseRecordsArray(const QString* plateNumber, QList<RawRecord>& pending)
+{
+    if (!expect('[')) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == ']') {
+        ++m_pos;
+        return true;
+    }
+
+    while (true) {
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == '{') {
+            RawRecord record;
+            if (!parseRecordObject(record)) {
+                return false;
+            }
+            if (plateNumber) {
+                record.plateNumber = *plateNumber;
+                appendRecord(record);
+            } else {
+                pending.append(record);
+            }
+        } else if (!skipValue()) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == ',') {
+            ++m_pos;
+            continue;
+        }
+        return expect(']');
+    }
+}
+
+bool FuelJsonStreamReader::parseRecordObject(RawRecord& record)
+{
+    if (!expect('{')) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == '}') {
+        ++m_pos;
+        return true;
+    }
+
+    while (true) {
+        Span key;
+        bool matched = false;
+        if (!readKey(key) || !expect(':') || !parseRecordField(key, record, matched)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == ',') {
+            ++m_pos;
+            continue;
+        }
+        return expect('}');
+    }
+}
+
+bool FuelJsonStreamReader::parseRecordField(const Span& key, RawRecord& record, bool& matched)
+{
+    matched = true;
+    if (keyIs(key, "date")) {
+        return readStringOrSkip(record.date);
+    }
+    if (keyIs(key, "time")) {
+        return readStringOrSkip(record.time);
+    }
+    if (keyIs(key, "fuelType")) {
+        return readStringOrSkip(record.fuelType);
+    }
+    if (keyIs(key, "amount")) {
+        return readNumberOrSkip(record.amount);
+    }
+    if (keyIs(key, "longitude")) {
+        return readNumberOrSkip(record.longitude);
+    }
+    if (keyIs(key, "latitude")) {
+        return readNumberOrSkip(record.latitude);
+    }
+    if (keyIs(key, "correctedLongitude")) {
+        return readNumberOrSkip(record.correctedLongitude);
+    }
+    if (keyIs(key, "correctedLatitude")) {
+        return readNumberOrSkip(record.correctedLatitude);
+    }
+
+    matched = false;
+    return skipValue();
+}
+
+bool FuelJsonStreamReader::readKey(Span& key)
+{
+    skipWhitespace();
+    if (m_pos >= m_end || *m_pos != '"') {
+        return fail("应为字段名");
+    }
+
+    // 快速路径：键不含转义字符时直接引用映射内存
+    const char* start = m_pos + 1;
+    const char* p = start;
+    while (p < m_end && *p != '"' && *p != '\\') {
+        ++p;
+    }
+    if (p < m_end && *p == '"') {
+        key.data = start;
+        key.size = int(p - start);
+        m_pos = p + 1;
+        return true;
+    }
+
+    QString decoded;
+    if (!readString(decoded)) {
+        return false;
+    }
+    m_keyBuffer = decoded.toUtf8();
+    key.data = m_keyBuffer.constData();
+    key.size = m_keyBuffer.size();
+    return true;
+}
+
+bool FuelJsonStreamReader::readString(QString& value)
+{
+    if (!expect('"')) {
+        return false;
+    }
+
+    value.clear();
+    const char* segment = m_pos;
+    while (m_pos < m_end) {
+        const char c = *m_pos;
+        if (c == '"') {
+            value += QString::fromUtf8(segment, m_pos - segment);
+            ++m_pos;
+            return true;
+        }
+        if (c != '\\') {
+            ++m_pos;
+            continue;
+        }
+
+        value += QString::fromUtf8(segment, m_pos - segment);
+        if (m_end - m_pos < 2) {
+            break;
+        }
+        const char escape = m_pos[1];
+        m_pos += 2;
+        switch (escape) {
+        case '"':  value += QLatin1Char('"'); break;
+        case '\\': value += QLatin1Char('\\'); break;
+        case '/':  value += QLatin1Char('/'); break;
+        case 'b':  value += QLatin1Char('\b'); break;
+        case 'f':  value += QLatin1Char('\f'); break;
+        case 'n':  value += QLatin1Char('\n'); break;
+        case 'r':  value += QLatin1Char('\r'); break;
+        case 't':  value += QLatin1Char('\t'); break;
+        case 'u': {
+            bool ok = false;
+            ushort code = (m_end - m_pos >= 4) ? QByteArray::fromRawData(m_pos, 4).toUShort(&ok, 16) : 0;
+            if (!ok) {
+                return fail("无效的 \\u 转义");
+            }
+            value += QChar(code); // 代理对按两个 UTF-16 单元依次追加
+            m_pos += 4;
+            break;
+        }
+        default:
+            return fail("无效的转义字符");
+        }
+        segment = m_pos;
+    }
+
+    return fail("字符串未结束");
+}
+
+bool FuelJsonStreamReader::readStringOrSkip(QString& value)
+{
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == '"') {
+        return readString(value);
+    }
+    value.clear();
+    return skipValue();
+}
+
+bool FuelJsonStreamReader::readNumberOrSkip(double& value)
+{
+    skipWhitespace();
+    if (m_pos >= m_end || !(*m_pos == '-' || (*m_pos >= '0' && *m_pos <= '9'))) {
+        value = 0.0;
+        return skipValue();
+    }
+
+    const char* start = m_pos;
+    while (m_pos < m_end && std::strchr("+-.eE0123456789", *m_pos) && *m_pos != '\0') {
+        ++m_pos;
+    }
+
+    bool ok = false;
+    value = QByteArray::fromRawData(start, int(m_pos - start)).toDouble(&ok); // 与区域设置无关
+    if (!ok) {
+        m_pos = start;
+        return fail("无效的数字");
+    }
+    return true;
+}
+
+bool FuelJsonStreamReader::skipValue()
+{
+    skipWhitespace();
+    if (m_pos >= m_end) {
+        return fail("意外的文件结尾");
+    }
+
+    const char c = *m_pos;
+    if (c == '"') {
+        return skipString();
+    }
+
+    if (c == '{' || c == '[') {
+        // 只做括号配对，不校验被跳过内容的细节
+        int depth = 0;
+        while (m_pos < m_end) {
+            const char ch = *m_pos;
+            if (ch == '"') {
+                if (!skipString()) {
+                    return false;
+                }
+                continue;
+            }
+            if (ch == '{' || ch == '[') {
+                depth++;
+            } else if (ch == '}' || ch == ']') {
+                if (--depth == 0) {
+                    ++m_pos;
+                    return true;
+                }
+            }
+            ++m_pos;
+        }
+        return fail("对象或数组未结束");
+    }
+
+    // 数字、true/false/null
+    const char* start = m_pos;
+    while (m_pos < m_end && !std::strchr(",}] \t\r\n", *m_pos)) {
+        ++m_pos;
+    }
+    if (m_pos == start) {
+        return fail("意外的字符");
+    }
+    return true;
+}
+
+bool FuelJsonStreamReader::skipString()
+{
+    ++m_pos; // 开头的引号
+    while (m_pos < m_end) {
+        if (*m_pos == '\\') {
+            if (m_end - m_pos < 2) {
+                break;
+            }
+            m_pos += 2;
+            continue;
+        }
+        if (*m_pos == '"') {
+            ++m_pos;
+            return true;
+        }
+        ++m_pos;
+    }
+    m_pos = m_end;
+    return fail("字符串未结束");
+}
+
+bool FuelJsonStreamReader::peekArray()
+{
+    skipWhitespace();
+    return m_pos < m_end && *m_pos == '[';
+}
+
+bool FuelJsonStreamReader::expect(char c)
+{
+    skipWhitespace();
+    if (m_pos < m_end && *m_pos == c) {
+        ++m_pos;
+        return true;
+    }
+    return fail(QString("应为 '%1'").arg(QLatin1Char(c)));
+}
+
+void FuelJsonStreamReader::skipWhitespace()
+{
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+        ++m_pos;
+    }
+}
+
+void FuelJsonStreamReader::appendRecord(const RawRecord& raw)
+{
+    FuelRecordStore::Record record;
+    record.plateNumber = raw.plateNumber;
+    record.dateTime = FuelUnloadingDataLoader::parseDateTime(raw.date, raw.time, &record.hasTime);
+    record.fuelType = raw.fuelType;
+    record.amount = raw.amount;
+    record.longitude = raw.longitude;
+    record.latitude = raw.latitude;
+    record.correctedLongitude = raw.correctedLongitude;
+    record.correctedLatitude = raw.correctedLatitude;
+    m_store->append(record);
+
+    reportProgress();
+}
+
+void FuelJsonStreamReader::reportProgress()
+{
+    const qint64 bytesRead = m_pos - m_begin;
+    if (bytesRead >= m_nextProgress) {
+        emit progress(bytesRead, m_end - m_begin);
+        m_nextProgress = bytesRead + PROGRESS_STEP;
+    }
+}
+
+bool FuelJsonStreamReader::fail(const QString& message)
+{
+    const char* at = std::min(m_pos, m_end);
+    const qint64 line = 1 + std::count(m_begin, at, '\n');
+    m_errorMessage = QString("JSON解析错误: %1（第 %2 行，偏移 %3）")
+                         .arg(message)
+                         .arg(line)
+                         .arg(qint64(at - m_begin));
+    return false;
+}
+
+bool FuelJsonStreamReader::keyIs(const Span& key, const char* literal)
+{
+    const size_t length = std::strlen(literal);
+    return size_t(key.size) == length && std::memcmp(key.data, literal, length) == 0;
+}
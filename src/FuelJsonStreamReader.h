@@ -0,0 +1,94 @@
+#ifndef FUELJSONSTREAMREADER_H
+#define FUELJSONSTREAMREADER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include "FuelRecordStore.h"
+
+/**
+ * @class FuelJsonStreamReader
+ * @brief 卸油记录 JSON 的流式读取器，一遍解析直接写入 FuelRecordStore
+ *
+ * 文件以内存映射方式读取，解析过程中不构建 QJsonDocument，也不生成中间 QVariant，
+ * 峰值内存只有类型化的记录列本身。支持两种输入：
+ * - 标准文档：{"vehicles": [{"plateNumber": ..., "records": [...]}, ...]}
+ * - NDJSON（每行一个对象，适合只追加的日志）：每行可以是一个车辆对象
+ *   {"plateNumber": ..., "records": [...]}，也可以是带 plateNumber 字段的单条记录
+ *
+ * 未识别的字段以及不是数组的 vehicles / records 直接跳过；数值字段不是数字、字符串字段不是字符串时按 0 / 空串处理，
+ * 与原先 QJsonValue::toDouble()/toString() 的行为一致。
+ */
+class FuelJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FuelJsonStreamReader(QObject *parent = nullptr);
+
+    /**
+     * @brief 读取文件（优先内存映射，映射失败时整体读入，如压缩的资源文件）
+     * @param store 记录追加到此存储，调用方负责事先清空
+     */
+    bool readFile(const QString& filePath, FuelRecordStore& store, QString& errorMessage);
+    bool readData(const char* data, qint64 size, FuelRecordStore& store, QString& errorMessage);
+
+signals:
+    // 按字节进度上报，约每 PROGRESS_STEP 字节一次，结束时必定上报一次
+    void progress(qint64 bytesRead, qint64 totalBytes);
+
+private:
+    struct Span {
+        const char* data = nullptr;
+        int size = 0;
+    };
+
+    // 一条记录的原始字段，date/time 留到结束时统一解析
+    struct RawRecord {
+        QString plateNumber;
+        QString date;
+        QString time;
+        QString fuelType;
+        double amount = 0.0;
+        double longitude = 0.0;
+        double latitude = 0.0;
+        double correctedLongitude = 0.0;
+        double correctedLatitude = 0.0;
+    };
+
+    enum ObjectContext { TopLevel, VehicleElement };
+
+    bool parseObject(ObjectContext context);
+    bool parseVehiclesArray();
+    bool parseRecordsArray(const QString* plateNumber, QList<RawRecord>& pending);
+    bool parseRecordObject(RawRecord& record);
+    bool parseRecordField(const Span& key, RawRecord& record, bool& matched);
+
+    bool readKey(Span& key);
+    bool readString(QString& value);
+    bool readStringOrSkip(QString& value);
+    bool readNumberOrSkip(double& value);
+    bool skipValue();
+    bool skipString();
+    bool peekArray();           // 下一个值是否为数组，不消耗输入
+    bool expect(char c);
+    void skipWhitespace();
+
+    void appendRecord(const RawRecord& record);
+    void reportProgress();
+    bool fail(const QString& message);
+
+    static bool keyIs(const Span& key, const char* literal);
+
+    const char* m_begin = nullptr;
+    const char* m_pos = nullptr;
+    const char* m_end = nullptr;
+    FuelRecordStore* m_store = nullptr;
+    QString m_errorMessage;
+    QByteArray m_keyBuffer;        // 含转义字符的键解码后的暂存
+    qint64 m_nextProgress = 0;
+
+    static constexpr qint64 PROGRESS_STEP = 4 * 1024 * 1024; // 4MB
+};
+
+#endif // FUELJSONSTREAMREADER_H
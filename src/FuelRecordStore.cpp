@@ -0,0 +1,113 @@
+#include "FuelRecordStore.h"
+
+void FuelRecordStore::clear()
+{
+    m_plateColumn.clear();
+    m_timeColumn.clear();
+    m_hasTimeColumn.clear();
+    m_fuelTypeColumn.clear();
+    m_amounts.clear();
+    m_longitudes.clear();
+    m_latitudes.clear();
+    m_correctedLongitudes.clear();
+    m_correctedLatitudes.clear();
+
+    m_plates.clear();
+    m_plateIds.clear();
+    m_fuelTypes.clear();
+
+    m_rowsByPlate.clear();
+    m_rowsByDate.clear();
+
+    m_plateAmounts.clear();
+    m_totalGasoline = 0.0;
+    m_totalDiesel = 0.0;
+}
+
+void FuelRecordStore::reserve(int recordCount)
+{
+    m_plateColumn.reserve(recordCount);
+    m_timeColumn.reserve(recordCount);
+    m_hasTimeColumn.reserve(recordCount);
+    m_fuelTypeColumn.reserve(recordCount);
+    m_amounts.reserve(recordCount);
+    m_longitudes.reserve(recordCount);
+    m_latitudes.reserve(recordCount);
+    m_correctedLongitudes.reserve(recordCount);
+    m_correctedLatitudes.reserve(recordCount);
+}
+
+int FuelRecordStore::addPlate(const QString& plateNumber)
+{
+    auto it = m_plateIds.constFind(plateNumber);
+    if (it != m_plateIds.cend()) {
+        return it.value();
+    }
+
+    int id = m_plates.size();
+    m_plates.append(plateNumber);
+    m_plateIds.insert(plateNumber, id);
+    m_rowsByPlate.append(QVector<int>());
+    m_plateAmounts.append(0.0);
+    return id;
+}
+
+void FuelRecordStore::append(const Record& record)
+{
+    const int row = size();
+    const int plate = addPlate(record.plateNumber);
+
+    int fuelType = m_fuelTypes.indexOf(record.fuelType); // 油品种类很少，线性查找即可
+    if (fuelType < 0) {
+        fuelType = m_fuelTypes.size();
+        m_fuelTypes.append(record.fuelType);
+    }
+
+    m_plateColumn.append(plate);
+    m_timeColumn.append(record.dateTime.isValid() ? record.dateTime.toSecsSinceEpoch() : INVALID_TIME);
+    m_hasTimeColumn.append(record.hasTime);
+    m_fuelTypeColumn.append(fuelType);
+    m_amounts.append(record.amount);
+    m_longitudes.append(record.longitude);
+    m_latitudes.append(record.latitude);
+    m_correctedLongitudes.append(record.correctedLongitude);
+    m_correctedLatitudes.append(record.correctedLatitude);
+
+    m_rowsByPlate[plate].append(row);
+    if (record.dateTime.isValid()) {
+        m_rowsByDate[record.dateTime.date()].append(row);
+    }
+
+    m_plateAmounts[plate] += record.amount;
+    if (record.fuelType == "汽油") {
+        m_totalGasoline += record.amount;
+    } else if (record.fuelType == "柴油") {
+        m_totalDiesel += record.amount;
+    }
+}
+
+FuelRecordStore::Record FuelRecordStore::record(int row) const
+{
+    Record result;
+    result.plateNumber = m_plates.at(m_plateColumn.at(row));
+    if (m_timeColumn.at(row) != INVALID_TIME) {
+        result.dateTime = QDateTime::fromSecsSinceEpoch(m_timeColumn.at(row));
+    }
+    result.hasTime = m_hasTimeColumn.at(row);
+    result.fuelType = m_fuelTypes.at(m_fuelTypeColumn.at(row));
+    result.amount = m_amounts.at(row);
+    result.longitude = m_longitudes.at(row);
+    result.latitude = m_latitudes.at(row);
+    result.correctedLongitude = m_correctedLongitudes.at(row);
+    result.correctedLatitude = m_correctedLatitudes.at(row);
+    return result;
+}
+
+QVector<int> FuelRecordStore::rowsInDateRange(const QDate& from, const QDate& to) const
+{
+    QVector<int> rows;
+    for (auto it = m_rowsByDate.lowerBound(from); it != m_rowsByDate.cend() && it.key() <= to; ++it) {
+        rows += it.value();
+    }
+    return rows;
+}
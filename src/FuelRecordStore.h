@@ -0,0 +1,93 @@
+#ifndef FUELRECORDSTORE_H
+#define FUELRECORDSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QDate>
+#include <QDateTime>
+#include <limits>
+
+/**
+ * @class FuelRecordStore
+ * @brief 卸油记录的列式存储，带车牌/日期索引和增量统计
+ *
+ * 每个字段一列，车牌和油品类型存为整数ID；记录追加时同步维护：
+ * - 车牌ID -> 行号列表、日期 -> 行号列表（有序，可做日期范围查询）
+ * - 每车记录数与卸油量合计、汽油/柴油总量
+ * 因此按车辆/日期取记录是 O(结果数)，统计是 O(1)。
+ */
+class FuelRecordStore
+{
+public:
+    // 单条卸油记录（按行还原的视图）
+    struct Record {
+        QString plateNumber;
+        QDateTime dateTime;           // 由 date + time 字段解析
+        bool hasTime = false;         // 只有日期时 dateTime 为当天零点
+        QString fuelType;             // 汽油 / 柴油
+        double amount = 0.0;          // 吨
+        double longitude = 0.0;       // 原始坐标（WGS84，与轨迹一致）
+        double latitude = 0.0;
+        double correctedLongitude = 0.0; // 偏移纠正后的坐标（地图显示用）
+        double correctedLatitude = 0.0;
+    };
+
+    void clear();
+    void reserve(int recordCount);
+
+    // 登记车牌（允许没有记录的车辆出现在列表中），返回车牌ID
+    int addPlate(const QString& plateNumber);
+    void append(const Record& record);
+
+    int size() const { return m_amounts.size(); }
+    bool isEmpty() const { return m_amounts.isEmpty(); }
+    Record record(int row) const;
+
+    // 车辆
+    int plateCount() const { return m_plates.size(); }
+    int plateId(const QString& plateNumber) const { return m_plateIds.value(plateNumber, -1); }
+    const QString& plateAt(int plateId) const { return m_plates.at(plateId); }
+    const QVector<int>& rowsForPlate(int plateId) const { return m_rowsByPlate.at(plateId); }
+    double plateTotalAmount(int plateId) const { return m_plateAmounts.at(plateId); }
+
+    // 日期
+    QVector<int> rowsForDate(const QDate& date) const { return m_rowsByDate.value(date); }
+    QVector<int> rowsInDateRange(const QDate& from, const QDate& to) const;
+
+    // 统计（加载时增量维护）
+    double totalGasoline() const { return m_totalGasoline; }
+    double totalDiesel() const { return m_totalDiesel; }
+
+private:
+    // 列
+    QVector<int> m_plateColumn;
+    QVector<qint64> m_timeColumn;        // 自纪元起的秒数，无效时间为 INVALID_TIME
+    QVector<bool> m_hasTimeColumn;
+    QVector<int> m_fuelTypeColumn;
+    QVector<double> m_amounts;
+    QVector<double> m_longitudes;
+    QVector<double> m_latitudes;
+    QVector<double> m_correctedLongitudes;
+    QVector<double> m_correctedLatitudes;
+
+    // 字典
+    QStringList m_plates;
+    QHash<QString, int> m_plateIds;
+    QStringList m_fuelTypes;
+
+    // 索引
+    QVector<QVector<int>> m_rowsByPlate;
+    QMap<QDate, QVector<int>> m_rowsByDate;
+
+    // 统计
+    QVector<double> m_plateAmounts;
+    double m_totalGasoline = 0.0;
+    double m_totalDiesel = 0.0;
+
+    static constexpr qint64 INVALID_TIME = std::numeric_limits<qint64>::min();
+};
+
+#endif // FUELRECORDSTORE_H
@@ -0,0 +1,104 @@
+#include "FuelTrajectoryMatcher.h"
+#include <QtMath>
+#include <algorithm>
+
+QList<FuelTrajectoryMatcher::MatchResult> FuelTrajectoryMatcher::matchVehicle(
+    const QList<FuelUnloadingDataLoader::FuelRecord>& records,
+    const QList<ExcelDataReader::VehicleRecord>& sortedTrajectory,
+    const QList<StopDetector::StopEvent>& stops,
+    const Options& options)
+{
+    QList<MatchResult> results;
+    results.reserve(records.size());
+
+    for (const auto& record : records) {
+        if (sortedTrajectory.isEmpty() || !record.dateTime.isValid()) {
+            results.append(unmatched(record));
+            continue;
+        }
+
+        MatchResult result;
+        result.record = record;
+        result.status = NoDataInWindow;
+
+        QDateTime windowStart = record.dateTime.addSecs(-options.timeWindowSecs);
+        QDateTime windowEnd = record.dateTime.addSecs(options.timeWindowSecs);
+        if (!record.hasTime) {
+            windowEnd = windowEnd.addSecs(24 * 3600 - 1);
+        }
+
+        const QGeoCoordinate target(record.latitude, record.longitude);
+
+        // 容差包围盒：匹配成立后，盒外的点不可能更近，直接跳过距离计算；
+        // 尚未匹配时仍需计算，用于报告最近距离
+        const double latDelta = options.toleranceMeters / 110000.0;
+        const double lonDelta = latDelta / qMax(0.01, qCos(qDegreesToRadians(record.latitude)));
+        bool anyInWindow = false;
+
+        auto consider = [&](const QGeoCoordinate& position, const QDateTime& time, bool atStop) {
+            anyInWindow = true;
+            const bool inBox = qAbs(position.latitude() - target.latitude()) <= latDelta &&
+                               qAbs(position.longitude() - target.longitude()) <= lonDelta;
+            if (!inBox && result.status == Matched) {
+                return;
+            }
+            const double distance = target.distanceTo(position);
+            if (result.distanceMeters < 0.0 || distance < result.distanceMeters) {
+                result.distanceMeters = distance;
+                result.nearestTime = time;
+                result.atStop = atStop;
+                if (distance <= options.toleranceMeters) {
+                    result.status = Matched;
+                }
+            }
+        };
+
+        // 轨迹点：二分定位窗口起点，顺序扫描到窗口结束
+        auto pointIt = std::lower_bound(sortedTrajectory.cbegin(), sortedTrajectory.cend(), windowStart,
+                                        [](const ExcelDataReader::VehicleRecord& r, const QDateTime& t) {
+                                            return r.timestamp < t;
+                                        });
+        for (; pointIt != sortedTrajectory.cend() && pointIt->timestamp <= windowEnd; ++pointIt) {
+            consider(pointIt->coordinate(), pointIt->timestamp, false);
+        }
+
+        // 停留：按结束时间二分，取与窗口重叠的停留
+        auto stopIt = std::lower_bound(stops.cbegin(), stops.cend(), windowStart,
+                                       [](const StopDetector::StopEvent& s, const QDateTime& t) {
+                                           return s.endTime < t;
+                                       });
+        for (; stopIt != stops.cend() && stopIt->startTime <= windowEnd; ++stopIt) {
+            consider(stopIt->centroid, stopIt->startTime, true);
+        }
+
+        if (anyInWindow && result.status != Matched) {
+            result.status = TooFar;
+        }
+        results.append(result);
+    }
+
+    return results;
+}
+
+FuelTrajectoryMatcher::MatchResult FuelTrajectoryMatcher::unmatched(const FuelUnloadingDataLoader::FuelRecord& record)
+{
+    MatchResult result;
+    result.record = record;
+    result.status = NoTrajectory;
+    return result;
+}
+
+QString FuelTrajectoryMatcher::statusToString(MatchStatus status)
+{
+    switch (status) {
+    case Matched:
+        return "匹配";
+    case TooFar:
+        return "位置不符";
+    case NoDataInWindow:
+        return "时间窗口内无轨迹";
+    case NoTrajectory:
+        return "无轨迹数据";
+    }
+    return QString();
+}
@@ -0,0 +1,67 @@
+#ifndef FUELTRAJECTORYMATCHER_H
+#define FUELTRAJECTORYMATCHER_H
+
+#include <QList>
+#include <QDateTime>
+#include <QGeoCoordinate>
+#include "ExcelDataReader.h"
+#include "StopDetector.h"
+#include "FuelUnloadingDataLoader.h"
+
+/**
+ * @class FuelTrajectoryMatcher
+ * @brief 卸油记录与车辆轨迹的关联核对
+ *
+ * 对每条卸油记录，在轨迹中查找 [卸油时间 - 窗口, 卸油时间 + 窗口] 内的点，
+ * 取距卸油位置最近的一个判定是否在容差范围内：
+ * - 轨迹按时间排序，窗口起点用二分查找定位，只扫描窗口内的点
+ * - 先用经纬度包围盒粗筛，再计算球面距离
+ * - 同时检查与窗口重叠的停留事件：停车卸油期间的静止点已折叠进停留，
+ *   窗口内可能没有保留的轨迹点
+ *
+ * 只有日期没有时间的记录，窗口扩展为整天。坐标使用原始（WGS84）坐标。
+ */
+class FuelTrajectoryMatcher
+{
+public:
+    enum MatchStatus {
+        Matched,            // 窗口内有轨迹点/停留落在容差内
+        TooFar,             // 窗口内有数据，但最近距离超出容差
+        NoDataInWindow,     // 窗口内没有轨迹点也没有停留
+        NoTrajectory        // 没有该车辆的轨迹
+    };
+
+    struct Options {
+        qint64 timeWindowSecs;
+        double toleranceMeters;
+    };
+
+    struct MatchResult {
+        FuelUnloadingDataLoader::FuelRecord record;
+        MatchStatus status = NoTrajectory;
+        double distanceMeters = -1.0;  // 窗口内最近距离，无数据时为 -1
+        QDateTime nearestTime;         // 最近点的时间（停留取其开始时间）
+        bool atStop = false;           // 最近位置来自停留事件
+    };
+
+    static constexpr qint64 DEFAULT_TIME_WINDOW_SECS = 1800; // 30 分钟
+    static constexpr double DEFAULT_TOLERANCE_METERS = 500.0;
+
+    static Options defaultOptions() { return Options{DEFAULT_TIME_WINDOW_SECS, DEFAULT_TOLERANCE_METERS}; }
+
+    /**
+     * @brief 核对一辆车的卸油记录
+     * @param records 该车辆的卸油记录
+     * @param sortedTrajectory 按时间排序的轨迹（StopDetector::detect 的输出）
+     * @param stops 同一轨迹的停留事件
+     */
+    static QList<MatchResult> matchVehicle(const QList<FuelUnloadingDataLoader::FuelRecord>& records,
+                                           const QList<ExcelDataReader::VehicleRecord>& sortedTrajectory,
+                                           const QList<StopDetector::StopEvent>& stops,
+                                           const Options& options);
+
+    static MatchResult unmatched(const FuelUnloadingDataLoader::FuelRecord& record);
+    static QString statusToString(MatchStatus status);
+};
+
+#endif // FUELTRAJECTORYMATCHER_H
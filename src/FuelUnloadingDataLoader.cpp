@@ -1,12 +1,12 @@
 #include "FuelUnloadingDataLoader.h"
-#include <QFile>
-#include <QJsonParseError>
+#include "FuelJsonStreamReader.h"
 #include <QDebug>
 #include <QStandardPaths>
 #include <QDir>
 
 FuelUnloadingDataLoader::FuelUnloadingDataLoader(QObject *parent)
     : QObject(parent)
+    , m_vehicleModel(new FuelVehicleListModel(&m_store, this))
     , m_isLoaded(false)
 {
     // 自动加载本地数据文件
@@ -18,26 +18,9 @@ bool FuelUnloadingDataLoader::loadFromFile(const QString& filePath)
 {
     clearError();
     
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        setError(QString("无法打开文件: %1").arg(filePath));
-        return false;
-    }
-    
-    QByteArray data = file.readAll();
-    file.close();
-    
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-    
-    if (parseError.error != QJsonParseError::NoError) {
-        setError(QString("JSON解析错误: %1").arg(parseError.errorString()));
-        return false;
-    }
-    
-    bool success = parseJsonData(doc);
+    bool success = loadStream(filePath);
     if (success) {
-        emit dataLoaded(true, QString("成功从文件加载 %1 辆车的数据").arg(m_vehicles.size()));
+        emit dataLoaded(true, QString("成功从文件加载 %1 辆车的数据").arg(m_store.plateCount()));
     }
     
     return success;
@@ -47,80 +30,42 @@ bool FuelUnloadingDataLoader::loadFromResource(const QString& resourcePath)
 {
     clearError();
     
-    QFile file(resourcePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        setError(QString("无法打开资源文件: %1").arg(resourcePath));
-        return false;
-    }
-    
-    QByteArray data = file.readAll();
-    file.close();
-    
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-    
-    if (parseError.error != QJsonParseError::NoError) {
-        setError(QString("JSON解析错误: %1").arg(parseError.errorString()));
-        return false;
-    }
-    
-    bool success = parseJsonData(doc);
+    bool success = loadStream(resourcePath);
     if (success) {
-        emit dataLoaded(true, QString("成功从资源加载 %1 辆车的数据").arg(m_vehicles.size()));
+        emit dataLoaded(true, QString("成功从资源加载 %1 辆车的数据").arg(m_store.plateCount()));
     }
     
     return success;
 }
 
-bool FuelUnloadingDataLoader::parseJsonData(const QJsonDocument& doc)
+bool FuelUnloadingDataLoader::loadStream(const QString& filePath)
 {
-    if (!doc.isObject()) {
-        setError("JSON根节点不是对象");
-        return false;
-    }
-    
-    QJsonObject root = doc.object();
+    // 流式解析到新的存储，失败时保留已加载的数据
+    FuelJsonStreamReader reader;
+    int lastPercentage = -1;
+    connect(&reader, &FuelJsonStreamReader::progress, this,
+            [this, &lastPercentage](qint64 bytesRead, qint64 totalBytes) {
+        int percentage = totalBytes > 0 ? int(bytesRead * 100 / totalBytes) : 100;
+        if (percentage != lastPercentage) {
+            lastPercentage = percentage;
+            emit loadProgress(percentage);
+        }
+    });
     
-    if (!root.contains("vehicles") || !root["vehicles"].isArray()) {
-        setError("JSON中缺少vehicles数组");
+    FuelRecordStore newStore;
+    QString errorMessage;
+    if (!reader.readFile(filePath, newStore, errorMessage)) {
+        setError(errorMessage);
         return false;
     }
     
-    QJsonArray vehiclesArray = root["vehicles"].toArray();
-    QVariantList newVehicles;
-    
-    for (const QJsonValue& vehicleValue : vehiclesArray) {
-        if (!vehicleValue.isObject()) {
-            continue;
-        }
-        
-        QJsonObject vehicleObj = vehicleValue.toObject();
-        QVariantMap vehicle;
-        
-        vehicle["plateNumber"] = vehicleObj["plateNumber"].toString();
-        
-        if (vehicleObj.contains("records") && vehicleObj["records"].isArray()) {
-            QJsonArray recordsArray = vehicleObj["records"].toArray();
-            QVariantList records;
-            
-            for (const QJsonValue& recordValue : recordsArray) {
-                if (recordValue.isObject()) {
-                    records.append(recordToVariant(recordValue.toObject()));
-                }
-            }
-            
-            vehicle["records"] = records;
-        }
-        
-        newVehicles.append(vehicle);
-    }
-    
-    if (newVehicles.isEmpty()) {
+    if (newStore.plateCount() == 0) {
         setError("没有找到有效的车辆数据");
         return false;
     }
     
-    m_vehicles = newVehicles;
+    m_store = std::move(newStore);
+    m_vehicleModel->reload();
     m_isLoaded = true;
     
     emit vehiclesChanged();
@@ -129,81 +74,131 @@ bool FuelUnloadingDataLoader::parseJsonData(const QJsonDocument& doc)
     return true;
 }
 
-QVariantMap FuelUnloadingDataLoader::recordToVariant(const QJsonObject& record)
+QVariantMap FuelUnloadingDataLoader::recordToVariant(int row) const
 {
+    const FuelRecord record = m_store.record(row);
     QVariantMap result;
     
-    result["date"] = record["date"].toString();
-    result["time"] = record["time"].toString();
-    result["fuelType"] = record["fuelType"].toString();
-    result["amount"] = record["amount"].toDouble();
-    result["longitude"] = record["longitude"].toDouble();
-    result["latitude"] = record["latitude"].toDouble();
-    result["correctedLongitude"] = record["correctedLongitude"].toDouble();
-    result["correctedLatitude"] = record["correctedLatitude"].toDouble();
+    result["plateNumber"] = record.plateNumber;
+    result["date"] = record.dateTime.isValid() ? record.dateTime.toString("yyyy-MM-dd") : QString();
+    result["time"] = record.hasTime ? record.dateTime.toString("hh:mm:ss") : QString();
+    result["fuelType"] = record.fuelType;
+    result["amount"] = record.amount;
+    result["longitude"] = record.longitude;
+    result["latitude"] = record.latitude;
+    result["correctedLongitude"] = record.correctedLongitude;
+    result["correctedLatitude"] = record.correctedLatitude;
     
     return result;
 }
 
+QVariantList FuelUnloadingDataLoader::rowsToVariantList(const QVector<int>& rows) const
+{
+    QVariantList result;
+    result.reserve(rows.size());
+    for (int row : rows) {
+        result.append(recordToVariant(row));
+    }
+    return result;
+}
+
 QVariantList FuelUnloadingDataLoader::getAllRecords()
 {
+    // 按车辆顺序输出，同一车辆的记录相邻（标记配色依赖这一点）
     QVariantList allRecords;
+    allRecords.reserve(m_store.size());
     
-    for (const QVariant& vehicleVariant : m_vehicles) {
-        QVariantMap vehicle = vehicleVariant.toMap();
-        QString plateNumber = vehicle["plateNumber"].toString();
-        QVariantList records = vehicle["records"].toList();
-        
-        for (const QVariant& recordVariant : records) {
-            QVariantMap record = recordVariant.toMap();
-            record["plateNumber"] = plateNumber; // 添加车牌号到记录中
-            allRecords.append(record);
+    for (int plateId = 0; plateId < m_store.plateCount(); ++plateId) {
+        for (int row : m_store.rowsForPlate(plateId)) {
+            allRecords.append(recordToVariant(row));
         }
     }
     
     return allRecords;
 }
 
+QVariantList FuelUnloadingDataLoader::getRecordsForVehicle(const QString& plateNumber)
+{
+    int plateId = m_store.plateId(plateNumber);
+    if (plateId < 0) {
+        return QVariantList();
+    }
+    return rowsToVariantList(m_store.rowsForPlate(plateId));
+}
+
+QVariantList FuelUnloadingDataLoader::getRecordsForDate(const QString& date)
+{
+    QDate parsedDate = parseDateTime(date, QString()).date();
+    if (!parsedDate.isValid()) {
+        return QVariantList();
+    }
+    return rowsToVariantList(m_store.rowsForDate(parsedDate));
+}
+
 QVariantMap FuelUnloadingDataLoader::getStatistics()
 {
+    // 统计在加载时增量维护，这里只读取计数
     QVariantMap stats;
     
-    int totalVehicles = m_vehicles.size();
-    int totalRecords = 0;
-    double totalGasoline = 0.0;
-    double totalDiesel = 0.0;
-    
-    for (const QVariant& vehicleVariant : m_vehicles) {
-        QVariantMap vehicle = vehicleVariant.toMap();
-        QVariantList records = vehicle["records"].toList();
-        
-        totalRecords += records.size();
-        
-        for (const QVariant& recordVariant : records) {
-            QVariantMap record = recordVariant.toMap();
-            QString fuelType = record["fuelType"].toString();
-            double amount = record["amount"].toDouble();
-            
-            if (fuelType == "汽油") {
-                totalGasoline += amount;
-            } else if (fuelType == "柴油") {
-                totalDiesel += amount;
-            }
+    stats["totalVehicles"] = m_store.plateCount();
+    stats["totalRecords"] = m_store.size();
+    stats["totalGasoline"] = m_store.totalGasoline();
+    stats["totalDiesel"] = m_store.totalDiesel();
+    stats["totalFuel"] = m_store.totalGasoline() + m_store.totalDiesel();
+    
+    return stats;
+}
+
+bool FuelUnloadingDataLoader::readRecords(const QString& filePath, QList<FuelRecord>& records, QString& errorMessage)
+{
+    records.clear();
+    
+    FuelRecordStore store;
+    FuelJsonStreamReader reader;
+    if (!reader.readFile(filePath, store, errorMessage)) {
+        return false;
+    }
+    
+    if (store.isEmpty()) {
+        errorMessage = "没有找到有效的卸油记录";
+        return false;
+    }
+    
+    records.reserve(store.size());
+    for (int plateId = 0; plateId < store.plateCount(); ++plateId) {
+        for (int row : store.rowsForPlate(plateId)) {
+            records.append(store.record(row));
         }
     }
     
-    stats["totalVehicles"] = totalVehicles;
-    stats["totalRecords"] = totalRecords;
-    stats["totalGasoline"] = totalGasoline;
-    stats["totalDiesel"] = totalDiesel;
-    stats["totalFuel"] = totalGasoline + totalDiesel;
+    return true;
+}
+
+QDateTime FuelUnloadingDataLoader::parseDateTime(const QString& date, const QString& time, bool* hasTime)
+{
+    QDate parsedDate = QDate::fromString(date, "yyyy-MM-dd");
+    if (!parsedDate.isValid()) {
+        parsedDate = QDate::fromString(date, "yyyy/M/d");
+    }
     
-    return stats;
+    QTime parsedTime = QTime::fromString(time, "hh:mm:ss");
+    if (!parsedTime.isValid()) {
+        parsedTime = QTime::fromString(time, "hh:mm");
+    }
+    if (hasTime) {
+        *hasTime = parsedTime.isValid();
+    }
+    if (!parsedTime.isValid()) {
+        parsedTime = QTime(0, 0); // 只有日期时按当天零点处理
+    }
+    
+    return parsedDate.isValid() ? QDateTime(parsedDate, parsedTime) : QDateTime();
 }
 
 void FuelUnloadingDataLoader::clearData()
 {
-    m_vehicles.clear();
+    m_store.clear();
+    m_vehicleModel->reload();
     m_isLoaded = false;
     clearError();
     
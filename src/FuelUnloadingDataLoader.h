@@ -6,24 +6,33 @@
 #include <QVariantMap>
 #include <QQmlEngine>
 #include <QString>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QDateTime>
+#include <QList>
+#include "FuelRecordStore.h"
+#include "FuelVehicleListModel.h"
 
 class FuelUnloadingDataLoader : public QObject
 {
     Q_OBJECT
     QML_ELEMENT
     
-    Q_PROPERTY(QVariantList vehicles READ vehicles NOTIFY vehiclesChanged)
+    Q_PROPERTY(FuelVehicleListModel* vehicles READ vehicles NOTIFY vehiclesChanged)
     Q_PROPERTY(bool isLoaded READ isLoaded NOTIFY isLoadedChanged)
     Q_PROPERTY(QString errorMessage READ errorMessage NOTIFY errorMessageChanged)
     
 public:
+    // 单条卸油记录（类型化，供 C++ 侧分析使用）
+    using FuelRecord = FuelRecordStore::Record;
+    
     explicit FuelUnloadingDataLoader(QObject *parent = nullptr);
     
+    // 读取卸油记录文件（标准 JSON 或 NDJSON）为类型化列表，不依赖 QObject 状态，可在工作线程调用
+    static bool readRecords(const QString& filePath, QList<FuelRecord>& records, QString& errorMessage);
+    static QDateTime parseDateTime(const QString& date, const QString& time, bool* hasTime = nullptr);
+    
     // Property getters
-    QVariantList vehicles() const { return m_vehicles; }
+    FuelVehicleListModel* vehicles() const { return m_vehicleModel; }
+    const FuelRecordStore& store() const { return m_store; }
     bool isLoaded() const { return m_isLoaded; }
     QString errorMessage() const { return m_errorMessage; }
     
@@ -31,6 +40,8 @@ public:
     Q_INVOKABLE bool loadFromFile(const QString& filePath);
     Q_INVOKABLE bool loadFromResource(const QString& resourcePath);
     Q_INVOKABLE QVariantList getAllRecords();
+    Q_INVOKABLE QVariantList getRecordsForVehicle(const QString& plateNumber);
+    Q_INVOKABLE QVariantList getRecordsForDate(const QString& date);
     Q_INVOKABLE QVariantMap getStatistics();
     Q_INVOKABLE void clearData();
     
@@ -39,14 +50,17 @@ signals:
     void isLoadedChanged();
     void errorMessageChanged();
     void dataLoaded(bool success, const QString& message);
+    void loadProgress(int percentage);
     
 private:
-    bool parseJsonData(const QJsonDocument& doc);
-    QVariantMap recordToVariant(const QJsonObject& record);
+    bool loadStream(const QString& filePath);
+    QVariantMap recordToVariant(int row) const;
+    QVariantList rowsToVariantList(const QVector<int>& rows) const;
     void setError(const QString& error);
     void clearError();
     
-    QVariantList m_vehicles;
+    FuelRecordStore m_store;
+    FuelVehicleListModel* m_vehicleModel;
     bool m_isLoaded;
     QString m_errorMessage;
 };
@@ -0,0 +1,54 @@
+#include "FuelVehicleListModel.h"
+#include "FuelRecordStore.h"
+
+FuelVehicleListModel::FuelVehicleListModel(const FuelRecordStore* store, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+{
+    m_rowCount = m_store->plateCount();
+}
+
+int FuelVehicleListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_rowCount;
+}
+
+QVariant FuelVehicleListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount) {
+        return QVariant();
+    }
+
+    const int plateId = index.row();
+    switch (role) {
+    case PlateNumberRole:
+    case Qt::DisplayRole:
+        return m_store->plateAt(plateId);
+    case RecordCountRole:
+        return m_store->rowsForPlate(plateId).size();
+    case TotalAmountRole:
+        return m_store->plateTotalAmount(plateId);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> FuelVehicleListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[PlateNumberRole] = "plateNumber";
+    roles[RecordCountRole] = "recordCount";
+    roles[TotalAmountRole] = "totalAmount";
+    return roles;
+}
+
+void FuelVehicleListModel::reload()
+{
+    beginResetModel();
+    m_rowCount = m_store->plateCount();
+    endResetModel();
+    emit countChanged();
+}
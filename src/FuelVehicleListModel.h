@@ -0,0 +1,45 @@
+#ifndef FUELVEHICLELISTMODEL_H
+#define FUELVEHICLELISTMODEL_H
+
+#include <QAbstractListModel>
+
+class FuelRecordStore;
+
+/**
+ * @class FuelVehicleListModel
+ * @brief 卸油车辆列表模型，直接读取 FuelRecordStore 的车牌字典和每车统计
+ *
+ * 每行一辆车，角色数据按需从存储中取，不再为 QML 复制嵌套的记录列表。
+ */
+class FuelVehicleListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        PlateNumberRole = Qt::UserRole + 1,
+        RecordCountRole,
+        TotalAmountRole
+    };
+
+    explicit FuelVehicleListModel(const FuelRecordStore* store, QObject *parent = nullptr);
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // 存储内容整体替换后调用（重置模型）
+    void reload();
+
+signals:
+    void countChanged();
+
+private:
+    const FuelRecordStore* m_store;
+    int m_rowCount = 0;    // reload() 时更新，保证视图看到的行数与模型重置通知一致
+};
+
+#endif // FUELVEHICLELISTMODEL_H
@@ -0,0 +1,129 @@
+#include "GeocodeCache.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+GeocodeCache::GeocodeCache(const QString &filePath, QObject *parent)
+    : QObject(parent), m_filePath(filePath), m_saveTimer(new QTimer(this)) {
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &GeocodeCache::flush);
+    load();
+}
+
+GeocodeCache::~GeocodeCache() { flush(); }
+
+QString GeocodeCache::defaultFilePath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+           "/geocode_cache.json";
+}
+
+QString GeocodeCache::makeKey(const QString &keyWord, const QString &adminCode) {
+    // 「 北京  站 」与「北京 站」视为同一查询
+    return keyWord.simplified().toCaseFolded() + QLatin1Char('|') + adminCode.trimmed();
+}
+
+bool GeocodeCache::lookup(const QString &key, Entry &entry) const {
+    auto it = m_entries.constFind(key);
+    if (it == m_entries.constEnd())
+        return false;
+    if (isExpired(it.value(), QDateTime::currentSecsSinceEpoch()))
+        return false;
+    entry = it.value();
+    return true;
+}
+
+void GeocodeCache::insert(const QString &key, const Entry &entry) {
+    Entry stored = entry;
+    if (stored.fetchedAt <= 0)
+        stored.fetchedAt = QDateTime::currentSecsSinceEpoch();
+    m_entries.insert(key, stored);
+    scheduleSave();
+}
+
+void GeocodeCache::clear() {
+    m_entries.clear();
+    scheduleSave();
+}
+
+void GeocodeCache::flush() {
+    m_saveTimer->stop();
+    if (!m_dirty || m_filePath.isEmpty())
+        return;
+    m_dirty = false;
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    QJsonObject entries;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (isExpired(it.value(), now))
+            continue;
+        QJsonObject obj;
+        obj["lat"] = it->latitude;
+        obj["lon"] = it->longitude;
+        obj["name"] = it->name;
+        obj["address"] = it->address;
+        obj["fetchedAt"] = static_cast<double>(it->fetchedAt);
+        entries.insert(it.key(), obj);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["entries"] = entries;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write geocode cache:" << m_filePath;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit())
+        qWarning() << "Cannot commit geocode cache:" << m_filePath;
+}
+
+bool GeocodeCache::isExpired(const Entry &entry, qint64 now) const {
+    return m_ttlSecs > 0 && now - entry.fetchedAt > m_ttlSecs;
+}
+
+void GeocodeCache::load() {
+    m_entries.clear();
+    if (m_filePath.isEmpty())
+        return;
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return; // 首次运行没有缓存文件
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "Ignoring invalid geocode cache:" << parseError.errorString();
+        return;
+    }
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const QJsonObject entries = doc.object()["entries"].toObject();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        const QJsonObject obj = it.value().toObject();
+        Entry entry;
+        entry.latitude = obj["lat"].toDouble();
+        entry.longitude = obj["lon"].toDouble();
+        entry.name = obj["name"].toString();
+        entry.address = obj["address"].toString();
+        entry.fetchedAt = static_cast<qint64>(obj["fetchedAt"].toDouble());
+        if (!isExpired(entry, now))
+            m_entries.insert(it.key(), entry);
+    }
+}
+
+void GeocodeCache::scheduleSave() {
+    m_dirty = true;
+    m_saveTimer->start();
+}
@@ -0,0 +1,65 @@
+#ifndef GEOCODE_CACHE_H
+#define GEOCODE_CACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+
+class QTimer;
+
+/**
+ * @brief 地名搜索结果缓存（内存 + 磁盘），供 TiandituGeocoder 使用
+ * - 键为规范化后的 (关键字, 9 位国标码)：关键字去首尾空白、合并连续空白、大小写折叠
+ * - 条目带写入时间，超过 TTL 视为未命中并在下次保存时丢弃
+ * - 构造时从磁盘预热；写入后延迟合并保存（QSaveFile 原子替换），析构时保存未落盘的改动
+ */
+class GeocodeCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        QString name;
+        QString address;
+        qint64 fetchedAt = 0; ///< 写入时间（自纪元起的秒数）
+    };
+
+    /// @param filePath 缓存文件路径，为空时只用内存缓存
+    explicit GeocodeCache(const QString &filePath, QObject *parent = nullptr);
+    ~GeocodeCache();
+
+    static QString defaultFilePath();
+    static QString makeKey(const QString &keyWord, const QString &adminCode);
+
+    bool lookup(const QString &key, Entry &entry) const;
+    void insert(const QString &key, const Entry &entry);
+    void clear();
+
+    /// 条目有效期（秒），默认 30 天
+    void setTimeToLive(qint64 seconds) { m_ttlSecs = seconds; }
+    qint64 timeToLive() const { return m_ttlSecs; }
+
+    int size() const { return m_entries.size(); }
+    QString filePath() const { return m_filePath; }
+
+    /// 立即写盘（有未保存改动时）
+    void flush();
+
+private:
+    bool isExpired(const Entry &entry, qint64 now) const;
+    void load();
+    void scheduleSave();
+
+    QString m_filePath;
+    QHash<QString, Entry> m_entries;
+    qint64 m_ttlSecs = DEFAULT_TTL_SECS;
+    QTimer *m_saveTimer;
+    bool m_dirty = false;
+
+    static constexpr qint64 DEFAULT_TTL_SECS = 30 * 24 * 3600;
+    static constexpr int SAVE_DELAY_MS = 2000; ///< 批量查询时合并多次写盘
+};
+
+#endif // GEOCODE_CACHE_H
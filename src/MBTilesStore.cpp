@@ -0,0 +1,112 @@
+#include "MBTilesStore.h"
+#include "ErrorHandler.h"
+#include <QFileInfo>
+#include <QSqlError>
+#include <QVariant>
+
+MBTilesStore::MBTilesStore()
+    : m_connectionName(QString("mbtiles_%1").arg(reinterpret_cast<quintptr>(this)))
+    , m_format("png")
+    , m_minZoom(DEFAULT_MIN_ZOOM)
+    , m_maxZoom(DEFAULT_MAX_ZOOM)
+{
+}
+
+MBTilesStore::~MBTilesStore()
+{
+    close();
+}
+
+bool MBTilesStore::open(const QString& filePath, QString& errorMessage)
+{
+    close();
+
+    // QSQLITE 打开不存在的文件会新建空库，先检查文件
+    if (!QFileInfo(filePath).isFile()) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "read");
+        return false;
+    }
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(filePath);
+    m_db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if (!m_db.open()) {
+        errorMessage = QString("无法打开瓦片包 %1: %2").arg(filePath, m_db.lastError().text());
+        close();
+        return false;
+    }
+
+    m_tileQuery = QSqlQuery(m_db);
+    if (!m_tileQuery.prepare("SELECT tile_data FROM tiles "
+                             "WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?")) {
+        errorMessage = QString("瓦片包格式无效 %1: %2").arg(filePath, m_tileQuery.lastError().text());
+        close();
+        return false;
+    }
+    m_filePath = filePath;
+
+    const QString format = metadata("format");
+    if (!format.isEmpty()) {
+        m_format = format;
+    }
+    bool ok = false;
+    int zoom = metadata("minzoom").toInt(&ok);
+    if (ok) {
+        m_minZoom = zoom;
+    }
+    zoom = metadata("maxzoom").toInt(&ok);
+    if (ok) {
+        m_maxZoom = zoom;
+    }
+
+    return true;
+}
+
+void MBTilesStore::close()
+{
+    m_tileQuery = QSqlQuery();
+    if (m_db.isValid()) {
+        m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+    m_filePath.clear();
+    m_format = "png";
+    m_minZoom = DEFAULT_MIN_ZOOM;
+    m_maxZoom = DEFAULT_MAX_ZOOM;
+}
+
+QString MBTilesStore::metadata(const QString& name) const
+{
+    if (!m_db.isOpen()) {
+        return QString();
+    }
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT value FROM metadata WHERE name = ?");
+    query.addBindValue(name);
+    if (!query.exec() || !query.next()) {
+        return QString();
+    }
+    return query.value(0).toString();
+}
+
+bool MBTilesStore::readTile(int zoom, int x, int y, QByteArray& data)
+{
+    if (!m_db.isOpen()) {
+        return false;
+    }
+
+    // XYZ -> TMS 行号
+    const int tmsRow = (1 << zoom) - 1 - y;
+    m_tileQuery.bindValue(0, zoom);
+    m_tileQuery.bindValue(1, x);
+    m_tileQuery.bindValue(2, tmsRow);
+    if (!m_tileQuery.exec() || !m_tileQuery.next()) {
+        return false;
+    }
+
+    data = m_tileQuery.value(0).toByteArray();
+    m_tileQuery.finish();
+    return !data.isEmpty();
+}
@@ -0,0 +1,53 @@
+#ifndef MBTILESSTORE_H
+#define MBTILESSTORE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+/**
+ * @class MBTilesStore
+ * @brief 只读访问本地 MBTiles（SQLite）瓦片包
+ *
+ * 对外使用与在线地图一致的 XYZ 行列号（y 自北向南），内部换算为 MBTiles
+ * 规定的 TMS 行号（y 自南向北）。每个实例使用独立的数据库连接，
+ * QSqlDatabase 连接不能跨线程共享，因此实例只能在创建它的线程中使用。
+ */
+class MBTilesStore
+{
+public:
+    MBTilesStore();
+    ~MBTilesStore();
+
+    MBTilesStore(const MBTilesStore&) = delete;
+    MBTilesStore& operator=(const MBTilesStore&) = delete;
+
+    bool open(const QString& filePath, QString& errorMessage);
+    void close();
+    bool isOpen() const { return m_db.isOpen(); }
+    QString filePath() const { return m_filePath; }
+
+    // metadata 表中的键值，缺失时返回空串
+    QString metadata(const QString& name) const;
+    QString format() const { return m_format; }   // png / jpg / webp
+    int minZoom() const { return m_minZoom; }
+    int maxZoom() const { return m_maxZoom; }
+
+    // 读取 XYZ 瓦片，不存在返回 false
+    bool readTile(int zoom, int x, int y, QByteArray& data);
+
+private:
+    QString m_connectionName;
+    QString m_filePath;
+    QSqlDatabase m_db;
+    QSqlQuery m_tileQuery;          // 预编译的瓦片查询，逐瓦片复用
+    QString m_format;
+    int m_minZoom;
+    int m_maxZoom;
+
+    static constexpr int DEFAULT_MIN_ZOOM = 3;  // 与地图的最小/最大缩放级别一致
+    static constexpr int DEFAULT_MAX_ZOOM = 18;
+};
+
+#endif // MBTILESSTORE_H
@@ -4,7 +4,10 @@
 #include "VehicleAnimationEngine.h"
 #include "VehicleDataModel.h"
 #include "ErrorHandler.h"
+#include "FuelTrajectoryMatcher.h"
+#include "Tracer.h"
 #include <QDir>
+#include <QFileInfo>
 #include <QVariantMap>
 #include <QStandardPaths>
 #include <QUrl>
@@ -13,6 +16,7 @@ MainController::MainController(QObject *parent)
     : QObject(parent)
     , m_coordinateConversionEnabled(false)
     , m_isPlaying(false)
+    , m_skipLongStops(false)
     , m_playbackProgress(0.0)
     , m_isLoading(false)
     , m_loadingMessage("")
@@ -21,6 +25,9 @@ MainController::MainController(QObject *parent)
     , m_vehicleManager(new VehicleManager(this))
     , m_animationEngine(new VehicleAnimationEngine(this))
     , m_vehicleDataModel(new VehicleDataModel(this))
+    , m_vehicleListModel(new VehicleListModel(this))
+    , m_tileProvider(new OfflineTileProvider(this))
+    , m_errorHandler(new ErrorHandler(this))
 {
     // Connect FolderScanner signals
     connect(m_folderScanner, &FolderScanner::scanCompleted,
@@ -29,6 +36,8 @@ MainController::MainController(QObject *parent)
             this, &MainController::onFolderScanError);
     connect(m_folderScanner, &FolderScanner::scanProgress,
             this, &MainController::onFolderScanProgress);
+    connect(m_folderScanner, &FolderScanner::vehicleInfoUpdated,
+            this, &MainController::onVehicleInfoPrescanned);
     
     // Connect VehicleManager signals
     connect(m_vehicleManager, &VehicleManager::trajectoryLoaded,
@@ -38,6 +47,18 @@ MainController::MainController(QObject *parent)
     connect(m_vehicleManager, &VehicleManager::loadingProgress,
             this, &MainController::onVehicleLoadingProgress);
     
+    // 各组件的错误经 ErrorHandler 记录（日志、历史、计数），其中一般错误已由组件自己的
+    // errorOccurred 信号提示；这里只把严重错误转发到界面
+    connect(m_errorHandler, &ErrorHandler::errorReported,
+            this, [this](const ErrorHandler::ErrorInfo& error) {
+        if (error.severity == ErrorHandler::Critical) {
+            emit errorOccurred(error.userMessage.isEmpty() ? error.technicalMessage : error.userMessage);
+        }
+    });
+    connect(m_errorHandler, &ErrorHandler::errorsSuppressed, this, [](int count) {
+        qWarning() << "Suppressed" << count << "error notifications in the last second";
+    });
+    
     // Connect VehicleAnimationEngine signals
     connect(m_animationEngine, &VehicleAnimationEngine::currentTimeChanged,
             this, &MainController::onAnimationCurrentTimeChanged);
@@ -50,7 +71,23 @@ MainController::MainController(QObject *parent)
     
     // Set up animation engine with data model
     m_animationEngine->setVehicleModel(m_vehicleDataModel);
-    
+    m_animationEngine->setStopDetector(m_vehicleManager->stopDetector());
+    
+    // 离线瓦片包：配置中指定的文件，未配置时使用程序目录下的 tiles.mbtiles（存在时）
+    QString tilesFile = configManager()->offlineTilesFile();
+    if (tilesFile.isEmpty()) {
+        const QString bundledFile = QCoreApplication::applicationDirPath() + "/tiles.mbtiles";
+        if (QFileInfo::exists(bundledFile)) {
+            tilesFile = bundledFile;
+        }
+    }
+    if (!tilesFile.isEmpty() && !m_tileProvider->openTiles(tilesFile)) {
+        qWarning() << "Offline tiles unavailable:" << tilesFile;
+    }
+    // 更换瓦片包后本地瓦片服务立即改用新包；在线与离线插件之间的切换在下次启动时生效
+    connect(configManager(), &ConfigManager::offlineTilesFileChanged, this, [this]() {
+        m_tileProvider->openTiles(configManager()->offlineTilesFile());
+    });
 }
 
 MainController::~MainController()
@@ -88,22 +125,8 @@ void MainController::clearSearch()
 
 void MainController::updateFilteredVehicleList()
 {
-    if (m_searchText.isEmpty()) {
-        // No search text, show all vehicles
-        m_filteredVehicleList = m_vehicleList;
-    } else {
-        // Simple prefix matching - exactly what user wants
-        m_filteredVehicleList.clear();
-        QString searchText = m_searchText; // Keep original case for exact matching
-        
-        for (const QString& vehicle : m_vehicleList) {
-            if (vehicle.contains(searchText, Qt::CaseInsensitive)) {
-                m_filteredVehicleList.append(vehicle);
-            }
-        }
-    }
-    
-    emit filteredVehicleListChanged();
+    // 索引增量过滤，视图只收到行插入/删除通知
+    m_vehicleListModel->setFilterText(m_searchText);
 }
 
 void MainController::selectFolder(const QString& folderPath)
@@ -125,6 +148,7 @@ void MainController::selectFolder(const QString& folderPath)
         m_vehicleList.clear();
         m_selectedVehicle.clear();
         m_vehicleInfoList.clear();
+        m_vehicleListModel->setVehicles(m_vehicleList);
         emit vehicleListChanged();
         emit selectedVehicleChanged();
         
@@ -274,6 +298,88 @@ QVariantList MainController::getCurrentTrajectory()
     return result;
 }
 
+QVariantList MainController::getTripSummaries()
+{
+    QVariantList result;
+    
+    if (!m_vehicleManager) {
+        return result;
+    }
+    
+    // 行程汇总在加载时已计算好，这里只做 O(行程数) 的转换
+    const auto trips = m_vehicleManager->getTrips();
+    result.reserve(trips.size());
+    for (const auto& trip : trips) {
+        QVariantMap item;
+        item["startIndex"] = trip.startIndex;
+        item["endIndex"] = trip.endIndex;
+        item["startTime"] = trip.startTime;
+        item["endTime"] = trip.endTime;
+        item["durationSecs"] = trip.durationSecs;
+        item["distanceKm"] = trip.distanceKm;
+        item["maxSpeed"] = trip.maxSpeed;
+        item["avgSpeed"] = trip.avgSpeed;
+        item["minLatitude"] = trip.minLatitude;
+        item["maxLatitude"] = trip.maxLatitude;
+        item["minLongitude"] = trip.minLongitude;
+        item["maxLongitude"] = trip.maxLongitude;
+        result.append(item);
+    }
+    
+    return result;
+}
+
+QVariantList MainController::matchFuelRecords(const QVariantList& fuelRecords, int timeWindowMinutes, double toleranceMeters)
+{
+    QVariantList result;
+    
+    if (!m_vehicleManager || m_selectedVehicle.isEmpty()) {
+        return result;
+    }
+    
+    // 只核对当前选中车辆的记录（记录格式同 FuelUnloadingDataLoader::getAllRecords）
+    QList<FuelUnloadingDataLoader::FuelRecord> records;
+    for (const QVariant& value : fuelRecords) {
+        const QVariantMap map = value.toMap();
+        if (map["plateNumber"].toString() != m_selectedVehicle) {
+            continue;
+        }
+        FuelUnloadingDataLoader::FuelRecord record;
+        record.plateNumber = m_selectedVehicle;
+        record.dateTime = FuelUnloadingDataLoader::parseDateTime(map["date"].toString(), map["time"].toString(),
+                                                                 &record.hasTime);
+        record.fuelType = map["fuelType"].toString();
+        record.amount = map["amount"].toDouble();
+        record.longitude = map["longitude"].toDouble();
+        record.latitude = map["latitude"].toDouble();
+        record.correctedLongitude = map["correctedLongitude"].toDouble();
+        record.correctedLatitude = map["correctedLatitude"].toDouble();
+        records.append(record);
+    }
+    
+    // 原始（WGS84）轨迹与停留事件，与卸油记录的原始坐标一致
+    FuelTrajectoryMatcher::Options options{timeWindowMinutes * 60LL, toleranceMeters};
+    const auto matches = FuelTrajectoryMatcher::matchVehicle(records, m_vehicleManager->getCurrentTrajectory(),
+                                                             m_vehicleManager->stopDetector()->stops(), options);
+    
+    result.reserve(matches.size());
+    for (const auto& match : matches) {
+        QVariantMap item;
+        item["plateNumber"] = match.record.plateNumber;
+        item["dateTime"] = match.record.dateTime;
+        item["fuelType"] = match.record.fuelType;
+        item["amount"] = match.record.amount;
+        item["matched"] = match.status == FuelTrajectoryMatcher::Matched;
+        item["status"] = FuelTrajectoryMatcher::statusToString(match.status);
+        item["distanceMeters"] = match.distanceMeters;
+        item["nearestTime"] = match.nearestTime;
+        item["atStop"] = match.atStop;
+        result.append(item);
+    }
+    
+    return result;
+}
+
 void MainController::startPlayback()
 {
     if (m_animationEngine && !m_selectedVehicle.isEmpty()) {
@@ -295,6 +401,17 @@ void MainController::stopPlayback()
     }
 }
 
+void MainController::setSkipLongStops(bool enabled)
+{
+    if (m_skipLongStops != enabled) {
+        m_skipLongStops = enabled;
+        if (m_animationEngine) {
+            m_animationEngine->setSkipLongStops(enabled);
+        }
+        emit skipLongStopsChanged();
+    }
+}
+
 void MainController::setPlaybackSpeed(double speed)
 {
     if (m_animationEngine) {
@@ -321,15 +438,20 @@ QString MainController::getVehicleInfo(const QString& plateNumber)
     for (const auto& info : m_vehicleInfoList) {
         if (info.plateNumber == plateNumber) {
             if (info.firstTimestamp.isValid() && info.lastTimestamp.isValid()) {
-                // 如果有时间信息（已加载过数据）
+                // 如果有时间信息（来自扫描清单或后台预扫描）
                 return QString("Files: %1, Records: %2, Time: %3 - %4")
                        .arg(info.filePaths.size())
                        .arg(info.recordCount)
                        .arg(info.firstTimestamp.toString("yyyy-MM-dd hh:mm"))
                        .arg(info.lastTimestamp.toString("yyyy-MM-dd hh:mm"));
+            } else if (info.isPrescanned()) {
+                // 预扫描完成但未读到时间列
+                return QString("Files: %1, Records: %2")
+                       .arg(info.filePaths.size())
+                       .arg(info.recordCount);
             } else {
-                // 只有文件信息（未加载数据）
-                return QString("Files: %1 (click to load data)")
+                // 只有文件信息（预扫描尚未完成）
+                return QString("Files: %1 (scanning...)")
                        .arg(info.filePaths.size());
             }
         }
@@ -392,8 +514,8 @@ void MainController::onFolderScanCompleted(const QList<FolderScanner::VehicleInf
     // Pass vehicle list to VehicleManager
     m_vehicleManager->setVehicleList(vehicles);
     
-    // Update filtered list
-    updateFilteredVehicleList();
+    // Rebuild search index; current search text is re-applied by the model
+    m_vehicleListModel->setVehicles(m_vehicleList);
     
     // Clear loading state
     m_isLoading = false;
@@ -404,6 +526,8 @@ void MainController::onFolderScanCompleted(const QList<FolderScanner::VehicleInf
     emit vehicleListChanged();
     emit folderScanned(true, QString("成功找到 %1 辆车的数据").arg(vehicles.size()));
     
+    // 后台补全扫描清单中没有的记录数和时间跨度
+    m_folderScanner->startPrescan();
 }
 
 void MainController::onFolderScanError(const QString& error)
@@ -425,6 +549,17 @@ void MainController::onFolderScanProgress(int percentage)
     emit loadingProgress(percentage);
 }
 
+void MainController::onVehicleInfoPrescanned(const FolderScanner::VehicleInfo& info)
+{
+    for (auto& existing : m_vehicleInfoList) {
+        if (existing.plateNumber == info.plateNumber) {
+            existing = info;
+            emit vehicleInfoUpdated(info.plateNumber);
+            return;
+        }
+    }
+}
+
 void MainController::onVehicleTrajectoryLoaded(const QString& plateNumber, 
                                               const QList<ExcelDataReader::VehicleRecord>& trajectory)
 {
@@ -461,6 +596,16 @@ void MainController::onVehicleTrajectoryLoaded(const QString& plateNumber,
             emit trajectoryLoaded(true, "成功加载轨迹数据");
         }
         
+        // 整次加载（所有文件）的校验问题汇总后只提示一次
+        const QString validationSummary = ErrorHandler::handleValidationReport(
+            m_vehicleManager->lastValidationReport(), QString("车辆 %1").arg(plateNumber));
+        if (!validationSummary.isEmpty()) {
+            emit validationReportReady(validationSummary);
+        }
+        
+        // 回放前把轨迹范围内的瓦片从离线瓦片包预取到内存缓存，平移时不等待读取瓦片包
+        m_tileProvider->prefetchRegion(m_vehicleManager->trajectoryBounds());
+        
         // Clear loading state
         m_isLoading = false;
         m_loadingMessage = "";
@@ -493,6 +638,9 @@ void MainController::onTrajectoryConverted(const QString& plateNumber,
         
         emit trajectoryConverted();
         
+        // 坐标转换后轨迹位置偏移，按新的包围盒重新预取
+        m_tileProvider->prefetchRegion(m_vehicleManager->trajectoryBounds());
+        
         // Update vehicle positions after conversion
         if (m_animationEngine) {
             m_animationEngine->updateVehiclePositions();
@@ -623,27 +771,31 @@ int MainController::calculateVisitDays(const QString& plateNumber, double target
         return 0;
     }
     
-    // 目标坐标
-    QGeoCoordinate targetCoord(targetLat, targetLon);
-    
-    // 用于存储到达目标区域的日期
-    QSet<QDate> visitDates;
-    
-    // 遍历轨迹点，检查是否在目标区域内
-    for (const auto& record : trajectory) {
-        QGeoCoordinate currentCoord(record.latitude, record.longitude);
-        
-        // 计算距离（米）
-        double distance = targetCoord.distanceTo(currentCoord);
-        
-        // 如果在指定半径内，记录日期
-        if (distance <= radiusMeters) {
-            QDate visitDate = record.timestamp.date();
-            visitDates.insert(visitDate);
-        }
+    // 统计落在目标半径内的日期数
+    return VehicleManager::countVisitDays(trajectory, m_vehicleManager->trajectoryGrid(),
+                                          *m_vehicleManager->stopDetector(),
+                                          QGeoCoordinate(targetLat, targetLon), radiusMeters);
+}
+
+void MainController::setTracingEnabled(bool enabled)
+{
+    Tracer::setEnabled(enabled);
+}
+
+bool MainController::isTracingEnabled() const
+{
+    return Tracer::isEnabled();
+}
+
+bool MainController::saveTrace(const QString& filePath)
+{
+    QString errorMessage;
+    if (!Tracer::writeChromeTrace(filePath, errorMessage)) {
+        emit errorOccurred(errorMessage);
+        return false;
     }
-    
-    return visitDates.size();
+    Tracer::clear();
+    return true;
 }
 
 QString MainController::getDocumentsPath()
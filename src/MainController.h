@@ -19,10 +19,13 @@
 #include "ExcelDataReader.h"
 #include "VehicleAnimationEngine.h"
 #include "ConfigManager.h"
+#include "VehicleListModel.h"
+#include "OfflineTileProvider.h"
 
 class VehicleManager;
 class VehicleAnimationEngine;
 class VehicleDataModel;
+class ErrorHandler;
 
 class MainController : public QObject
 {
@@ -31,7 +34,7 @@ class MainController : public QObject
     
     Q_PROPERTY(QString currentFolder READ currentFolder NOTIFY currentFolderChanged)
     Q_PROPERTY(QStringList vehicleList READ vehicleList NOTIFY vehicleListChanged)
-    Q_PROPERTY(QStringList filteredVehicleList READ filteredVehicleList NOTIFY filteredVehicleListChanged)
+    Q_PROPERTY(VehicleListModel* vehicleListModel READ vehicleListModel CONSTANT)
     Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY searchTextChanged)
     Q_PROPERTY(QString selectedVehicle READ selectedVehicle NOTIFY selectedVehicleChanged)
     Q_PROPERTY(QDateTime startTime READ startTime NOTIFY timeRangeChanged)
@@ -39,10 +42,12 @@ class MainController : public QObject
     Q_PROPERTY(QDateTime currentTime READ currentTime NOTIFY currentTimeChanged)
     Q_PROPERTY(bool coordinateConversionEnabled READ coordinateConversionEnabled WRITE setCoordinateConversionEnabled NOTIFY coordinateConversionChanged)
     Q_PROPERTY(bool isPlaying READ isPlaying NOTIFY playbackStateChanged)
+    Q_PROPERTY(bool skipLongStops READ skipLongStops WRITE setSkipLongStops NOTIFY skipLongStopsChanged)
     Q_PROPERTY(double playbackProgress READ playbackProgress NOTIFY progressChanged)
     Q_PROPERTY(bool isLoading READ isLoading NOTIFY loadingChanged)
     Q_PROPERTY(QString loadingMessage READ loadingMessage NOTIFY loadingMessageChanged)
     Q_PROPERTY(ConfigManager* configManager READ configManager CONSTANT)
+    Q_PROPERTY(OfflineTileProvider* tileProvider READ tileProvider CONSTANT)
     
 public:
     explicit MainController(QObject *parent = nullptr);
@@ -51,7 +56,7 @@ public:
     // Property getters
     QString currentFolder() const { return m_currentFolder; }
     QStringList vehicleList() const { return m_vehicleList; }
-    QStringList filteredVehicleList() const { return m_filteredVehicleList; }
+    VehicleListModel* vehicleListModel() const { return m_vehicleListModel; }
     QString searchText() const { return m_searchText; }
     QString selectedVehicle() const { return m_selectedVehicle; }
     QDateTime startTime() const { return m_startTime; }
@@ -59,12 +64,22 @@ public:
     QDateTime currentTime() const { return m_currentTime; }
     bool coordinateConversionEnabled() const { return m_coordinateConversionEnabled; }
     bool isPlaying() const { return m_isPlaying; }
+    bool skipLongStops() const { return m_skipLongStops; }
     double playbackProgress() const { return m_playbackProgress; }
     bool isLoading() const { return m_isLoading; }
     QString loadingMessage() const { return m_loadingMessage; }
     ConfigManager* configManager() const { return ConfigManager::GetInstance(); }
+    OfflineTileProvider* tileProvider() const { return m_tileProvider; }
+    
+    // 内部组件，供 PerformanceMonitor 连接信号
+    VehicleManager* vehicleManager() const { return m_vehicleManager; }
+    VehicleAnimationEngine* animationEngine() const { return m_animationEngine; }
+    VehicleDataModel* vehicleDataModel() const { return m_vehicleDataModel; }
+    // 错误汇总，可在工作线程中 reportError；错误经限流后转发为 errorOccurred
+    ErrorHandler* errorHandler() const { return m_errorHandler; }
     // Property setters
     void setCoordinateConversionEnabled(bool enabled);
+    void setSkipLongStops(bool enabled);
     Q_INVOKABLE void setSearchText(const QString& text);
     
     // Invokable methods for QML
@@ -73,6 +88,8 @@ public:
     Q_INVOKABLE void toggleCoordinateConversion();
     Q_INVOKABLE QVariantList getConvertedTrajectory();
     Q_INVOKABLE QVariantList getCurrentTrajectory();
+    Q_INVOKABLE QVariantList getTripSummaries();
+    Q_INVOKABLE QVariantList matchFuelRecords(const QVariantList& fuelRecords, int timeWindowMinutes, double toleranceMeters);
     Q_INVOKABLE void startPlayback();
     Q_INVOKABLE void pausePlayback();
     Q_INVOKABLE void stopPlayback();
@@ -87,11 +104,14 @@ public:
     Q_INVOKABLE int calculateVisitDays(const QString& plateNumber, double targetLat, double targetLon, double radiusMeters);
     Q_INVOKABLE QString getDocumentsPath();
     Q_INVOKABLE void clearSearch();
+    // 耗时追踪：开启后记录热点路径的作用域，saveTrace 写出 Chrome Trace JSON
+    Q_INVOKABLE void setTracingEnabled(bool enabled);
+    Q_INVOKABLE bool isTracingEnabled() const;
+    Q_INVOKABLE bool saveTrace(const QString& filePath);
     
 signals:
     void folderScanned(bool success, const QString& message);
     void vehicleListChanged();
-    void filteredVehicleListChanged();
     void searchTextChanged();
     void selectedVehicleChanged();
     void trajectoryLoaded(bool success, const QString& message);
@@ -101,19 +121,23 @@ signals:
     void currentTimeChanged();
     void coordinateConversionChanged();
     void playbackStateChanged();
+    void skipLongStopsChanged();
     void progressChanged();
     void vehiclePositionUpdated(const QString& plateNumber, 
                                const QGeoCoordinate& position, 
                                int direction, double speed);
     void errorOccurred(const QString& error);
+    void validationReportReady(const QString& summary);  // 每次轨迹加载最多一次，汇总所有文件的数据校验问题
     void loadingProgress(int percentage);
     void loadingChanged();
     void loadingMessageChanged();
+    void vehicleInfoUpdated(const QString& plateNumber);
     
 private slots:
     void onFolderScanCompleted(const QList<FolderScanner::VehicleInfo>& vehicles);
     void onFolderScanError(const QString& error);
     void onFolderScanProgress(int percentage);
+    void onVehicleInfoPrescanned(const FolderScanner::VehicleInfo& info);
     void onVehicleTrajectoryLoaded(const QString& plateNumber, 
                                   const QList<ExcelDataReader::VehicleRecord>& trajectory);
     void onTrajectoryConverted(const QString& plateNumber,
@@ -136,7 +160,6 @@ private:
     // Properties
     QString m_currentFolder;
     QStringList m_vehicleList;
-    QStringList m_filteredVehicleList;
     QString m_searchText;
     QString m_selectedVehicle;
     QDateTime m_startTime;
@@ -144,6 +167,7 @@ private:
     QDateTime m_currentTime;
     bool m_coordinateConversionEnabled;
     bool m_isPlaying;
+    bool m_skipLongStops;
     double m_playbackProgress;
     bool m_isLoading;
     QString m_loadingMessage;
@@ -153,6 +177,9 @@ private:
     VehicleManager* m_vehicleManager;
     VehicleAnimationEngine* m_animationEngine;
     VehicleDataModel* m_vehicleDataModel;
+    VehicleListModel* m_vehicleListModel;   // 带搜索索引的车辆列表
+    OfflineTileProvider* m_tileProvider;    // 离线瓦片，轨迹加载后按包围盒预取
+    ErrorHandler* m_errorHandler;
     
     // Current vehicle info cache
     QList<FolderScanner::VehicleInfo> m_vehicleInfoList;
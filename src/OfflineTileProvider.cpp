@@ -0,0 +1,309 @@
+#include "OfflineTileProvider.h"
+#include "ErrorHandler.h"
+#include <QFileInfo>
+#include <QTcpSocket>
+#include <QMutexLocker>
+#include <QtMath>
+#include <QDebug>
+
+namespace {
+const double MAX_MERCATOR_LATITUDE = 85.05112878;
+const int MAX_TILE_ZOOM = 22;
+}
+
+OfflineTileProvider::OfflineTileProvider(QObject *parent)
+    : QObject(parent)
+    , m_minZoom(0)
+    , m_maxZoom(0)
+    , m_prefetching(false)
+    , m_prefetchProgress(0.0)
+    , m_tileCache(TILE_CACHE_KB)
+{
+    m_prefetchPool.setMaxThreadCount(1);
+
+    connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                handleTileRequests(socket);
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+}
+
+OfflineTileProvider::~OfflineTileProvider()
+{
+    cancelPrefetch();
+    m_prefetchPool.waitForDone();
+}
+
+bool OfflineTileProvider::openTiles(const QString& filePath)
+{
+    cancelPrefetch();
+
+    const QString previousFile = m_tilesFile;
+    m_tilesFile.clear();
+    m_store.close();
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        m_tileCache.clear();
+    }
+
+    bool opened = false;
+    if (!filePath.isEmpty()) {
+        // 服务使用所属线程的连接，预取任务在工作线程中另开连接
+        QString errorMessage;
+        if (!m_store.open(filePath, errorMessage)) {
+            emit errorOccurred(errorMessage);
+        } else if (!m_server.isListening() && !m_server.listen(QHostAddress::LocalHost)) {
+            m_store.close();
+            emit errorOccurred(HANDLE_NETWORK_ERROR("离线瓦片服务", m_server.errorString()));
+        } else {
+            // 端口在进程内保持不变，更换瓦片包后插件仍请求同一地址
+            m_minZoom = m_store.minZoom();
+            m_maxZoom = m_store.maxZoom();
+            m_tilesFile = QFileInfo(filePath).absoluteFilePath();
+            opened = true;
+        }
+    }
+
+    if (previousFile != m_tilesFile) {
+        emit availableChanged();
+    }
+    return opened;
+}
+
+QString OfflineTileProvider::tileUrl() const
+{
+    if (!isAvailable()) {
+        return QString();
+    }
+    return QString("http://127.0.0.1:%1/%z/%x/%y.%2").arg(m_server.serverPort()).arg(m_store.format());
+}
+
+bool OfflineTileProvider::tile(int zoom, int x, int y, QByteArray& data)
+{
+    if (!isAvailable() || zoom < 0 || zoom > MAX_TILE_ZOOM || x < 0 || y < 0 ||
+        x >= (1 << zoom) || y >= (1 << zoom)) {
+        return false;
+    }
+
+    const quint64 key = tileKey(zoom, x, y);
+    if (cachedTile(key, data)) {
+        return true;
+    }
+    if (!m_store.readTile(zoom, x, y, data)) {
+        return false;
+    }
+    cacheTile(key, data);
+    return true;
+}
+
+void OfflineTileProvider::handleTileRequests(QTcpSocket* socket)
+{
+    // 请求行之后的请求头逐行跳过，读到空行时应答；同一连接上的请求依次处理（keep-alive）
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        const QByteArray path = socket->property("tilePath").toByteArray();
+        if (path.isEmpty()) {
+            const QList<QByteArray> parts = line.split(' ');
+            socket->setProperty("tilePath", parts.size() >= 2 ? parts[1] : QByteArray("/"));
+        } else if (line.isEmpty()) {
+            socket->setProperty("tilePath", QVariant());
+            writeTileResponse(socket, path);
+        }
+    }
+}
+
+void OfflineTileProvider::writeTileResponse(QTcpSocket* socket, const QByteArray& path)
+{
+    // 路径形如 /<z>/<x>/<y>.<格式>
+    const QList<QByteArray> parts = path.mid(1).split('/');
+    bool ok = parts.size() == 3;
+    const int zoom = ok ? parts[0].toInt(&ok) : 0;
+    const int x = ok ? parts[1].toInt(&ok) : 0;
+    const int y = ok ? parts[2].left(parts[2].indexOf('.')).toInt(&ok) : 0;
+
+    QByteArray data;
+    if (ok && tile(zoom, x, y, data)) {
+        const QString format = m_store.format();
+        const QByteArray contentType = format == "jpg" ? "image/jpeg" : "image/" + format.toLatin1();
+        socket->write("HTTP/1.1 200 OK\r\nContent-Type: " + contentType +
+                      "\r\nContent-Length: " + QByteArray::number(data.size()) + "\r\n\r\n");
+        socket->write(data);
+    } else {
+        socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+    }
+}
+
+bool OfflineTileProvider::cachedTile(quint64 key, QByteArray& data)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    const QByteArray* cached = m_tileCache.object(key);
+    if (!cached) {
+        return false;
+    }
+    data = *cached;
+    return true;
+}
+
+void OfflineTileProvider::cacheTile(quint64 key, const QByteArray& data)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_tileCache.insert(key, new QByteArray(data), qMax<qsizetype>(1, data.size() / 1024));
+}
+
+quint64 OfflineTileProvider::tileKey(int zoom, int x, int y)
+{
+    return (static_cast<quint64>(zoom) << 56) | (static_cast<quint64>(x) << 28) | static_cast<quint64>(y);
+}
+
+void OfflineTileProvider::prefetchRegion(const QGeoRectangle& bounds)
+{
+    cancelPrefetch();
+    if (!isAvailable() || !bounds.isValid()) {
+        return;
+    }
+
+    PrefetchJob job;
+    job.tilesFile = m_tilesFile;
+    job.minZoom = m_minZoom;
+    job.maxZoom = m_maxZoom;
+    job.generation = m_generation.load();
+
+    // 外扩一圈，回放时车辆靠近边缘也不会等待瓦片
+    const double latitudeMargin = qMax(bounds.height() * PREFETCH_MARGIN, 0.01);
+    const double longitudeMargin = qMax(bounds.width() * PREFETCH_MARGIN, 0.01);
+    job.bounds = QGeoRectangle(
+        QGeoCoordinate(qMin(bounds.topLeft().latitude() + latitudeMargin, MAX_MERCATOR_LATITUDE),
+                       qMax(bounds.topLeft().longitude() - longitudeMargin, -180.0)),
+        QGeoCoordinate(qMax(bounds.bottomRight().latitude() - latitudeMargin, -MAX_MERCATOR_LATITUDE),
+                       qMin(bounds.bottomRight().longitude() + longitudeMargin, 180.0)));
+
+    setPrefetchState(job.generation, true, 0.0);
+    m_prefetchPool.start([this, job]() {
+        runPrefetch(job);
+    });
+}
+
+void OfflineTileProvider::cancelPrefetch()
+{
+    const int generation = ++m_generation;
+    setPrefetchState(generation, false, m_prefetchProgress);
+}
+
+int OfflineTileProvider::longitudeToTileX(double longitude, int zoom)
+{
+    const int tiles = 1 << zoom;
+    const int x = static_cast<int>(std::floor((longitude + 180.0) / 360.0 * tiles));
+    return qBound(0, x, tiles - 1);
+}
+
+int OfflineTileProvider::latitudeToTileY(double latitude, int zoom)
+{
+    const int tiles = 1 << zoom;
+    const double radians = qDegreesToRadians(qBound(-MAX_MERCATOR_LATITUDE, latitude, MAX_MERCATOR_LATITUDE));
+    const double y = (1.0 - std::log(std::tan(radians) + 1.0 / std::cos(radians)) / M_PI) / 2.0 * tiles;
+    return qBound(0, static_cast<int>(std::floor(y)), tiles - 1);
+}
+
+void OfflineTileProvider::runPrefetch(const PrefetchJob& job)
+{
+    MBTilesStore store;
+    QString errorMessage;
+    if (!store.open(job.tilesFile, errorMessage)) {
+        QMetaObject::invokeMethod(this, [this, job, errorMessage]() {
+            setPrefetchState(job.generation, false, 0.0);
+            emit errorOccurred(errorMessage);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    // 从低到高累计各级瓦片数，超过上限的高缩放级别不预取
+    const double north = job.bounds.topLeft().latitude();
+    const double south = job.bounds.bottomRight().latitude();
+    const double west = job.bounds.topLeft().longitude();
+    const double east = job.bounds.bottomRight().longitude();
+
+    qint64 totalTiles = 0;
+    int maxZoom = job.minZoom - 1;
+    for (int zoom = job.minZoom; zoom <= job.maxZoom; ++zoom) {
+        const qint64 columns = longitudeToTileX(east, zoom) - longitudeToTileX(west, zoom) + 1;
+        const qint64 rows = latitudeToTileY(south, zoom) - latitudeToTileY(north, zoom) + 1;
+        if (totalTiles + columns * rows > MAX_PREFETCH_TILES) {
+            break;
+        }
+        totalTiles += columns * rows;
+        maxZoom = zoom;
+    }
+    if (maxZoom < job.maxZoom) {
+        qInfo() << "Tile prefetch limited to zoom" << maxZoom << "for" << totalTiles << "tiles";
+    }
+
+    int processed = 0;
+    int cached = 0;
+    int missing = 0;
+    QByteArray data;
+
+    for (int zoom = job.minZoom; zoom <= maxZoom; ++zoom) {
+        const int x0 = longitudeToTileX(west, zoom);
+        const int x1 = longitudeToTileX(east, zoom);
+        const int y0 = latitudeToTileY(north, zoom);
+        const int y1 = latitudeToTileY(south, zoom);
+
+        for (int x = x0; x <= x1; ++x) {
+            for (int y = y0; y <= y1; ++y) {
+                if (m_generation.load() != job.generation) {
+                    return; // 已被新的预取或关闭取消
+                }
+
+                const quint64 key = tileKey(zoom, x, y);
+                if (!cachedTile(key, data)) {
+                    if (store.readTile(zoom, x, y, data)) {
+                        // 持锁确认未被取消：openTiles 先取消再清空缓存，旧瓦片包的瓦片不会留下
+                        QMutexLocker locker(&m_cacheMutex);
+                        if (m_generation.load() != job.generation) {
+                            return;
+                        }
+                        m_tileCache.insert(key, new QByteArray(data), qMax<qsizetype>(1, data.size() / 1024));
+                        cached++;
+                    } else {
+                        missing++;
+                    }
+                }
+
+                if (++processed % PROGRESS_STEP == 0) {
+                    const double progress = static_cast<double>(processed) / totalTiles;
+                    QMetaObject::invokeMethod(this, [this, job, progress]() {
+                        setPrefetchState(job.generation, true, progress);
+                    }, Qt::QueuedConnection);
+                }
+            }
+        }
+    }
+
+    QMetaObject::invokeMethod(this, [this, job, cached, missing]() {
+        if (m_generation.load() != job.generation) {
+            return;
+        }
+        setPrefetchState(job.generation, false, 1.0);
+        emit prefetchFinished(cached, missing);
+    }, Qt::QueuedConnection);
+}
+
+void OfflineTileProvider::setPrefetchState(int generation, bool running, double progress)
+{
+    // 被取消的任务迟到的进度不再更新界面
+    if (generation != m_generation.load()) {
+        return;
+    }
+
+    if (m_prefetching != running) {
+        m_prefetching = running;
+        emit prefetchingChanged();
+    }
+    if (!qFuzzyCompare(m_prefetchProgress + 1.0, progress + 1.0)) {
+        m_prefetchProgress = progress;
+        emit prefetchProgressChanged();
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef OFFLINETILEPROVIDER_H
+#define OFFLINETILEPROVIDER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QGeoRectangle>
+#include <QThreadPool>
+#include <QTcpServer>
+#include <QCache>
+#include <QMutex>
+#include <atomic>
+#include "MBTilesStore.h"
+
+class QTcpSocket;
+
+/**
+ * @class OfflineTileProvider
+ * @brief 本地 MBTiles 瓦片包作为 Qt Location 地图的离线瓦片源
+ *
+ * Qt Location 的 osm 插件的自定义地图类型（mapId 8）按 osm.mapping.custom.host 给出的
+ * URL 模板（%z/%x/%y）请求瓦片。本类在 127.0.0.1 的随机端口上提供一个只读瓦片服务，
+ * 按请求从瓦片包读取瓦片，瓦片包中没有的返回 404，不访问外网。
+ * 插件每次都实际请求该服务，因此运行中更换瓦片包或预取的瓦片立即生效。
+ *
+ * 后台预取：给定轨迹包围盒（外扩一圈），在工作线程中把瓦片包内覆盖该区域的各级瓦片
+ * 读入内存缓存，回放平移时不必再查询数据库。瓦片数超过上限时舍弃最高的几级，
+ * 保证一次预取有界。新的预取会取消尚未完成的旧预取。
+ *
+ * 瓦片服务在所属线程中应答；缓存由所属线程和预取线程共享，受 m_cacheMutex 保护。
+ */
+class OfflineTileProvider : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool available READ isAvailable NOTIFY availableChanged)
+    Q_PROPERTY(QString tilesFile READ tilesFile NOTIFY availableChanged)
+    Q_PROPERTY(QString tileUrl READ tileUrl NOTIFY availableChanged)
+    Q_PROPERTY(int mapId READ mapId CONSTANT)
+    Q_PROPERTY(bool prefetching READ isPrefetching NOTIFY prefetchingChanged)
+    Q_PROPERTY(double prefetchProgress READ prefetchProgress NOTIFY prefetchProgressChanged)
+
+public:
+    explicit OfflineTileProvider(QObject *parent = nullptr);
+    ~OfflineTileProvider();
+
+    /**
+     * @brief 打开瓦片包并启动本地瓦片服务
+     * @param filePath MBTiles 文件，为空时关闭离线瓦片
+     */
+    Q_INVOKABLE bool openTiles(const QString& filePath);
+
+    bool isAvailable() const { return !m_tilesFile.isEmpty(); }
+    QString tilesFile() const { return m_tilesFile; }
+    // osm.mapping.custom.host 使用的 URL 模板，不可用时为空
+    QString tileUrl() const;
+    int mapId() const { return OSM_CUSTOM_MAP_ID; }
+    bool isPrefetching() const { return m_prefetching; }
+    double prefetchProgress() const { return m_prefetchProgress; }
+
+    // 预取区域内瓦片包的各级瓦片，取消尚未完成的预取
+    Q_INVOKABLE void prefetchRegion(const QGeoRectangle& bounds);
+    Q_INVOKABLE void cancelPrefetch();
+
+    // 读取瓦片（先查缓存），仅所属线程
+    bool tile(int zoom, int x, int y, QByteArray& data);
+
+    // Web 墨卡托瓦片行列号
+    static int longitudeToTileX(double longitude, int zoom);
+    static int latitudeToTileY(double latitude, int zoom);
+
+signals:
+    void availableChanged();
+    void prefetchingChanged();
+    void prefetchProgressChanged();
+    void prefetchFinished(int cached, int missing);
+    void errorOccurred(const QString& error);
+
+private:
+    struct PrefetchJob {
+        QString tilesFile;
+        QGeoRectangle bounds;
+        int minZoom = 0;
+        int maxZoom = 0;
+        int generation = 0;
+    };
+
+    void runPrefetch(const PrefetchJob& job);
+    void setPrefetchState(int generation, bool running, double progress);
+    void handleTileRequests(QTcpSocket* socket);
+    void writeTileResponse(QTcpSocket* socket, const QByteArray& path);
+    bool cachedTile(quint64 key, QByteArray& data);
+    void cacheTile(quint64 key, const QByteArray& data);
+    static quint64 tileKey(int zoom, int x, int y);
+
+    QString m_tilesFile;
+    MBTilesStore m_store;                  // 瓦片服务使用，仅所属线程
+    int m_minZoom;
+    int m_maxZoom;
+    bool m_prefetching;
+    double m_prefetchProgress;
+
+    QTcpServer m_server;
+
+    QMutex m_cacheMutex;
+    QCache<quint64, QByteArray> m_tileCache;   // 开销按 KB 计
+
+    QThreadPool m_prefetchPool;            // 单线程，预取任务依次执行
+    std::atomic<int> m_generation{0};      // 递增即取消旧任务
+
+    static constexpr int OSM_CUSTOM_MAP_ID = 8;          // osm 插件的 "Custom URL Map"
+    static constexpr int MAX_PREFETCH_TILES = 4000;      // 单次预取上限（约 100 MB）
+    static constexpr int TILE_CACHE_KB = 128 * 1024;     // 内存缓存上限
+    static constexpr double PREFETCH_MARGIN = 0.1;       // 包围盒每边外扩比例
+    static constexpr int PROGRESS_STEP = 256;            // 每读取多少个瓦片上报一次进度
+};
+
+#endif // OFFLINETILEPROVIDER_H
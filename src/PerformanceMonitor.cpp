@@ -0,0 +1,141 @@
+#include "PerformanceMonitor.h"
+#include "MainController.h"
+#include "VehicleManager.h"
+#include "VehicleDataModel.h"
+#include "VehicleStateCache.h"
+#include "VehicleAnimationEngine.h"
+#include <QFile>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+PerformanceMonitor::PerformanceMonitor(QObject *parent)
+    : QObject(parent)
+    , m_frameTimes(FRAME_WINDOW, 0)
+{
+    m_sampleTimer.setInterval(SAMPLE_INTERVAL_MS);
+    connect(&m_sampleTimer, &QTimer::timeout, this, &PerformanceMonitor::sample);
+}
+
+void PerformanceMonitor::attach(MainController* controller)
+{
+    if (!controller) {
+        return;
+    }
+
+    connect(controller->animationEngine(), &VehicleAnimationEngine::frameRendered,
+            this, &PerformanceMonitor::recordFrame);
+    connect(controller->animationEngine(), &VehicleAnimationEngine::vehiclePositionUpdated,
+            this, &PerformanceMonitor::recordPosition);
+    connect(controller->vehicleManager(), &VehicleManager::recordsLoaded,
+            this, &PerformanceMonitor::recordLoad);
+    m_stateCache = controller->vehicleDataModel()->stateCache();
+}
+
+void PerformanceMonitor::setActive(bool active)
+{
+    if (active == isActive()) {
+        return;
+    }
+
+    if (active) {
+        // 重新开始计数，避免把关闭期间的累计量算进第一个采样
+        m_framesSinceSample = 0;
+        m_positionsSinceSample = 0;
+        m_sampleClock.start();
+        m_sampleTimer.start();
+        sample();
+    } else {
+        m_sampleTimer.stop();
+    }
+    emit activeChanged();
+}
+
+qint64 PerformanceMonitor::residentMemoryBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return static_cast<qint64>(info.resident_size);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    // /proc/self/statm 第二项为常驻页数
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return 0;
+    }
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+void PerformanceMonitor::recordFrame(qint64 frameNsecs)
+{
+    m_frameTimes[m_frameWriteIndex] = frameNsecs;
+    m_frameWriteIndex = (m_frameWriteIndex + 1) % FRAME_WINDOW;
+    m_frameSampleCount = qMin(m_frameSampleCount + 1, FRAME_WINDOW);
+    m_framesSinceSample++;
+}
+
+void PerformanceMonitor::recordPosition()
+{
+    m_positionsSinceSample++;
+}
+
+void PerformanceMonitor::recordLoad(int rowCount, qint64 elapsedMs)
+{
+    m_lastLoadRows = rowCount;
+    m_rowsPerSecond = rowCount * 1000.0 / qMax<qint64>(elapsedMs, 1);
+    emit metricsChanged();
+}
+
+void PerformanceMonitor::sample()
+{
+    const qint64 elapsedMs = qMax<qint64>(m_sampleClock.restart(), 1);
+    m_framesPerSecond = m_framesSinceSample * 1000.0 / elapsedMs;
+    m_positionsPerSecond = m_positionsSinceSample * 1000.0 / elapsedMs;
+    m_framesSinceSample = 0;
+    m_positionsSinceSample = 0;
+
+    if (m_frameSampleCount > 0) {
+        // 只对已写入的部分排序，1 秒一次，开销可忽略
+        QVector<qint64> frames(m_frameTimes.cbegin(), m_frameTimes.cbegin() + m_frameSampleCount);
+        auto percentile = [&frames](double fraction) {
+            const int index = qMin(static_cast<int>(fraction * frames.size()), frames.size() - 1);
+            std::nth_element(frames.begin(), frames.begin() + index, frames.end());
+            return frames[index] / 1e6;
+        };
+        m_frameTimeP50 = percentile(0.50);
+        m_frameTimeP99 = percentile(0.99);
+    }
+
+    if (m_stateCache) {
+        m_cacheHitRate = m_stateCache->hitRate();
+        m_cacheEntries = m_stateCache->entryCount();
+        m_cacheMemoryMB = m_stateCache->memoryUsed() / (1024.0 * 1024.0);
+    }
+
+    m_residentMemoryMB = residentMemoryBytes() / (1024.0 * 1024.0);
+    emit metricsChanged();
+}
@@ -0,0 +1,103 @@
+#ifndef PERFORMANCEMONITOR_H
+#define PERFORMANCEMONITOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class MainController;
+class VehicleStateCache;
+
+/**
+ * @class PerformanceMonitor
+ * @brief 运行指标汇总，供 MapDisplay 的性能浮层显示
+ *
+ * 每秒采样一次并发出 metricsChanged：
+ * - 动画帧耗时 p50 / p99（最近 FRAME_WINDOW 帧的 updateAnimation 耗时）与实际帧率
+ * - 每秒发出的车辆位置更新数
+ * - 车辆状态缓存命中率、条目数和内存占用（数据模型与动画引擎共用同一个缓存）
+ * - 最近一次轨迹加载的读取速度（行/秒）
+ * - 进程常驻内存（RSS / Windows 工作集）
+ *
+ * 记录接口只做计数和写环形数组，不分配内存；inactive 时停止采样。
+ */
+class PerformanceMonitor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool active READ isActive WRITE setActive NOTIFY activeChanged)
+    Q_PROPERTY(double frameTimeP50 READ frameTimeP50 NOTIFY metricsChanged)
+    Q_PROPERTY(double frameTimeP99 READ frameTimeP99 NOTIFY metricsChanged)
+    Q_PROPERTY(double framesPerSecond READ framesPerSecond NOTIFY metricsChanged)
+    Q_PROPERTY(double positionsPerSecond READ positionsPerSecond NOTIFY metricsChanged)
+    Q_PROPERTY(double cacheHitRate READ cacheHitRate NOTIFY metricsChanged)
+    Q_PROPERTY(int cacheEntries READ cacheEntries NOTIFY metricsChanged)
+    Q_PROPERTY(double cacheMemoryMB READ cacheMemoryMB NOTIFY metricsChanged)
+    Q_PROPERTY(double rowsPerSecond READ rowsPerSecond NOTIFY metricsChanged)
+    Q_PROPERTY(int lastLoadRows READ lastLoadRows NOTIFY metricsChanged)
+    Q_PROPERTY(double residentMemoryMB READ residentMemoryMB NOTIFY metricsChanged)
+
+public:
+    explicit PerformanceMonitor(QObject *parent = nullptr);
+
+    // 连接控制器内部组件的信号（动画帧、位置更新、轨迹加载）
+    void attach(MainController* controller);
+
+    bool isActive() const { return m_sampleTimer.isActive(); }
+    void setActive(bool active);
+
+    double frameTimeP50() const { return m_frameTimeP50; }     // 毫秒
+    double frameTimeP99() const { return m_frameTimeP99; }     // 毫秒
+    double framesPerSecond() const { return m_framesPerSecond; }
+    double positionsPerSecond() const { return m_positionsPerSecond; }
+    double cacheHitRate() const { return m_cacheHitRate; }     // 0.0-1.0
+    int cacheEntries() const { return m_cacheEntries; }
+    double cacheMemoryMB() const { return m_cacheMemoryMB; }
+    double rowsPerSecond() const { return m_rowsPerSecond; }
+    int lastLoadRows() const { return m_lastLoadRows; }
+    double residentMemoryMB() const { return m_residentMemoryMB; }
+
+    // 当前进程常驻内存（字节），不支持的平台返回 0
+    static qint64 residentMemoryBytes();
+
+public slots:
+    void recordFrame(qint64 frameNsecs);
+    void recordPosition();
+    void recordLoad(int rowCount, qint64 elapsedMs);
+
+signals:
+    void activeChanged();
+    void metricsChanged();
+
+private slots:
+    void sample();
+
+private:
+    QPointer<VehicleStateCache> m_stateCache;
+    QTimer m_sampleTimer;
+    QElapsedTimer m_sampleClock;
+
+    // 最近 FRAME_WINDOW 帧的耗时（纳秒），环形写入
+    QVector<qint64> m_frameTimes;
+    int m_frameWriteIndex = 0;
+    int m_frameSampleCount = 0;
+    int m_framesSinceSample = 0;
+    int m_positionsSinceSample = 0;
+
+    double m_frameTimeP50 = 0.0;
+    double m_frameTimeP99 = 0.0;
+    double m_framesPerSecond = 0.0;
+    double m_positionsPerSecond = 0.0;
+    double m_cacheHitRate = 0.0;
+    int m_cacheEntries = 0;
+    double m_cacheMemoryMB = 0.0;
+    double m_rowsPerSecond = 0.0;
+    int m_lastLoadRows = 0;
+    double m_residentMemoryMB = 0.0;
+
+    static constexpr int FRAME_WINDOW = 512;
+    static constexpr int SAMPLE_INTERVAL_MS = 1000;
+};
+
+#endif // PERFORMANCEMONITOR_H
@@ -0,0 +1,133 @@
+#include "PointGrid.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+void PointGrid::build(QVector<double> latitudes, QVector<double> longitudes)
+{
+    clear();
+    if (latitudes.size() != longitudes.size()) {
+        return;
+    }
+    m_latitudes = std::move(latitudes);
+    m_longitudes = std::move(longitudes);
+
+    double minLongitude = std::numeric_limits<double>::max();
+    double minLatitude = std::numeric_limits<double>::max();
+    double maxLongitude = std::numeric_limits<double>::lowest();
+    double maxLatitude = std::numeric_limits<double>::lowest();
+    int indexed = 0;
+    for (int i = 0; i < m_latitudes.size(); ++i) {
+        if (!qIsFinite(m_latitudes[i]) || !qIsFinite(m_longitudes[i])) {
+            continue;
+        }
+        minLongitude = qMin(minLongitude, m_longitudes[i]);
+        minLatitude = qMin(minLatitude, m_latitudes[i]);
+        maxLongitude = qMax(maxLongitude, m_longitudes[i]);
+        maxLatitude = qMax(maxLatitude, m_latitudes[i]);
+        indexed++;
+    }
+    if (indexed == 0) {
+        return;
+    }
+
+    // 平均每格约 POINTS_PER_CELL 个点；离群点撑大范围时由 MAX_CELLS 限制格子总数
+    const double extentArea = qMax((maxLongitude - minLongitude) * (maxLatitude - minLatitude), 1e-9);
+    const int targetCells = qMax(1, indexed / POINTS_PER_CELL);
+    m_cellSize = qBound(MIN_CELL_SIZE, qSqrt(extentArea / targetCells), MAX_CELL_SIZE);
+    m_cellSize = qMax(m_cellSize, qSqrt(extentArea / MAX_CELLS) * 1.01);
+    m_gridMinLongitude = minLongitude;
+    m_gridMinLatitude = minLatitude;
+    m_gridColumns = static_cast<int>((maxLongitude - minLongitude) / m_cellSize) + 1;
+    m_gridRows = static_cast<int>((maxLatitude - minLatitude) / m_cellSize) + 1;
+
+    // 两遍构建压缩存储：先计数，再按下标顺序填充，每个格子内下标升序
+    const int cellCount = m_gridColumns * m_gridRows;
+    QVector<int> cells(m_latitudes.size(), -1);
+    m_cellOffsets.fill(0, cellCount + 1);
+    for (int i = 0; i < m_latitudes.size(); ++i) {
+        if (!qIsFinite(m_latitudes[i]) || !qIsFinite(m_longitudes[i])) {
+            continue;
+        }
+        cells[i] = cellRow(m_latitudes[i]) * m_gridColumns + cellColumn(m_longitudes[i]);
+        m_cellOffsets[cells[i] + 1]++;
+    }
+    for (int c = 0; c < cellCount; ++c) {
+        m_cellOffsets[c + 1] += m_cellOffsets[c];
+    }
+
+    m_cellPoints.resize(m_cellOffsets[cellCount]);
+    QVector<int> cursor(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+    for (int i = 0; i < cells.size(); ++i) {
+        if (cells[i] >= 0) {
+            m_cellPoints[cursor[cells[i]]++] = i;
+        }
+    }
+}
+
+void PointGrid::clear()
+{
+    m_latitudes.clear();
+    m_longitudes.clear();
+    m_gridColumns = 0;
+    m_gridRows = 0;
+    m_cellOffsets.clear();
+    m_cellPoints.clear();
+}
+
+QVector<int> PointGrid::pointsWithin(const QGeoCoordinate& center, double radiusMeters) const
+{
+    QVector<int> result;
+    if (isEmpty() || !center.isValid() || radiusMeters < 0) {
+        return result;
+    }
+
+    // 半径外包框（每度按 110km 取偏大的范围）覆盖的格子
+    const double latDelta = radiusMeters / 110000.0;
+    const double lonDelta = latDelta / qMax(0.01, qCos(qDegreesToRadians(center.latitude())));
+    const double west = center.longitude() - lonDelta;
+    const double east = center.longitude() + lonDelta;
+    const double south = center.latitude() - latDelta;
+    const double north = center.latitude() + latDelta;
+    const double gridEast = m_gridMinLongitude + m_gridColumns * m_cellSize;
+    const double gridNorth = m_gridMinLatitude + m_gridRows * m_cellSize;
+    if (east < m_gridMinLongitude || west > gridEast || north < m_gridMinLatitude || south > gridNorth) {
+        return result;
+    }
+
+    const int column0 = cellColumn(west);
+    const int column1 = cellColumn(east);
+    const int row0 = cellRow(south);
+    const int row1 = cellRow(north);
+    for (int row = row0; row <= row1; ++row) {
+        for (int column = column0; column <= column1; ++column) {
+            const int cell = row * m_gridColumns + column;
+            for (int i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i) {
+                const int point = m_cellPoints[i];
+                if (qAbs(m_latitudes[point] - center.latitude()) > latDelta ||
+                    qAbs(m_longitudes[point] - center.longitude()) > lonDelta) {
+                    continue;
+                }
+                if (center.distanceTo(QGeoCoordinate(m_latitudes[point], m_longitudes[point])) <= radiusMeters) {
+                    result.append(point);
+                }
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+int PointGrid::cellColumn(double longitude) const
+{
+    const double column = std::floor((longitude - m_gridMinLongitude) / m_cellSize);
+    return static_cast<int>(qBound(0.0, column, double(m_gridColumns - 1)));
+}
+
+int PointGrid::cellRow(double latitude) const
+{
+    const double row = std::floor((latitude - m_gridMinLatitude) / m_cellSize);
+    return static_cast<int>(qBound(0.0, row, double(m_gridRows - 1)));
+}
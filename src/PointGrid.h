@@ -0,0 +1,51 @@
+#ifndef POINTGRID_H
+#define POINTGRID_H
+
+#include <QVector>
+#include <QGeoCoordinate>
+
+/**
+ * @class PointGrid
+ * @brief 点集的规则网格空间索引，用于“某位置半径内有哪些点”的查询
+ *
+ * 网格覆盖点集的经纬度范围，格子边长按平均每格 POINTS_PER_CELL 个点估算；
+ * 与 AdminBoundaryIndex 相同采用压缩存储，第 c 个格子的点为
+ * m_cellPoints[m_cellOffsets[c] .. m_cellOffsets[c + 1])。
+ * 查询只检查半径外包框覆盖的格子，再逐点精确计算距离，
+ * 一次建立后可对多个目标位置重复查询。建立后只读，可被多个线程同时查询。
+ */
+class PointGrid
+{
+public:
+    // 按下标建立索引，非有限坐标的点不参与查询
+    void build(QVector<double> latitudes, QVector<double> longitudes);
+    void clear();
+
+    bool isEmpty() const { return m_cellPoints.isEmpty(); }
+    int size() const { return m_latitudes.size(); }
+
+    // 距 center 不超过 radiusMeters 的点的下标，升序
+    QVector<int> pointsWithin(const QGeoCoordinate& center, double radiusMeters) const;
+
+private:
+    int cellColumn(double longitude) const;
+    int cellRow(double latitude) const;
+
+    QVector<double> m_latitudes;
+    QVector<double> m_longitudes;
+
+    double m_gridMinLongitude = 0.0;
+    double m_gridMinLatitude = 0.0;
+    double m_cellSize = 1.0;
+    int m_gridColumns = 0;
+    int m_gridRows = 0;
+    QVector<int> m_cellOffsets;
+    QVector<int> m_cellPoints;
+
+    static constexpr int POINTS_PER_CELL = 16;
+    static constexpr int MAX_CELLS = 1 << 20;
+    static constexpr double MIN_CELL_SIZE = 0.001;  // 约 100 米
+    static constexpr double MAX_CELL_SIZE = 1.0;
+};
+
+#endif // POINTGRID_H
@@ -0,0 +1,129 @@
+#include "StopDetector.h"
+#include <algorithm>
+#include <utility>
+
+StopDetector::StopDetector(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QList<ExcelDataReader::VehicleRecord> StopDetector::detect(
+    const QList<ExcelDataReader::VehicleRecord>& sortedRecords,
+    QList<StopEvent>& stops)
+{
+    QList<ExcelDataReader::VehicleRecord> trajectory;
+    stops.clear();
+    if (sortedRecords.isEmpty()) {
+        return trajectory;
+    }
+
+    trajectory.reserve(sortedRecords.size());
+
+    // 当前静止段：锚点为最后一条保留记录
+    int runLength = 0;            // 锚点之后被折叠的记录数
+    double sumLatitude = 0.0;
+    double sumLongitude = 0.0;
+    QDateTime runEnd;
+
+    auto closeRun = [&]() {
+        if (runLength > 0) {
+            const auto& anchor = trajectory.last();
+            StopEvent stop;
+            stop.startTime = anchor.timestamp;
+            stop.endTime = runEnd;
+            stop.pointCount = runLength + 1;
+            stop.centroid = QGeoCoordinate((sumLatitude + anchor.latitude) / stop.pointCount,
+                                           (sumLongitude + anchor.longitude) / stop.pointCount);
+            stop.trajectoryIndex = trajectory.size() - 1;
+            stops.append(stop);
+        }
+        runLength = 0;
+        sumLatitude = 0.0;
+        sumLongitude = 0.0;
+    };
+
+    // Always include the first record
+    trajectory.append(sortedRecords.first());
+
+    for (int i = 1; i < sortedRecords.size(); ++i) {
+        const auto& currentRecord = sortedRecords[i];
+        const auto& anchor = trajectory.last();
+
+        // Check if vehicle is stationary (speed = 0 and same mileage as the last kept record)
+        bool isStationary = (currentRecord.speed == 0.0) &&
+                            (!currentRecord.totalMileage.isEmpty()) && // Only filter if mileage data exists
+                            (currentRecord.totalMileage == anchor.totalMileage);
+
+        if (isStationary) {
+            runLength++;
+            sumLatitude += currentRecord.latitude;
+            sumLongitude += currentRecord.longitude;
+            runEnd = currentRecord.timestamp;
+        } else {
+            closeRun();
+            trajectory.append(currentRecord);
+        }
+    }
+    closeRun();
+
+    return trajectory;
+}
+
+void StopDetector::setStops(const QList<StopEvent>& stops)
+{
+    m_stops = stops;
+
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    latitudes.reserve(m_stops.size());
+    longitudes.reserve(m_stops.size());
+    for (const auto& stop : m_stops) {
+        latitudes.append(stop.centroid.latitude());
+        longitudes.append(stop.centroid.longitude());
+    }
+    m_centroidGrid.build(std::move(latitudes), std::move(longitudes));
+}
+
+void StopDetector::clear()
+{
+    m_stops.clear();
+    m_centroidGrid.clear();
+}
+
+bool StopDetector::stopAt(const QDateTime& time, StopEvent& stop) const
+{
+    // 第一个开始时间晚于 time 的停留，其前一个是唯一候选
+    auto it = std::upper_bound(m_stops.cbegin(), m_stops.cend(), time,
+                               [](const QDateTime& t, const StopEvent& s) { return t < s.startTime; });
+    if (it == m_stops.cbegin()) {
+        return false;
+    }
+    --it;
+    if (time > it->endTime) {
+        return false;
+    }
+    stop = *it;
+    return true;
+}
+
+QList<StopDetector::StopEvent> StopDetector::stopsInRange(const QDateTime& from, const QDateTime& to) const
+{
+    QList<StopEvent> result;
+
+    // 停留互不重叠且有序，结束时间同样单调
+    auto it = std::lower_bound(m_stops.cbegin(), m_stops.cend(), from,
+                               [](const StopEvent& s, const QDateTime& t) { return s.endTime < t; });
+    for (; it != m_stops.cend() && it->startTime <= to; ++it) {
+        result.append(*it);
+    }
+    return result;
+}
+
+QList<StopDetector::StopEvent> StopDetector::stopsNear(const QGeoCoordinate& center, double radiusMeters) const
+{
+    QList<StopEvent> result;
+    for (int index : m_centroidGrid.pointsWithin(center, radiusMeters)) {
+        result.append(m_stops.at(index));
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+#ifndef STOPDETECTOR_H
+#define STOPDETECTOR_H
+
+#include <QObject>
+#include <QList>
+#include <QDateTime>
+#include <QGeoCoordinate>
+#include "ExcelDataReader.h"
+#include "PointGrid.h"
+
+/**
+ * @class StopDetector
+ * @brief 停留检测：加载时一次线性扫描，把静止记录段合并为停留事件
+ *
+ * 静止判定沿用原过滤规则：速度为0且总里程与上一条保留记录相同。
+ * 静止段的第一条记录（锚点）保留在轨迹中，其余记录只折算进停留事件，
+ * 轨迹点数不变，但停留的起止时间、位置和时长不再丢失。
+ *
+ * 停留事件按开始时间有序，可按时间（二分查找）和位置（停留位置的网格索引）查询，
+ * 供回放跳过长时间停留以及到访天数等统计使用。
+ */
+class StopDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct StopEvent {
+        QDateTime startTime;          // 锚点记录时间
+        QDateTime endTime;            // 最后一条静止记录时间
+        QGeoCoordinate centroid;      // 静止记录的平均位置（原始坐标）
+        int pointCount = 0;           // 静止段的原始记录数（含锚点）
+        int trajectoryIndex = -1;     // 锚点在保留轨迹中的下标
+
+        qint64 durationSecs() const { return startTime.secsTo(endTime); }
+    };
+
+    explicit StopDetector(QObject *parent = nullptr);
+
+    /**
+     * @brief 一次扫描检测停留，返回保留的轨迹点
+     * @param sortedRecords 已按时间排序的原始记录
+     * @param stops 输出：按开始时间排序的停留事件
+     */
+    static QList<ExcelDataReader::VehicleRecord> detect(
+        const QList<ExcelDataReader::VehicleRecord>& sortedRecords,
+        QList<StopEvent>& stops);
+
+    void setStops(const QList<StopEvent>& stops);
+    void clear();
+    const QList<StopEvent>& stops() const { return m_stops; }
+
+    // 查找覆盖指定时间的停留，找到返回 true
+    bool stopAt(const QDateTime& time, StopEvent& stop) const;
+    // 与 [from, to] 有交集的停留
+    QList<StopEvent> stopsInRange(const QDateTime& from, const QDateTime& to) const;
+    // 停留位置在 center 半径内的停留，按开始时间排序
+    QList<StopEvent> stopsNear(const QGeoCoordinate& center, double radiusMeters) const;
+
+private:
+    QList<StopEvent> m_stops;
+    PointGrid m_centroidGrid;     // 下标与 m_stops 一致
+};
+
+#endif // STOPDETECTOR_H
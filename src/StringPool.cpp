@@ -0,0 +1,107 @@
+#include "StringPool.h"
+#include <QHash>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+StringPool::StringPool()
+    : m_slots(INITIAL_CAPACITY, -1)
+{
+}
+
+StringPool& StringPool::plates()
+{
+    static StringPool pool;
+    return pool;
+}
+
+StringPool& StringPool::colors()
+{
+    static StringPool pool;
+    return pool;
+}
+
+int StringPool::intern(QStringView text, QString& interned)
+{
+    text = text.trimmed();
+    if (text.isEmpty()) {
+        interned.clear();
+        return -1;
+    }
+
+    const size_t hash = qHash(text);
+    int slot = 0;
+    {
+        QReadLocker locker(&m_lock);
+        const int id = findSlot(text, hash, slot);
+        if (id >= 0) {
+            interned = m_strings[id];
+            return id;
+        }
+    }
+
+    // 其他线程可能在释放读锁后插入了同一文本，持写锁后重新查找
+    QWriteLocker locker(&m_lock);
+    int id = findSlot(text, hash, slot);
+    if (id < 0) {
+        if ((m_strings.size() + 1) * 2 > m_slots.size()) {
+            rehash(m_slots.size() * 2);
+            findSlot(text, hash, slot);
+        }
+        id = m_strings.size();
+        m_strings.append(text.toString());
+        m_hashes.append(hash);
+        m_slots[slot] = id;
+    }
+    interned = m_strings[id];
+    return id;
+}
+
+int StringPool::find(QStringView text) const
+{
+    text = text.trimmed();
+    if (text.isEmpty()) {
+        return -1;
+    }
+
+    int slot = 0;
+    QReadLocker locker(&m_lock);
+    return findSlot(text, qHash(text), slot);
+}
+
+QString StringPool::string(int id) const
+{
+    QReadLocker locker(&m_lock);
+    return id >= 0 && id < m_strings.size() ? m_strings[id] : QString();
+}
+
+int StringPool::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_strings.size();
+}
+
+int StringPool::findSlot(QStringView text, size_t hash, int& slot) const
+{
+    // 线性探测；负载不超过一半，探测链很短
+    const int mask = m_slots.size() - 1;
+    for (slot = static_cast<int>(hash & mask); m_slots[slot] >= 0; slot = (slot + 1) & mask) {
+        const int id = m_slots[slot];
+        if (m_hashes[id] == hash && m_strings[id] == text) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+void StringPool::rehash(int capacity)
+{
+    m_slots.fill(-1, capacity);
+    const int mask = capacity - 1;
+    for (int id = 0; id < m_strings.size(); ++id) {
+        int slot = static_cast<int>(m_hashes[id] & mask);
+        while (m_slots[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = id;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QReadWriteLock>
+
+/**
+ * @class StringPool
+ * @brief 进程级字符串驻留池：把车牌号、车牌颜色等重复文本映射为从 0 开始的小整数 id
+ *
+ * 百万行轨迹里只有几百个不同的车牌。解析时直接用单元格原文（QStringView，去掉首尾空白）
+ * 计算哈希并在开放寻址表中查找，命中时不分配内存；记录中的 QString 与池中的字符串共享数据。
+ * 下游按车辆分组、过滤时比较 id 即可，不再逐字符比较字符串。
+ *
+ * - id 在进程生命周期内稳定，不同文件、不同读取器得到的 id 一致
+ * - 查找持读锁，首次出现的文本持写锁插入；可在多个解析线程中并发调用
+ * - 池只增不减，只应存放取值有限的字段
+ *
+ * @see ExcelDataReader::VehicleRecord
+ */
+class StringPool
+{
+public:
+    static StringPool& plates();
+    static StringPool& colors();
+
+    /**
+     * @brief 驻留文本
+     * @param text 原始文本，首尾空白不参与比较
+     * @param interned 输出池中的字符串（与池共享数据）；文本为空时输出空字符串
+     * @return id，文本为空时返回 -1
+     */
+    int intern(QStringView text, QString& interned);
+
+    // 已驻留时返回 id，否则返回 -1（不插入）
+    int find(QStringView text) const;
+
+    QString string(int id) const;
+    int size() const;
+
+private:
+    StringPool();
+
+    // 返回 text 的 id（不存在为 -1），slot 输出命中或可插入的槽位
+    int findSlot(QStringView text, size_t hash, int& slot) const;
+    void rehash(int capacity);
+
+    mutable QReadWriteLock m_lock;
+    QVector<QString> m_strings;     // id -> 文本
+    QVector<size_t> m_hashes;       // id -> 哈希，扩容时不必重新计算
+    QVector<int> m_slots;           // 开放寻址表，存放 id，-1 为空槽
+
+    static constexpr int INITIAL_CAPACITY = 256;    // 必须是 2 的幂
+};
+
+#endif // STRINGPOOL_H
@@ -1,22 +1,35 @@
 #include "TiandituGeocoder.h"
+#include "GeocodeCache.h"
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QStringConverter>
-#include <QTextStream>
+#include <QRandomGenerator>
+#include <QTimer>
 #include <QUrlQuery>
+#include <cmath>
+#include <utility>
+
+namespace {
+const char *const kCacheKeyProperty = "geocodeCacheKey";
+}
 
 TiandituGeocoder::TiandituGeocoder(QObject *parent)
-    : QObject(parent), m_network(new QNetworkAccessManager(this)) {
-    loadAdminCodeCsv();
+    : QObject(parent), m_network(new QNetworkAccessManager(this)),
+      m_cache(new GeocodeCache(GeocodeCache::defaultFilePath(), this)),
+      m_serviceUrl(QString::fromLatin1(defaultServiceUrl)), m_batchTimer(new QTimer(this)) {
+    m_batchTimer->setSingleShot(true);
+    connect(m_batchTimer, &QTimer::timeout, this, &TiandituGeocoder::pumpBatch);
+    m_batchClock.start();
+    m_tokens = m_batchOptions.burst;
 }
 
 TiandituGeocoder::~TiandituGeocoder() {
-    if (m_reply) {
-        m_reply->abort();
+    for (QNetworkReply *reply : std::as_const(m_inFlight)) {
+        reply->disconnect(this);
+        reply->abort();
     }
 }
 
@@ -34,39 +47,54 @@ void TiandituGeocoder::searchInAdminRegion(const QString &keyWord,
     }
 
     // 若传入的是行政区名称，查国标码
-    if (code.length() != 9 || !code.at(0).isDigit()) {
-        QString resolved = m_adminNameToCode.value(code);
-        if (resolved.isEmpty())
-            resolved = m_adminNameToCode.value(code + "市");
-        if (resolved.isEmpty())
-            resolved = m_adminNameToCode.value(code + "省");
-        if (resolved.isEmpty())
-            resolved = m_adminNameToCode.value(code + "自治区");
-        if (!resolved.isEmpty())
-            code = resolved;
-        else {
-            emit geocodeFailed(tr("未找到行政区「%1」对应的国标码，请使用 "
-                                  "AdminCode.csv 中的名称或 9 位国标码")
-                                   .arg(code));
-            return;
-        }
+    QString resolved = resolveAdminCode(code);
+    if (resolved.isEmpty()) {
+        emit geocodeFailed(tr("未找到行政区「%1」对应的国标码，请使用 "
+                              "AdminCode.csv 中的名称或 9 位国标码")
+                               .arg(code));
+        return;
     }
+    code = resolved;
 
-    if (m_reply) {
-        m_reply->abort();
-        m_reply = nullptr;
+    const QString key = GeocodeCache::makeKey(kw, code);
+    GeocodeCache::Entry cached;
+    if (m_cache->lookup(key, cached)) {
+        m_currentKey.clear();
+        m_currentWaiters = 0;
+        setBusy(false);
+        emit geocodeSucceeded(cached.latitude, cached.longitude, cached.name, cached.address);
+        return;
     }
 
+    // 结果返回前重复的同一查询共用请求，返回时每次调用各得到一次信号
+    m_currentWaiters = (key == m_currentKey) ? m_currentWaiters + 1 : 1;
+    m_currentKey = key;
+    setBusy(true);
+    if (!m_inFlight.contains(key))
+        startRequest(kw, code, key);
+}
+
+QString TiandituGeocoder::resolveAdminCode(const QString &nameOrCode) const {
+    if (nameOrCode.length() == 9 && nameOrCode.at(0).isDigit())
+        return nameOrCode;
+
+    const AdminRegionIndex &index = adminIndex();
+    const int region = index.resolveName(nameOrCode);
+    return region >= 0 ? index.at(region).code : QString();
+}
+
+void TiandituGeocoder::startRequest(const QString &keyWord, const QString &adminCode,
+                                    const QString &cacheKey) {
     // 1.1 行政区划区域搜索：queryType=12，specify 为 9 位国标码
     QJsonObject postObj;
-    postObj["keyWord"] = kw;
+    postObj["keyWord"] = keyWord;
     postObj["queryType"] = 12;
-    postObj["specify"] = code;
+    postObj["specify"] = adminCode;
     postObj["start"] = 0;
     postObj["count"] = 10;
 
     QByteArray postStr = QJsonDocument(postObj).toJson(QJsonDocument::Compact);
-    QUrl url("https://api.tianditu.gov.cn/v2/search");
+    QUrl url(m_serviceUrl);
     QUrlQuery query;
     query.addQueryItem("postStr", QString::fromUtf8(postStr));
     query.addQueryItem("type", "query");
@@ -75,67 +103,269 @@ void TiandituGeocoder::searchInAdminRegion(const QString &keyWord,
 
     QNetworkRequest req(url);
     req.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    setBusy(true);
-    m_reply = m_network->get(req);
-    connect(m_reply, &QNetworkReply::finished, this,
+    QNetworkReply *reply = m_network->get(req);
+    reply->setProperty(kCacheKeyProperty, cacheKey);
+    m_inFlight.insert(cacheKey, reply);
+    connect(reply, &QNetworkReply::finished, this,
             &TiandituGeocoder::onReplyFinished);
 }
 
-QString TiandituGeocoder::adminCodeForName(const QString &adminName) const {
-    return m_adminNameToCode.value(adminName.trimmed());
+void TiandituGeocoder::geocodeBatch(const QVariantList &queries) {
+    QList<BatchQuery> converted;
+    converted.reserve(queries.size());
+    for (const QVariant &value : queries) {
+        const QVariantMap map = value.toMap();
+        converted.append({map.value("keyWord").toString(), map.value("region").toString()});
+    }
+    geocodeBatch(converted);
 }
 
-QStringList TiandituGeocoder::adminRegionNames() const { return m_adminNames; }
+void TiandituGeocoder::geocodeBatch(const QList<BatchQuery> &queries) {
+    if (queries.isEmpty())
+        return;
+
+    // 先计入总数，避免逐条即时完成时提前发出 batchFinished
+    const int firstIndex = m_batchTotal;
+    const bool wasRunning = isBatchRunning();
+    m_batchTotal += queries.size();
+    if (!wasRunning)
+        emit batchRunningChanged();
+
+    for (int i = 0; i < queries.size() && m_batchTotal > 0; ++i) {
+        BatchJob job;
+        job.index = firstIndex + i;
+        job.keyWord = queries.at(i).keyWord.trimmed();
+        job.adminCode = resolveAdminCode(queries.at(i).region.trimmed());
+        if (job.keyWord.isEmpty() || job.adminCode.isEmpty()) {
+            completeBatchJob(job.index, false, GeocodeCache::Entry(),
+                             job.keyWord.isEmpty() ? tr("请输入搜索关键字")
+                                                   : tr("未找到行政区「%1」对应的国标码")
+                                                         .arg(queries.at(i).region));
+            continue;
+        }
+
+        job.cacheKey = GeocodeCache::makeKey(job.keyWord, job.adminCode);
+        GeocodeCache::Entry cached;
+        if (m_cache->lookup(job.cacheKey, cached)) {
+            completeBatchJob(job.index, true, cached, QString());
+            continue;
+        }
+        m_batchQueue.enqueue(job);
+    }
+
+    pumpBatch();
+}
 
-void TiandituGeocoder::loadAdminCodeCsv() {
-    m_adminNameToCode.clear();
-    m_adminNames.clear();
-    QString path = QCoreApplication::applicationDirPath() + "/AdminCode.csv";
-    if (!QFile::exists(path))
-        path = ":/AdminCode.csv";
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+void TiandituGeocoder::cancelBatch() {
+    if (!isBatchRunning())
         return;
-    QTextStream in(&f);
-    in.setEncoding(QStringConverter::Utf8);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.isEmpty())
+
+    m_batchTimer->stop();
+    m_batchQueue.clear();
+    m_batchWaiters.clear();
+    m_batchTotal = 0;
+    m_batchCompleted = 0;
+    m_batchActive = 0;
+
+    // 交互查询正在等待的请求保留
+    const QSet<QString> owned = std::exchange(m_batchOwned, QSet<QString>());
+    for (const QString &key : owned) {
+        QNetworkReply *reply = m_inFlight.value(key);
+        if (reply && key != m_currentKey)
+            reply->abort();
+    }
+
+    emit batchFinished();
+    emit batchRunningChanged();
+}
+
+void TiandituGeocoder::setBatchOptions(const BatchOptions &options) {
+    m_batchOptions = options;
+    m_batchOptions.maxConcurrent = qMax(1, options.maxConcurrent);
+    m_batchOptions.burst = qMax(1, options.burst);
+    m_tokens = qMin<double>(m_tokens, m_batchOptions.burst);
+    pumpBatch();
+}
+
+void TiandituGeocoder::pumpBatch() {
+    m_batchTimer->stop();
+    const qint64 now = m_batchClock.elapsed();
+    qint64 wakeInMs = -1;
+    auto wakeAt = [&wakeInMs](qint64 delay) {
+        wakeInMs = (wakeInMs < 0) ? delay : qMin(wakeInMs, delay);
+    };
+
+    int i = 0;
+    while (i < m_batchQueue.size()) {
+        const BatchJob &job = m_batchQueue.at(i);
+        if (job.notBefore > now) { // 退避中
+            wakeAt(job.notBefore - now);
+            ++i;
             continue;
-        QStringList parts = line.split(',');
-        if (parts.size() < 3)
+        }
+
+        // 重试等待期间可能已被其他请求写入缓存或正在请求
+        GeocodeCache::Entry cached;
+        if (m_cache->lookup(job.cacheKey, cached)) {
+            const int index = m_batchQueue.takeAt(i).index;
+            completeBatchJob(index, true, cached, QString());
             continue;
-        QString name = parts[0].trimmed();
-        QString gbCode = parts[2].trimmed();
-        if (name.isEmpty() || gbCode.length() != 9)
+        }
+        if (m_inFlight.contains(job.cacheKey)) {
+            const QString key = job.cacheKey;
+            m_batchWaiters[key].append(m_batchQueue.takeAt(i));
             continue;
-        m_adminNameToCode.insert(name, gbCode);
-        m_adminNames.append(name);
+        }
+
+        if (m_batchActive >= m_batchOptions.maxConcurrent)
+            break; // 请求返回时再调度
+
+        refillTokens();
+        if (m_tokens < 1.0) {
+            const double rate = qMax(0.001, m_batchOptions.requestsPerSecond);
+            wakeAt(qint64(std::ceil((1.0 - m_tokens) * 1000.0 / rate)));
+            break;
+        }
+        m_tokens -= 1.0;
+
+        BatchJob started = m_batchQueue.takeAt(i);
+        m_batchOwned.insert(started.cacheKey);
+        m_batchActive++;
+        m_batchWaiters[started.cacheKey].append(started);
+        startRequest(started.keyWord, started.adminCode, started.cacheKey);
+    }
+
+    if (wakeInMs >= 0)
+        m_batchTimer->start(int(qMin<qint64>(wakeInMs, 60000)));
+}
+
+void TiandituGeocoder::refillTokens() {
+    const qint64 now = m_batchClock.elapsed();
+    const double refill = (now - m_tokensUpdatedMs) * m_batchOptions.requestsPerSecond / 1000.0;
+    m_tokens = qMin<double>(m_batchOptions.burst, m_tokens + refill);
+    m_tokensUpdatedMs = now;
+}
+
+void TiandituGeocoder::completeBatchJob(int index, bool success, const GeocodeCache::Entry &entry,
+                                        const QString &errorMessage) {
+    if (m_batchTotal == 0)
+        return; // 已取消
+
+    emit batchResultReady(index, success, entry.latitude, entry.longitude, entry.name,
+                          entry.address, errorMessage);
+    if (m_batchTotal == 0)
+        return; // 在结果处理中被取消
+
+    m_batchCompleted++;
+    emit batchProgress(m_batchCompleted, m_batchTotal);
+    if (m_batchCompleted >= m_batchTotal) {
+        m_batchTotal = 0;
+        m_batchCompleted = 0;
+        emit batchFinished();
+        emit batchRunningChanged();
+    }
+}
+
+bool TiandituGeocoder::isRetryable(QNetworkReply *reply) {
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 429 || status >= 500)
+        return true;
+
+    switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
     }
 }
 
+QString TiandituGeocoder::adminCodeForName(const QString &adminName) const {
+    const AdminRegionIndex &index = adminIndex();
+    const int region = index.indexOfName(adminName.trimmed());
+    return region >= 0 ? index.at(region).code : QString();
+}
+
+const AdminRegionIndex &TiandituGeocoder::adminIndex() const {
+    if (!m_adminIndexRequested) {
+        m_adminIndexRequested = true;
+        QString path = QCoreApplication::applicationDirPath() + "/AdminCode.csv";
+        if (!QFile::exists(path))
+            path = ":/AdminCode.csv";
+        m_adminIndex.load(path);
+    }
+    return m_adminIndex;
+}
+
+void TiandituGeocoder::clearCache() {
+    m_cache->clear();
+    m_cache->flush();
+}
+
 void TiandituGeocoder::onReplyFinished() {
-    setBusy(false);
-    if (!m_reply)
+    auto *reply = qobject_cast<QNetworkReply *>(sender());
+    if (!reply)
         return;
-
-    QNetworkReply *reply = m_reply;
-    m_reply = nullptr;
     reply->deleteLater();
 
+    const QString key = reply->property(kCacheKeyProperty).toString();
+    m_inFlight.remove(key);
+
+    // 被更新的查询取代的请求只写缓存，不发信号
+    const bool isCurrent = (key == m_currentKey);
+    int currentWaiters = 0;
+    if (isCurrent) {
+        m_currentKey.clear();
+        currentWaiters = std::exchange(m_currentWaiters, 0);
+        setBusy(false);
+    }
+
+    const bool ownedByBatch = m_batchOwned.remove(key);
+    if (ownedByBatch)
+        m_batchActive--;
+    const QList<BatchJob> waiters = m_batchWaiters.take(key);
+
+    GeocodeCache::Entry entry;
+    QString errorMessage;
+    bool success = false;
+    bool retryable = false;
     if (reply->error() != QNetworkReply::NoError) {
-        emit geocodeFailed(reply->errorString());
-        return;
+        errorMessage = reply->errorString();
+        retryable = isRetryable(reply);
+    } else if (!parseAdminSearchReply(reply->readAll(), entry.latitude, entry.longitude,
+                                      entry.name, entry.address)) {
+        errorMessage = tr("未找到该地点或解析失败");
+    } else {
+        success = true;
+        m_cache->insert(key, entry);
     }
 
-    QByteArray data = reply->readAll();
-    double lat = 0, lon = 0;
-    QString name, address;
-    if (!parseAdminSearchReply(data, lat, lon, name, address)) {
-        emit geocodeFailed(tr("未找到该地点或解析失败"));
-        return;
+    for (int i = 0; i < currentWaiters; ++i) {
+        if (success)
+            emit geocodeSucceeded(entry.latitude, entry.longitude, entry.name, entry.address);
+        else
+            emit geocodeFailed(errorMessage);
+    }
+
+    for (BatchJob job : waiters) {
+        if (!success && retryable && job.attempts < m_batchOptions.maxRetries) {
+            job.attempts++;
+            const int delay = qMin(m_batchOptions.retryBaseDelayMs << qMin(job.attempts - 1, 10), 30000);
+            job.notBefore = m_batchClock.elapsed() + delay +
+                            QRandomGenerator::global()->bounded(delay / 2 + 1);
+            m_batchQueue.enqueue(job);
+        } else {
+            completeBatchJob(job.index, success, entry, errorMessage);
+        }
     }
-    emit geocodeSucceeded(lat, lon, name, address);
+    if (ownedByBatch || !waiters.isEmpty())
+        pumpBatch();
 }
 
 void TiandituGeocoder::setBusy(bool busy) {
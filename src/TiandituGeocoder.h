@@ -2,15 +2,29 @@
 #define TIANDITU_GEOCODER_H
 
 #include <QObject>
-#include <QPointer>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QGeoCoordinate>
 #include <QHash>
+#include <QSet>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QUrl>
+#include <QVariantList>
+#include "GeocodeCache.h"
+#include "AdminRegionIndex.h"
+
+class QTimer;
 
 /**
  * @brief 天地图地名搜索 V2.0 服务封装
  * - 1.1 行政区划区域搜索服务 (queryType=12)，配合 AdminCode.csv 国标码
+ *   （首次需要时才加载，见 AdminRegionIndex）
+ * - 结果按 (关键字, 国标码) 缓存到内存和磁盘（见 GeocodeCache），启动时预热
+ * - 相同查询在请求未返回前再次发起时复用同一个请求；发起新查询不再中止旧请求，
+ *   旧请求返回后只写入缓存，结果信号只针对最近一次查询发出
+ * - 批量查询：队列 + 并发上限 + 令牌桶限速，网络类错误按指数退避重试，
+ *   每条结果完成即通过 batchResultReady 发出（顺序不保证）
  * @see http://lbs.tianditu.gov.cn/server/search2.html
  */
 class TiandituGeocoder : public QObject
@@ -18,12 +32,27 @@ class TiandituGeocoder : public QObject
     Q_OBJECT
 
     Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
+    Q_PROPERTY(bool batchRunning READ isBatchRunning NOTIFY batchRunningChanged)
 
 public:
+    struct BatchQuery {
+        QString keyWord;
+        QString region; ///< 9 位国标码或 AdminCode.csv 中的行政区名称
+    };
+
+    struct BatchOptions {
+        int maxConcurrent = 4;          ///< 同时进行的请求数
+        double requestsPerSecond = 5.0; ///< 令牌补充速率
+        int burst = 5;                  ///< 令牌桶容量
+        int maxRetries = 3;             ///< 超时/连接失败/429/5xx 的重试次数
+        int retryBaseDelayMs = 500;     ///< 第 n 次重试等待 base * 2^(n-1)（加随机抖动）
+    };
+
     explicit TiandituGeocoder(QObject *parent = nullptr);
     ~TiandituGeocoder();
 
     bool isBusy() const { return m_busy; }
+    bool isBatchRunning() const { return m_batchTotal > 0; }
 
     /// 1.1 行政区划区域搜索：在指定行政区(specify 国标码)内搜索关键字
     /// @param keyWord 搜索关键字（如：商厦、医院）
@@ -33,33 +62,96 @@ public:
     /// 根据行政区名称从 AdminCode.csv 查找国标码，未找到返回空字符串
     Q_INVOKABLE QString adminCodeForName(const QString &adminName) const;
 
-    /// 已加载的行政区名称列表（用于下拉等），按 CSV 顺序
-    Q_INVOKABLE QStringList adminRegionNames() const;
+    /// AdminCode.csv 行政区索引，首次调用时加载（AdminRegionListModel 使用）
+    const AdminRegionIndex &adminIndex() const;
+
+    /// 批量搜索：追加到批处理队列，结果逐条经 batchResultReady 返回
+    /// @param queries 每项为 {keyWord, region} 对象；index 为该项在本轮批处理中的序号
+    Q_INVOKABLE void geocodeBatch(const QVariantList &queries);
+    void geocodeBatch(const QList<BatchQuery> &queries);
+
+    /// 取消尚未完成的批量搜索
+    Q_INVOKABLE void cancelBatch();
+
+    void setBatchOptions(const BatchOptions &options);
+    BatchOptions batchOptions() const { return m_batchOptions; }
+
+    /// 清空内存和磁盘上的搜索结果缓存
+    Q_INVOKABLE void clearCache();
+
+    GeocodeCache *cache() const { return m_cache; }
+
+    /// 搜索服务地址，默认天地图 v2；可指向本地模拟服务做测试
+    void setServiceUrl(const QUrl &url) { m_serviceUrl = url; }
+    QUrl serviceUrl() const { return m_serviceUrl; }
 
     static constexpr const char *defaultKey = "bf8fb9286c23e5b88af5b7a458b49e42";
+    static constexpr const char *defaultServiceUrl = "https://api.tianditu.gov.cn/v2/search";
 
 signals:
     void geocodeSucceeded(double latitude, double longitude, const QString &name, const QString &address);
     void geocodeFailed(const QString &errorMessage);
     void busyChanged();
 
+    void batchResultReady(int index, bool success, double latitude, double longitude,
+                          const QString &name, const QString &address, const QString &errorMessage);
+    void batchProgress(int completed, int total);
+    void batchFinished();
+    void batchRunningChanged();
+
 private slots:
     void onReplyFinished();
 
 private:
+    struct BatchJob {
+        int index = 0;
+        QString keyWord;
+        QString adminCode;
+        QString cacheKey;
+        int attempts = 0;
+        qint64 notBefore = 0; ///< 重试退避：m_batchClock 毫秒
+    };
+
     void setBusy(bool busy);
-    void loadAdminCodeCsv();
+    void pumpBatch();
+    void refillTokens();
+    void completeBatchJob(int index, bool success, const GeocodeCache::Entry &entry,
+                          const QString &errorMessage);
+    static bool isRetryable(QNetworkReply *reply);
+    QString resolveAdminCode(const QString &nameOrCode) const;
+    void startRequest(const QString &keyWord, const QString &adminCode, const QString &cacheKey);
     bool parseAdminSearchReply(const QByteArray &json, double &outLat, double &outLon,
                                QString &outName, QString &outAddress);
     bool parseLonLat(const QString &lonlat, double &outLat, double &outLon);
 
     QNetworkAccessManager *m_network;
-    QPointer<QNetworkReply> m_reply;
+    GeocodeCache *m_cache;
+    QUrl m_serviceUrl;
     bool m_busy = false;
 
-    /// 行政区名称 -> 9 位国标码（来自 AdminCode.csv）
-    QHash<QString, QString> m_adminNameToCode;
-    QStringList m_adminNames;
+    /// 缓存键 -> 进行中的请求（相同查询合并到同一请求）
+    QHash<QString, QNetworkReply *> m_inFlight;
+    /// 最近一次查询的缓存键，其结果才发出信号；为空表示没有等待中的查询
+    QString m_currentKey;
+    /// 等待 m_currentKey 结果的交互查询次数
+    int m_currentWaiters = 0;
+
+    // 批量查询
+    BatchOptions m_batchOptions;
+    QQueue<BatchJob> m_batchQueue;
+    QHash<QString, QList<BatchJob>> m_batchWaiters; ///< 缓存键 -> 等待该请求结果的批量任务
+    QSet<QString> m_batchOwned;                     ///< 由批处理发起、计入并发数的请求
+    int m_batchActive = 0;
+    int m_batchTotal = 0;
+    int m_batchCompleted = 0;
+    double m_tokens = 0.0;
+    qint64 m_tokensUpdatedMs = 0;
+    QElapsedTimer m_batchClock;
+    QTimer *m_batchTimer;
+
+    /// 行政区名称 -> 9 位国标码（来自 AdminCode.csv，延迟加载）
+    mutable AdminRegionIndex m_adminIndex;
+    mutable bool m_adminIndexRequested = false;
 };
 
 #endif // TIANDITU_GEOCODER_H
@@ -0,0 +1,173 @@
+#include "Tracer.h"
+#include "ErrorHandler.h"
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// 单个线程的事件缓冲区：只有所属线程写入，导出时由导出线程读取，锁基本无竞争
+struct ThreadBuffer {
+    QMutex mutex;
+    QVector<TraceEvent> events;
+    int threadId = 0;
+    QString threadName;
+    qint64 dropped = 0;
+};
+
+const std::chrono::steady_clock::time_point s_origin = std::chrono::steady_clock::now();
+
+QMutex s_registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;   // 线程退出后仍保留，直到 clear()
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+
+ThreadBuffer* currentBuffer()
+{
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        QThread* thread = QThread::currentThread();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            buffer->threadName = "main";
+        } else {
+            buffer->threadName = thread->objectName();
+        }
+
+        QMutexLocker locker(&s_registryMutex);
+        buffer->threadId = static_cast<int>(s_buffers.size()) + 1;
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = QString("worker %1").arg(buffer->threadId);
+        }
+        s_buffers.push_back(buffer);
+        t_buffer = buffer;
+    }
+    return t_buffer.get();
+}
+
+void appendJsonString(QByteArray& out, const QByteArray& value)
+{
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+void Tracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&s_registryMutex);
+    for (const auto& buffer : s_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+}
+
+qint64 Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_origin).count();
+}
+
+void Tracer::record(const char* name, qint64 startNs, qint64 endNs)
+{
+    ThreadBuffer* buffer = currentBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= MAX_EVENTS_PER_THREAD) {
+        buffer->dropped++;
+        return;
+    }
+    buffer->events.append(TraceEvent{name, startNs, endNs - startNs});
+}
+
+bool Tracer::writeChromeTrace(const QString& filePath, QString& errorMessage)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "write");
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    QMutexLocker locker(&s_registryMutex);
+    for (const auto& buffer : s_buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        const QByteArray tid = QByteArray::number(buffer->threadId);
+
+        // 线程名元数据
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendJsonString(out, buffer->threadName.toUtf8());
+        out += "}}";
+
+        // 时间单位为微秒，保留三位小数以不丢失纳秒精度
+        for (const TraceEvent& event : buffer->events) {
+            separator();
+            out += "{\"name\":";
+            appendJsonString(out, QByteArray(event.name));
+            out += ",\"cat\":\"carmove\",\"ph\":\"X\",\"ts\":";
+            out += QByteArray::number(event.startNs / 1000.0, 'f', 3);
+            out += ",\"dur\":";
+            out += QByteArray::number(event.durationNs / 1000.0, 'f', 3);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid + "}";
+
+            // 分块写出，避免百万级事件时整体拼接
+            if (out.size() > (4 << 20)) {
+                file.write(out);
+                out.clear();
+            }
+        }
+
+        if (buffer->dropped > 0) {
+            separator();
+            out += "{\"name\":\"dropped_events\",\"ph\":\"C\",\"ts\":0,\"pid\":" + pid +
+                   ",\"tid\":" + tid + ",\"args\":{\"count\":" + QByteArray::number(buffer->dropped) + "}}";
+        }
+    }
+    out += "]}\n";
+    file.write(out);
+
+    if (!file.commit()) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "write");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @class Tracer
+ * @brief 轻量级作用域追踪，导出 Chrome Trace 格式（chrome://tracing / Perfetto 可直接打开）
+ *
+ * 用法：在函数开头写 TRACE_SCOPE("名称")，作用域结束时记录一条完整事件（ph = "X"）。
+ * - 关闭时每个作用域只有一次原子读（relaxed），不取时间、不分配内存
+ * - 每个线程写自己的缓冲区，首次使用时登记；线程退出后缓冲区保留到导出或清空
+ * - 名称必须是字符串字面量（只保存指针）
+ * - 每线程最多保留 MAX_EVENTS_PER_THREAD 条事件，超出的丢弃并在导出时记录丢弃数
+ */
+class Tracer
+{
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // 丢弃所有已记录的事件
+    static void clear();
+
+    // 写出 Chrome Trace JSON（QSaveFile 原子写入）
+    static bool writeChromeTrace(const QString& filePath, QString& errorMessage);
+
+    // 自进程内计时起点的纳秒数
+    static qint64 now();
+    static void record(const char* name, qint64 startNs, qint64 endNs);
+
+    static constexpr int MAX_EVENTS_PER_THREAD = 1 << 20;
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @class TraceScope
+ * @brief TRACE_SCOPE 使用的 RAII 记录器
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(name)
+        , m_startNs(Tracer::isEnabled() ? Tracer::now() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startNs >= 0) {
+            Tracer::record(m_name, m_startNs, Tracer::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    qint64 m_startNs;
+};
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_SCOPE_CONCAT(traceScope_, __LINE__)(name)
+
+#endif // TRACER_H
@@ -0,0 +1,81 @@
+#include "TripSegmenter.h"
+
+QList<TripSegmenter::TripSummary> TripSegmenter::segment(
+    const QList<ExcelDataReader::VehicleRecord>& trajectory,
+    const QList<StopDetector::StopEvent>& stops,
+    qint64 maxGapSecs, qint64 minStopSecs)
+{
+    QList<TripSummary> trips;
+    const int pointCount = trajectory.size();
+    if (pointCount < 2) {
+        return trips;
+    }
+
+    TripSummary current;
+
+    auto beginTrip = [&](int index) {
+        const auto& record = trajectory[index];
+        current = TripSummary();
+        current.startIndex = index;
+        current.startTime = record.timestamp;
+        current.maxSpeed = record.speed;
+        current.minLatitude = current.maxLatitude = record.latitude;
+        current.minLongitude = current.maxLongitude = record.longitude;
+    };
+
+    auto extendTrip = [&](int index) {
+        const auto& record = trajectory[index];
+        current.distanceKm += trajectory[index - 1].coordinate().distanceTo(record.coordinate()) / 1000.0;
+        current.maxSpeed = qMax(current.maxSpeed, record.speed);
+        current.minLatitude = qMin(current.minLatitude, record.latitude);
+        current.maxLatitude = qMax(current.maxLatitude, record.latitude);
+        current.minLongitude = qMin(current.minLongitude, record.longitude);
+        current.maxLongitude = qMax(current.maxLongitude, record.longitude);
+    };
+
+    auto finishTrip = [&](int index) {
+        if (index <= current.startIndex) {
+            return; // 单点不构成行程
+        }
+        current.endIndex = index;
+        current.endTime = trajectory[index].timestamp;
+        current.durationSecs = current.startTime.secsTo(current.endTime);
+        current.avgSpeed = current.durationSecs > 0 ? current.distanceKm * 3600.0 / current.durationSecs : 0.0;
+        trips.append(current);
+    };
+
+    beginTrip(0);
+    int stopCursor = 0;
+
+    for (int i = 1; i < pointCount; ++i) {
+        const int previous = i - 1;
+
+        // 停留事件按锚点下标有序，游标随扫描前进
+        while (stopCursor < stops.size() && stops[stopCursor].trajectoryIndex < previous) {
+            ++stopCursor;
+        }
+        const bool longStop = stopCursor < stops.size() &&
+                              stops[stopCursor].trajectoryIndex == previous &&
+                              stops[stopCursor].durationSecs() >= minStopSecs;
+
+        // 停留期间有数据，断档从停留结束开始计算
+        const QDateTime resumeTime = longStop ? stops[stopCursor].endTime : trajectory[previous].timestamp;
+        const bool dataGap = resumeTime.secsTo(trajectory[i].timestamp) > maxGapSecs;
+
+        if (dataGap) {
+            finishTrip(previous);
+            beginTrip(i);
+        } else if (longStop) {
+            // 新行程从停留结束时出发，时长和均速不计入停留时间
+            finishTrip(previous);
+            beginTrip(previous);
+            current.startTime = resumeTime;
+            extendTrip(i);
+        } else {
+            extendTrip(i);
+        }
+    }
+    finishTrip(pointCount - 1);
+
+    return trips;
+}
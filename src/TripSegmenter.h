@@ -0,0 +1,54 @@
+#ifndef TRIPSEGMENTER_H
+#define TRIPSEGMENTER_H
+
+#include <QList>
+#include <QDateTime>
+#include "ExcelDataReader.h"
+#include "StopDetector.h"
+
+/**
+ * @class TripSegmenter
+ * @brief 行程切分：在已排序、已检测停留的轨迹上一次扫描切分行程并汇总
+ *
+ * 切分规则：
+ * - 长时间停留（不短于 minStopSecs）处结束当前行程，停留点同时作为下一行程的起点，
+ *   下一行程的开始时间取停留结束时间
+ * - 相邻两点（或停留结束到下一点）时间间隔超过 maxGapSecs 时切断，视为数据缺失
+ *
+ * 每个行程只保存汇总值和轨迹下标区间，界面与导出按行程数读取，无需重扫轨迹点。
+ */
+class TripSegmenter
+{
+public:
+    struct TripSummary {
+        int startIndex = 0;           // 在轨迹中的起止下标（含两端）
+        int endIndex = 0;
+        QDateTime startTime;
+        QDateTime endTime;
+        qint64 durationSecs = 0;
+        double distanceKm = 0.0;      // 轨迹点间球面距离累加
+        double maxSpeed = 0.0;
+        double avgSpeed = 0.0;        // 里程 / 时长，km/h
+        double minLatitude = 0.0;     // 包围盒（原始坐标）
+        double maxLatitude = 0.0;
+        double minLongitude = 0.0;
+        double maxLongitude = 0.0;
+
+        int pointCount() const { return endIndex - startIndex + 1; }
+    };
+
+    static constexpr qint64 DEFAULT_MAX_GAP_SECS = 1800;  // 30 分钟无数据视为断开
+    static constexpr qint64 DEFAULT_MIN_STOP_SECS = 300;  // 停留 5 分钟以上结束行程
+
+    /**
+     * @brief 切分行程
+     * @param trajectory StopDetector::detect 输出的轨迹（按时间排序）
+     * @param stops 同一次检测得到的停留事件
+     */
+    static QList<TripSummary> segment(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                      const QList<StopDetector::StopEvent>& stops,
+                                      qint64 maxGapSecs = DEFAULT_MAX_GAP_SECS,
+                                      qint64 minStopSecs = DEFAULT_MIN_STOP_SECS);
+};
+
+#endif // TRIPSEGMENTER_H
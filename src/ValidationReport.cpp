@@ -0,0 +1,166 @@
+#include "ValidationReport.h"
+
+void ValidationReport::beginFile(const QString& fileName)
+{
+    m_files.append(fileName);
+    m_currentFile = m_files.size() - 1;
+}
+
+void ValidationReport::record(Rule rule, int row)
+{
+    RuleStats& stats = m_rules[rule];
+    stats.count++;
+
+    // 行按升序到达，与上一个区间相邻时直接延长
+    if (!stats.ranges.isEmpty()) {
+        RowRange& last = stats.ranges.last();
+        if (last.fileIndex == m_currentFile && last.lastRow + 1 == row) {
+            last.lastRow = row;
+            return;
+        }
+    }
+
+    if (stats.ranges.size() < MAX_RANGES) {
+        stats.ranges.append(RowRange{m_currentFile, row, row});
+    } else {
+        stats.rangesTruncated = true;
+    }
+}
+
+void ValidationReport::addSample(Rule rule, int row, const QString& plateNumber, const QString& detail)
+{
+    if (!needsSample(rule)) {
+        return;
+    }
+    m_rules[rule].samples.append(Sample{m_currentFile, row, plateNumber, detail});
+}
+
+void ValidationReport::merge(const ValidationReport& other)
+{
+    // other 中未调用 beginFile 记录的问题（同一文件的一块数据行）归属本报告的当前文件
+    const int fileOffset = m_files.size();
+    auto mapFile = [this, fileOffset](int fileIndex) {
+        return fileIndex < 0 ? m_currentFile : fileIndex + fileOffset;
+    };
+    m_files.append(other.m_files);
+    m_processedRows += other.m_processedRows;
+
+    for (int rule = 0; rule < RuleCount; ++rule) {
+        RuleStats& stats = m_rules[rule];
+        const RuleStats& otherStats = other.m_rules[rule];
+        stats.count += otherStats.count;
+
+        for (const Sample& sample : otherStats.samples) {
+            if (stats.samples.size() >= MAX_SAMPLES) {
+                break;
+            }
+            Sample remapped = sample;
+            remapped.fileIndex = mapFile(sample.fileIndex);
+            stats.samples.append(remapped);
+        }
+
+        for (const RowRange& range : otherStats.ranges) {
+            const RowRange remapped{mapFile(range.fileIndex), range.firstRow, range.lastRow};
+            // 块边界两侧的连续行合并为一个区间
+            if (!stats.ranges.isEmpty()) {
+                RowRange& last = stats.ranges.last();
+                if (last.fileIndex == remapped.fileIndex && last.lastRow + 1 == remapped.firstRow) {
+                    last.lastRow = remapped.lastRow;
+                    continue;
+                }
+            }
+            if (stats.ranges.size() >= MAX_RANGES) {
+                stats.rangesTruncated = true;
+                break;
+            }
+            stats.ranges.append(remapped);
+        }
+        stats.rangesTruncated = stats.rangesTruncated || otherStats.rangesTruncated;
+    }
+}
+
+void ValidationReport::clear()
+{
+    m_currentFile = -1;
+    m_processedRows = 0;
+    m_files.clear();
+    m_rules = {};
+}
+
+qint64 ValidationReport::totalIssues() const
+{
+    qint64 total = 0;
+    for (const RuleStats& stats : m_rules) {
+        total += stats.count;
+    }
+    return total;
+}
+
+QString ValidationReport::ruleName(Rule rule)
+{
+    switch (rule) {
+        case ParseFailed: return "数据解析失败";
+        case InvalidRecord: return "数据验证失败";
+        case OutOfChinaRange: return "坐标可能不在中国境内";
+        case SpeedTooHigh: return QString("速度超过 %1 km/h").arg(MAX_REASONABLE_SPEED);
+        default: return "未知规则";
+    }
+}
+
+QString ValidationReport::formatSample(const Sample& sample) const
+{
+    QString text = QString("%1 第%2行").arg(m_files.value(sample.fileIndex)).arg(sample.row);
+    if (!sample.plateNumber.isEmpty()) {
+        text += " " + sample.plateNumber;
+    }
+    if (!sample.detail.isEmpty()) {
+        text += "：" + sample.detail;
+    }
+    return text;
+}
+
+QString ValidationReport::formatRanges(Rule rule) const
+{
+    const RuleStats& stats = m_rules[rule];
+    QStringList fileParts;
+    QStringList rowParts;
+    int fileIndex = -1;
+
+    auto flush = [&]() {
+        if (!rowParts.isEmpty()) {
+            fileParts.append(QString("%1 第%2行").arg(m_files.value(fileIndex), rowParts.join("、")));
+            rowParts.clear();
+        }
+    };
+
+    for (const RowRange& range : stats.ranges) {
+        if (range.fileIndex != fileIndex) {
+            flush();
+            fileIndex = range.fileIndex;
+        }
+        rowParts.append(range.firstRow == range.lastRow
+                        ? QString::number(range.firstRow)
+                        : QString("%1-%2").arg(range.firstRow).arg(range.lastRow));
+    }
+    flush();
+
+    QString text = fileParts.join("；");
+    if (stats.rangesTruncated) {
+        text += " 等";
+    }
+    return text;
+}
+
+QStringList ValidationReport::skippedSamples(int maxLines) const
+{
+    QStringList lines;
+    for (Rule rule : {ParseFailed, InvalidRecord}) {
+        for (const Sample& sample : m_rules[rule].samples) {
+            if (lines.size() >= maxLines) {
+                return lines;
+            }
+            lines.append(QString("%1：%2").arg(ruleName(rule), formatSample(sample)));
+        }
+    }
+    return lines;
+}
@@ -0,0 +1,97 @@
+#ifndef VALIDATIONREPORT_H
+#define VALIDATIONREPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <array>
+
+/**
+ * @class ValidationReport
+ * @brief 一次加载的数据校验汇总：按规则计数，保留前若干条示例和出问题的行区间
+ *
+ * 解析循环中每条问题只做一次计数和区间扩展（连续行合并为一个区间），
+ * 示例文本只在示例未满时才由调用方生成，因此大文件中的大量异常行不会拖慢解析。
+ * 多个文件、多个工作线程各自收集后用 merge() 合并，加载结束时由
+ * ErrorHandler::handleValidationReport 统一输出一次。同一文件按块并行解析时，
+ * 每块使用不调用 beginFile 的报告，按块顺序合并到已 beginFile 的报告中。
+ *
+ * @see ExcelDataReader
+ * @see ErrorHandler
+ */
+class ValidationReport
+{
+public:
+    enum Rule {
+        ParseFailed,        // 解析失败（跳过）
+        InvalidRecord,      // 字段超出有效范围（跳过）
+        OutOfChinaRange,    // 坐标不在中国境内（保留）
+        SpeedTooHigh,       // 速度超过 MAX_REASONABLE_SPEED（保留）
+        RuleCount
+    };
+
+    struct Sample {
+        int fileIndex = -1;
+        int row = 0;
+        QString plateNumber;
+        QString detail;
+    };
+
+    // 同一文件内连续出问题的行 [firstRow, lastRow]
+    struct RowRange {
+        int fileIndex = -1;
+        int firstRow = 0;
+        int lastRow = 0;
+    };
+
+    struct RuleStats {
+        qint64 count = 0;
+        QList<Sample> samples;
+        QList<RowRange> ranges;
+        bool rangesTruncated = false;   // 区间数超过 MAX_RANGES 后不再记录
+    };
+
+    // 之后记录的问题都归属该文件
+    void beginFile(const QString& fileName);
+    void addProcessedRows(int rowCount) { m_processedRows += rowCount; }
+
+    // 计数并扩展行区间，不分配内存（除非开启新区间）
+    void record(Rule rule, int row);
+    // 该规则的示例是否未满；为 true 时调用方再生成示例文本
+    bool needsSample(Rule rule) const { return m_rules[rule].samples.size() < MAX_SAMPLES; }
+    void addSample(Rule rule, int row, const QString& plateNumber, const QString& detail);
+
+    // 合并另一份报告（计数相加，示例和区间在上限内追加）；other 中不属于任何文件的
+    // 问题归入本报告的当前文件，与本报告末尾相邻的区间合并为一个
+    void merge(const ValidationReport& other);
+    void clear();
+
+    bool isEmpty() const { return totalIssues() == 0; }
+    qint64 totalIssues() const;
+    qint64 skippedRows() const { return count(ParseFailed) + count(InvalidRecord); }
+    qint64 processedRows() const { return m_processedRows; }
+    int fileCount() const { return m_files.size(); }
+
+    qint64 count(Rule rule) const { return m_rules[rule].count; }
+    const RuleStats& stats(Rule rule) const { return m_rules[rule]; }
+
+    static QString ruleName(Rule rule);
+    // "文件名 第N行 车牌号：详情"
+    QString formatSample(const Sample& sample) const;
+    // "a.xlsx 第12-40、55行；b.xlsx 第3行"
+    QString formatRanges(Rule rule) const;
+    // 跳过行的示例，用于没有有效数据时的错误消息
+    QStringList skippedSamples(int maxLines) const;
+
+    static constexpr int MAX_SAMPLES = 5;
+    static constexpr int MAX_RANGES = 64;
+    static constexpr double MAX_REASONABLE_SPEED = 300.0;   // km/h
+
+private:
+    int m_currentFile = -1;
+    qint64 m_processedRows = 0;
+    QStringList m_files;
+    std::array<RuleStats, RuleCount> m_rules;
+};
+
+#endif // VALIDATIONREPORT_H
@@ -1,4 +1,6 @@
 #include "VehicleAnimationEngine.h"
+#include "Tracer.h"
+#include "VehicleStateCache.h"
 #include <QtMath>
 #include <algorithm>
 
@@ -6,7 +8,6 @@ VehicleAnimationEngine::VehicleAnimationEngine(QObject *parent)
     : QObject(parent)
     , m_vehicleModel(nullptr)
     , m_animationTimer(new QTimer(this))
-    , m_cacheCleanupTimer(new QTimer(this))
     , m_playbackState(Stopped)
     , m_playbackSpeed(1.0)
     , m_currentProgress(0.0)
@@ -15,12 +16,6 @@ VehicleAnimationEngine::VehicleAnimationEngine(QObject *parent)
     updateTimerInterval();
     connect(m_animationTimer, &QTimer::timeout, this, &VehicleAnimationEngine::updateAnimation);
     
-    // Set up cache cleanup timer
-    m_cacheCleanupTimer->setInterval(30000); // Clean cache every 30 seconds
-    m_cacheCleanupTimer->setSingleShot(false);
-    connect(m_cacheCleanupTimer, &QTimer::timeout, this, &VehicleAnimationEngine::cleanupCache);
-    m_cacheCleanupTimer->start();
-    
     // Initialize frame timer
     m_frameTimer.start();
 }
@@ -33,8 +28,7 @@ void VehicleAnimationEngine::setVehicleModel(VehicleDataModel* model)
         m_endTime = model->getEndTime();
         m_currentTime = m_startTime;
         
-        // Clear cache when model changes
-        m_vehicleStateCache.clear();
+        // Cached states are owned by the model and reset with its data
         m_lastKnownPositions.clear();
         
         // Emit initial time change to update UI
@@ -135,10 +129,19 @@ void VehicleAnimationEngine::setDraggingMode(bool isDragging)
 
 void VehicleAnimationEngine::updateAnimation()
 {
+    TRACE_SCOPE("VehicleAnimationEngine::updateAnimation");
     if (m_playbackState != Playing || !m_vehicleModel) {
         return;
     }
     
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    advanceFrame();
+    emit frameRendered(frameTimer.nsecsElapsed());
+}
+
+void VehicleAnimationEngine::advanceFrame()
+{
     // Update progress based on playback speed - optimized for long-term data
     double timeStep = (m_animationTimer->interval() * m_playbackSpeed) / 1000.0; // seconds
     if (m_startTime.isValid() && m_endTime.isValid()) {
@@ -181,6 +184,17 @@ void VehicleAnimationEngine::updateAnimation()
             qint64 currentMs = static_cast<qint64>(totalMs * m_currentProgress);
             m_currentTime = m_startTime.addMSecs(currentMs);
             
+            // Jump over long stops instead of animating a parked vehicle
+            if (m_skipLongStops && m_stopDetector) {
+                StopDetector::StopEvent stop;
+                if (m_stopDetector->stopAt(m_currentTime, stop) &&
+                    stop.durationSecs() >= m_minSkippedStopSecs &&
+                    stop.endTime < m_endTime) {
+                    m_currentTime = stop.endTime;
+                    m_currentProgress = static_cast<double>(m_startTime.msecsTo(m_currentTime)) / totalMs;
+                }
+            }
+            
             // Update vehicle positions at current time
             updateVehiclePositions();
             
@@ -285,24 +299,23 @@ void VehicleAnimationEngine::updateVehiclePositions()
         return;
     }
     
-    // Get all unique vehicles and update their positions - optimized for long-term data
-    QStringList vehicles = m_vehicleModel->getVehicleList();
+    // Get all unique vehicles and update their positions - optimized for long-term data.
+    // The list is shared with the model (no copy), and the list index is the vehicle id,
+    // so cache lookups below use a packed integer key and do not allocate.
+    const QStringList vehicles = m_vehicleModel->getVehicleList();
     
-    for (const QString& plateNumber : vehicles) {
-        // Use cached vehicle records if available for better performance
-        QString cacheKey = QString("%1_%2").arg(plateNumber).arg(m_currentTime.toMSecsSinceEpoch() / 60000); // Cache per minute
+    const qint64 minuteBucket = m_currentTime.toMSecsSinceEpoch() / 60000; // Cache per minute
+    
+    // 缓存命中时直接引用缓存中的状态（隐式共享），循环内不构造 VehicleState：
+    // 其 QGeoCoordinate 默认构造也要分配内存，每帧每车一次
+    QList<VehicleDataModel::VehicleState> cachedStates;
+    
+    for (int vehicleId = 0; vehicleId < vehicles.size(); ++vehicleId) {
+        const QString& plateNumber = vehicles.at(vehicleId);
         
         // Check cache first
-        bool foundInCache = false;
-        VehicleDataModel::VehicleState cachedState;
-        auto cachedStateIt = m_vehicleStateCache.find(cacheKey);
-        if (cachedStateIt != m_vehicleStateCache.end()) {
-            cachedState = cachedStateIt.value();
-            foundInCache = true;
-        }
-        
-        // Emit signal if found in cache
-        if (foundInCache) {
+        if (getCachedVehicleStates(vehicleId, minuteBucket, cachedStates)) {
+            const VehicleDataModel::VehicleState& cachedState = cachedStates.constFirst();
             emit vehiclePositionUpdated(plateNumber, cachedState.position, cachedState.direction, cachedState.speed);
             continue;
         }
@@ -335,13 +348,16 @@ void VehicleAnimationEngine::updateVehiclePositions()
             
             // Use a more targeted search approach
             for (int i = 0; i < m_vehicleModel->rowCount(); i += 10) { // Sample every 10th record for efficiency
+                // 先按车辆 id 过滤，其他车辆的记录不再读取任何字段
+                if (m_vehicleModel->vehicleIdAt(i) != vehicleId) {
+                    continue;
+                }
                 QModelIndex index = m_vehicleModel->index(i);
-                QString recordPlate = m_vehicleModel->data(index, Qt::UserRole + 1).toString();
                 QDateTime recordTime = m_vehicleModel->data(index, Qt::UserRole + 5).toDateTime();
                 
-                if (recordPlate == plateNumber && recordTime >= searchStart && recordTime <= searchEnd) {
+                if (recordTime >= searchStart && recordTime <= searchEnd) {
                     ExcelDataReader::VehicleRecord record;
-                    record.plateNumber = recordPlate;
+                    record.plateNumber = plateNumber;
                     record.speed = m_vehicleModel->data(index, Qt::UserRole + 3).toDouble();
                     record.direction = m_vehicleModel->data(index, Qt::UserRole + 4).toInt();
                     record.timestamp = recordTime;
@@ -365,12 +381,10 @@ void VehicleAnimationEngine::updateVehiclePositions()
         } else {
             // For smaller datasets, use the original approach
             for (int i = 0; i < m_vehicleModel->rowCount(); ++i) {
-                QModelIndex index = m_vehicleModel->index(i);
-                QString recordPlate = m_vehicleModel->data(index, Qt::UserRole + 1).toString();
-                
-                if (recordPlate == plateNumber) {
+                if (m_vehicleModel->vehicleIdAt(i) == vehicleId) {
+                    QModelIndex index = m_vehicleModel->index(i);
                     ExcelDataReader::VehicleRecord record;
-                    record.plateNumber = recordPlate;
+                    record.plateNumber = plateNumber;
                     record.speed = m_vehicleModel->data(index, Qt::UserRole + 3).toDouble();
                     record.direction = m_vehicleModel->data(index, Qt::UserRole + 4).toInt();
                     record.timestamp = m_vehicleModel->data(index, Qt::UserRole + 5).toDateTime();
@@ -486,9 +500,7 @@ void VehicleAnimationEngine::updateVehiclePositions()
             state.timestamp = currentRecord.timestamp;
             state.color = currentRecord.vehicleColor;
             
-            if (m_vehicleStateCache.size() < m_maxCacheSize) {
-                m_vehicleStateCache[cacheKey] = state;
-            }
+            cacheVehicleState(vehicleId, minuteBucket, state);
             
             // Emit signal
             emit vehiclePositionUpdated(plateNumber, position, 
@@ -508,9 +520,9 @@ void VehicleAnimationEngine::updateTimerInterval()
     }
 }
 
-bool VehicleAnimationEngine::shouldUpdatePosition(const QString& plateNumber, const QGeoCoordinate& newPos)
+bool VehicleAnimationEngine::shouldUpdatePosition(int vehicleId, const QGeoCoordinate& newPos)
 {
-    auto it = m_lastKnownPositions.find(plateNumber);
+    auto it = m_lastKnownPositions.find(vehicleId);
     bool shouldUpdate = true;
     
     if (it != m_lastKnownPositions.end()) {
@@ -524,37 +536,16 @@ bool VehicleAnimationEngine::shouldUpdatePosition(const QString& plateNumber, co
     return shouldUpdate;
 }
 
-void VehicleAnimationEngine::cacheVehicleState(const QString& plateNumber, const VehicleDataModel::VehicleState& state)
+void VehicleAnimationEngine::cacheVehicleState(int vehicleId, qint64 minuteBucket, const VehicleDataModel::VehicleState& state)
 {
-    // Limit cache size to prevent memory issues
-    if (m_vehicleStateCache.size() >= m_maxCacheSize) {
-        // Remove oldest entries (simple FIFO)
-        auto it = m_vehicleStateCache.begin();
-        for (int i = 0; i < m_maxCacheSize / 4 && it != m_vehicleStateCache.end(); ++i) {
-            it = m_vehicleStateCache.erase(it);
-        }
-    }
-    
-    m_vehicleStateCache[plateNumber] = state;
-    m_lastKnownPositions[plateNumber] = state.position;
+    // Eviction is handled by the shared LRU cache's memory budget
+    m_vehicleModel->stateCache()->insert(VehicleStateCache::Key{vehicleId, minuteBucket}, {state});
+    m_lastKnownPositions[vehicleId] = state.position;
 }
 
-VehicleDataModel::VehicleState VehicleAnimationEngine::getCachedVehicleState(const QString& plateNumber)
+bool VehicleAnimationEngine::getCachedVehicleStates(int vehicleId, qint64 minuteBucket, QList<VehicleDataModel::VehicleState>& states) const
 {
-    auto it = m_vehicleStateCache.find(plateNumber);
-    VehicleDataModel::VehicleState result;
-    if (it != m_vehicleStateCache.end()) {
-        result = it.value();
-    }
-    
-    return result;
+    // 只读访问 states，不能触发分离（非 const 的 first() 会复制整个列表）
+    return m_vehicleModel->stateCache()->lookup(VehicleStateCache::Key{vehicleId, minuteBucket}, states) &&
+           !states.isEmpty();
 }
-
-void VehicleAnimationEngine::cleanupCache()
-{
-    // Clear cache if it gets too large
-    if (m_vehicleStateCache.size() > m_maxCacheSize * 2) {
-        m_vehicleStateCache.clear();
-        m_lastKnownPositions.clear();
-    }
-}
\ No newline at end of file
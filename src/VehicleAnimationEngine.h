@@ -8,6 +8,7 @@
 #include <QElapsedTimer>
 #include <QHash>
 #include "VehicleDataModel.h"
+#include "StopDetector.h"
 
 class VehicleAnimationEngine : public QObject
 {
@@ -28,7 +29,13 @@ public:
     // Performance optimization methods
     void setAnimationFrameRate(int fps) { m_targetFps = fps; updateTimerInterval(); }
     void setInterpolationEnabled(bool enabled) { m_interpolationEnabled = enabled; }
-    void setPositionCacheSize(int size) { m_maxCacheSize = size; }
+    
+    // 回放时跳过超过 minDurationSecs 的停留
+    void setStopDetector(const StopDetector* detector) { m_stopDetector = detector; }
+    void setSkipLongStops(bool enabled, qint64 minDurationSecs = 600) {
+        m_skipLongStops = enabled;
+        m_minSkippedStopSecs = minDurationSecs;
+    }
     
 public slots:
     void play();
@@ -44,13 +51,14 @@ signals:
     void playbackStateChanged(PlaybackState state);
     void currentTimeChanged(const QDateTime& time);
     void progressChanged(double progress);  // 通知UI更新进度条位置
+    void frameRendered(qint64 frameNsecs);  // 每个播放帧的耗时，供 PerformanceMonitor 统计
     
 private slots:
     void updateAnimation();
-    void cleanupCache();
     
 private:
     // Core animation methods
+    void advanceFrame();
     QGeoCoordinate interpolatePosition(const QGeoCoordinate& start,
                                      const QGeoCoordinate& end,
                                      double ratio) const;
@@ -59,14 +67,13 @@ private:
     
     // Performance optimization methods
     void updateTimerInterval();
-    bool shouldUpdatePosition(const QString& plateNumber, const QGeoCoordinate& newPos);
-    void cacheVehicleState(const QString& plateNumber, const VehicleDataModel::VehicleState& state);
-    VehicleDataModel::VehicleState getCachedVehicleState(const QString& plateNumber);
+    bool shouldUpdatePosition(int vehicleId, const QGeoCoordinate& newPos);
+    void cacheVehicleState(int vehicleId, qint64 minuteBucket, const VehicleDataModel::VehicleState& state);
+    bool getCachedVehicleStates(int vehicleId, qint64 minuteBucket, QList<VehicleDataModel::VehicleState>& states) const;
     
     // Core members
     VehicleDataModel* m_vehicleModel;
     QTimer* m_animationTimer;
-    QTimer* m_cacheCleanupTimer;
     PlaybackState m_playbackState;
     double m_playbackSpeed;
     QDateTime m_currentTime;
@@ -78,13 +85,16 @@ private:
     // Performance optimization members
     int m_targetFps = 30; // Target frame rate
     bool m_interpolationEnabled = true;
-    int m_maxCacheSize = 1000;
     QElapsedTimer m_frameTimer;
     qint64 m_lastFrameTime = 0;
     
-    // Position caching for performance
-    QHash<QString, VehicleDataModel::VehicleState> m_vehicleStateCache;
-    QHash<QString, QGeoCoordinate> m_lastKnownPositions;
+    // Stop skipping during playback
+    const StopDetector* m_stopDetector = nullptr;
+    bool m_skipLongStops = false;
+    qint64 m_minSkippedStopSecs = 600;
+    
+    // Interpolated states are cached in the model's shared VehicleStateCache
+    QHash<int, QGeoCoordinate> m_lastKnownPositions;  // 车辆 id -> 最近一次位置
     
     // Animation smoothing
     static constexpr double MIN_POSITION_CHANGE = 0.00001; // ~1 meter
@@ -1,12 +1,19 @@
 #include "VehicleDataModel.h"
+#include "Tracer.h"
+#include "VehicleStateCache.h"
+#include "StringPool.h"
 #include <QGeoCoordinate>
 #include <QThread>
 #include <QTimer>
 #include <algorithm>
 
+static_assert(VehicleDataModel::InvalidVehicleId != VehicleStateCache::AllVehicles,
+              "cache keys built from an unknown plate must not alias the all-vehicles entries");
+
 VehicleDataModel::VehicleDataModel(QObject *parent)
     : QAbstractListModel(parent)
     , m_dataProcessingTimer(new QTimer(this))
+    , m_stateCache(new VehicleStateCache(this))
 {
     // Set up timer for batch processing
     m_dataProcessingTimer->setSingleShot(true);
@@ -64,10 +71,14 @@ QHash<int, QByteArray> VehicleDataModel::roleNames() const
 
 void VehicleDataModel::setVehicleData(const QList<ExcelDataReader::VehicleRecord>& records)
 {
+    TRACE_SCOPE("VehicleDataModel::setVehicleData");
     // Clear existing data and cache
     beginResetModel();
     m_vehicleRecords.clear();
     m_timeIndex.clear();
+    m_vehiclePlates.clear();
+    m_vehicleIdByPlate.clear();
+    m_recordVehicleIds.clear();
     clearCache();
     
     if (records.size() > m_batchSize) {
@@ -83,6 +94,10 @@ void VehicleDataModel::setVehicleData(const QList<ExcelDataReader::VehicleRecord
     } else {
         // Process small datasets immediately
         m_vehicleRecords = records;
+        m_recordVehicleIds.reserve(m_vehicleRecords.size());
+        for (const auto& record : m_vehicleRecords) {
+            registerVehicle(record);
+        }
         calculateTimeRange();
         if (m_timeIndexingEnabled) {
             buildTimeIndex();
@@ -105,9 +120,12 @@ void VehicleDataModel::processPendingData()
     // Process batch
     beginInsertRows(QModelIndex(), startIndex, startIndex + (endIndex - startIndex) - 1);
     
+    QSet<int> touchedVehicles;
     for (int i = startIndex; i < endIndex; ++i) {
         const auto& record = m_pendingRecords[i];
         m_vehicleRecords.append(record);
+        registerVehicle(record);
+        touchedVehicles.insert(m_recordVehicleIds.last());
         
         if (m_timeIndexingEnabled) {
             addToTimeIndex(record, m_vehicleRecords.size() - 1);
@@ -116,6 +134,13 @@ void VehicleDataModel::processPendingData()
     
     endInsertRows();
     
+    // 只有本批涉及的车辆和全体车辆快照可能不完整，其他车辆的缓存保留
+    touchedVehicles.remove(InvalidVehicleId);
+    if (!touchedVehicles.isEmpty()) {
+        touchedVehicles.insert(VehicleStateCache::AllVehicles);
+        m_stateCache->removeVehicles(touchedVehicles);
+    }
+    
     // Update progress
     int progress = (endIndex * 100) / m_pendingRecords.size();
     emit dataProcessingProgress(progress);
@@ -137,22 +162,17 @@ QList<VehicleDataModel::VehicleState> VehicleDataModel::getVehicleStatesAtTime(c
         return QList<VehicleState>();
     }
     
-    qint64 timeKey = timeToKey(time);
+    const VehicleStateCache::Key key{VehicleStateCache::AllVehicles, timeToKey(time)};
     
     // Check cache first
-    auto it = m_stateCache.find(timeKey);
-    if (it != m_stateCache.end()) {
-        return it.value();
+    QList<VehicleState> states;
+    if (m_stateCache->lookup(key, states)) {
+        return states;
     }
     
-    // Compute states and cache result
-    QList<VehicleState> states = computeVehicleStatesAtTime(time);
-    
-    // Limit cache size to prevent memory issues
-    if (m_stateCache.size() > 1000) {
-        m_stateCache.clear();
-    }
-    m_stateCache[timeKey] = states;
+    // Compute states and cache result; the cache evicts least recently used entries
+    states = computeVehicleStatesAtTime(time);
+    m_stateCache->insert(key, states);
     
     return states;
 }
@@ -169,20 +189,45 @@ QDateTime VehicleDataModel::getEndTime() const
 
 QStringList VehicleDataModel::getVehicleList() const
 {
-    QStringList vehicles;
-    QSet<QString> uniqueVehicles; // Use QSet for O(1) lookups
-    
-    for (const auto& record : m_vehicleRecords) {
-        if (!uniqueVehicles.contains(record.plateNumber)) {
-            uniqueVehicles.insert(record.plateNumber);
-            vehicles.append(record.plateNumber);
-        }
-    }
-    return vehicles;
+    return m_vehiclePlates;
+}
+
+int VehicleDataModel::vehicleIdForPlate(const QString& plateNumber) const
+{
+    return m_vehicleIdByPlate.value(StringPool::plates().find(plateNumber), InvalidVehicleId);
+}
+
+void VehicleDataModel::clearCache()
+{
+    m_stateCache->clear();
 }
 
 // Private helper methods
 
+void VehicleDataModel::registerVehicle(const ExcelDataReader::VehicleRecord& record)
+{
+    // 解析得到的记录都带有车牌 id；其他来源的记录在这里补上
+    int plateId = record.plateId;
+    if (plateId < 0) {
+        QString interned;
+        plateId = StringPool::plates().intern(record.plateNumber, interned);
+    }
+    if (plateId < 0) {
+        m_recordVehicleIds.append(InvalidVehicleId);
+        return;
+    }
+    
+    if (plateId >= m_vehicleIdByPlate.size()) {
+        m_vehicleIdByPlate.resize(plateId + 1, InvalidVehicleId);
+    }
+    int& vehicleId = m_vehicleIdByPlate[plateId];
+    if (vehicleId == InvalidVehicleId) {
+        vehicleId = m_vehiclePlates.size();
+        m_vehiclePlates.append(record.plateNumber);
+    }
+    m_recordVehicleIds.append(vehicleId);
+}
+
 void VehicleDataModel::calculateTimeRange()
 {
     if (m_vehicleRecords.isEmpty()) {
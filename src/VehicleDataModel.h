@@ -8,6 +8,8 @@
 #include <QHash>
 #include "ExcelDataReader.h"
 
+class VehicleStateCache;
+
 class VehicleDataModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -33,12 +35,17 @@ public:
     QList<VehicleState> getVehicleStatesAtTime(const QDateTime& time);
     QDateTime getStartTime() const;
     QDateTime getEndTime() const;
-    QStringList getVehicleList() const;
+    QStringList getVehicleList() const; // index in this list is the vehicle id
+    // 车辆 id 从 0 开始；不存在时返回 InvalidVehicleId（不同于 VehicleStateCache::AllVehicles）
+    static constexpr int InvalidVehicleId = -2;
+    int vehicleIdForPlate(const QString& plateNumber) const;
+    int vehicleIdAt(int row) const { return m_recordVehicleIds.value(row, InvalidVehicleId); } // 第 row 条记录的车辆 id
     
     // Performance optimization methods
     void setDataProcessingBatchSize(int batchSize) { m_batchSize = batchSize; }
     void enableTimeIndexing(bool enabled) { m_timeIndexingEnabled = enabled; }
-    void clearCache() { m_stateCache.clear(); }
+    void clearCache();
+    VehicleStateCache* stateCache() const { return m_stateCache; } // 与动画引擎共享
     
 signals:
     void dataChanged();
@@ -70,9 +77,15 @@ private:
     
     // Time-based indexing for fast lookups
     QHash<qint64, QList<int>> m_timeIndex; // timestamp -> record indices
-    QHash<qint64, QList<VehicleState>> m_stateCache; // cached states by time
+    VehicleStateCache* m_stateCache; // LRU cache keyed by (vehicle, minute)
+    
+    // Unique vehicles in first-seen order; index is the vehicle id
+    QStringList m_vehiclePlates;
+    QVector<int> m_vehicleIdByPlate;    // StringPool::plates() 的 id -> 车辆 id，不在本模型中为 InvalidVehicleId
+    QVector<int> m_recordVehicleIds;    // 与 m_vehicleRecords 对应
     
     // Helper methods
+    void registerVehicle(const ExcelDataReader::VehicleRecord& record);
     void buildTimeIndex();
     void addToTimeIndex(const ExcelDataReader::VehicleRecord& record, int index);
     QList<VehicleState> computeVehicleStatesAtTime(const QDateTime& time);
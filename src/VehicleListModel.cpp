@@ -0,0 +1,217 @@
+#include "VehicleListModel.h"
+#include <algorithm>
+#include <numeric>
+
+VehicleListModel::VehicleListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int VehicleListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_visible.size();
+}
+
+QVariant VehicleListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_visible.size()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case PlateNumberRole:
+    case Qt::DisplayRole:
+        return m_plates.at(m_visible.at(index.row()));
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> VehicleListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[PlateNumberRole] = "plateNumber";
+    return roles;
+}
+
+QString VehicleListModel::plateAt(int row) const
+{
+    if (row < 0 || row >= m_visible.size()) {
+        return QString();
+    }
+    return m_plates.at(m_visible.at(row));
+}
+
+void VehicleListModel::setVehicles(const QStringList& plates)
+{
+    beginResetModel();
+
+    m_plates = plates;
+    m_foldedPlates.clear();
+    m_foldedPlates.reserve(plates.size());
+    for (const QString& plate : plates) {
+        m_foldedPlates.append(plate.toCaseFolded());
+    }
+
+    buildIndex();
+
+    // 新列表下重新应用当前过滤条件
+    m_visible = findMatches(m_lastQuery);
+
+    endResetModel();
+
+    emit countChanged();
+    emit totalCountChanged();
+}
+
+void VehicleListModel::setFilterText(const QString& text)
+{
+    QString folded = text.trimmed().toCaseFolded();
+    if (folded == m_lastQuery) {
+        return;
+    }
+
+    QVector<int> matches;
+    if (!m_lastQuery.isEmpty() && folded.contains(m_lastQuery)) {
+        // 查询变得更严格：结果一定是当前可见行的子集
+        matches.reserve(m_visible.size());
+        for (int index : m_visible) {
+            if (m_foldedPlates.at(index).contains(folded)) {
+                matches.append(index);
+            }
+        }
+    } else {
+        matches = findMatches(folded);
+    }
+
+    m_lastQuery = folded;
+    applyMatches(matches);
+}
+
+void VehicleListModel::buildIndex()
+{
+    m_unigramIndex.clear();
+    m_bigramIndex.clear();
+
+    for (int i = 0; i < m_foldedPlates.size(); ++i) {
+        const QString& plate = m_foldedPlates.at(i);
+
+        // 按车牌顺序追加，倒排表天然升序；同一车牌内重复的字符/字符对只记录一次
+        for (int c = 0; c < plate.size(); ++c) {
+            QVector<int>& charPostings = m_unigramIndex[plate.at(c)];
+            if (charPostings.isEmpty() || charPostings.last() != i) {
+                charPostings.append(i);
+            }
+            if (c + 1 < plate.size()) {
+                QVector<int>& pairPostings = m_bigramIndex[bigramKey(plate.at(c), plate.at(c + 1))];
+                if (pairPostings.isEmpty() || pairPostings.last() != i) {
+                    pairPostings.append(i);
+                }
+            }
+        }
+    }
+}
+
+QVector<int> VehicleListModel::findMatches(const QString& foldedQuery) const
+{
+    QVector<int> matches;
+
+    if (foldedQuery.isEmpty()) {
+        matches.resize(m_plates.size());
+        std::iota(matches.begin(), matches.end(), 0);
+        return matches;
+    }
+
+    // 选择最短的倒排表作为候选集
+    const QVector<int>* candidates = nullptr;
+    if (foldedQuery.size() == 1) {
+        auto it = m_unigramIndex.constFind(foldedQuery.at(0));
+        if (it == m_unigramIndex.constEnd()) {
+            return matches;
+        }
+        candidates = &it.value();
+    } else {
+        for (int c = 0; c + 1 < foldedQuery.size(); ++c) {
+            auto it = m_bigramIndex.constFind(bigramKey(foldedQuery.at(c), foldedQuery.at(c + 1)));
+            if (it == m_bigramIndex.constEnd()) {
+                return matches; // 某个字符对不存在，一定无匹配
+            }
+            if (!candidates || it.value().size() < candidates->size()) {
+                candidates = &it.value();
+            }
+        }
+    }
+
+    if (foldedQuery.size() <= 2) {
+        return *candidates; // 倒排表本身就是精确结果
+    }
+
+    matches.reserve(candidates->size());
+    for (int index : *candidates) {
+        if (m_foldedPlates.at(index).contains(foldedQuery)) {
+            matches.append(index);
+        }
+    }
+    return matches;
+}
+
+void VehicleListModel::applyMatches(const QVector<int>& matches)
+{
+    int oldCount = m_visible.size();
+
+    // 两个列表都是同一有序车牌表的升序子集：先移除不再匹配的连续行段，
+    // 再插入新增的连续行段，视图只更新变化的 delegate。
+    QVector<bool> keep(m_visible.size(), false);
+    int m = 0;
+    for (int row = 0; row < m_visible.size(); ++row) {
+        while (m < matches.size() && matches.at(m) < m_visible.at(row)) {
+            ++m;
+        }
+        keep[row] = (m < matches.size() && matches.at(m) == m_visible.at(row));
+    }
+
+    // 从后往前删除，保证前面的行号不变
+    for (int row = m_visible.size() - 1; row >= 0; --row) {
+        if (keep.at(row)) {
+            continue;
+        }
+        int last = row;
+        while (row > 0 && !keep.at(row - 1)) {
+            --row;
+        }
+        beginRemoveRows(QModelIndex(), row, last);
+        m_visible.remove(row, last - row + 1);
+        endRemoveRows();
+    }
+
+    // 此时 m_visible 是 matches 的子序列，按顺序插入缺少的行段
+    int row = 0;
+    m = 0;
+    while (m < matches.size()) {
+        if (row < m_visible.size() && m_visible.at(row) == matches.at(m)) {
+            ++row;
+            ++m;
+            continue;
+        }
+
+        int first = m;
+        while (m < matches.size() &&
+               !(row < m_visible.size() && m_visible.at(row) == matches.at(m))) {
+            ++m;
+        }
+
+        int insertCount = m - first;
+        beginInsertRows(QModelIndex(), row, row + insertCount - 1);
+        m_visible.insert(row, insertCount, 0);
+        std::copy(matches.cbegin() + first, matches.cbegin() + m, m_visible.begin() + row);
+        endInsertRows();
+        row += insertCount;
+    }
+
+    if (m_visible.size() != oldCount) {
+        emit countChanged();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef VEHICLELISTMODEL_H
+#define VEHICLELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @class VehicleListModel
+ * @brief 车辆列表模型，带车牌号 n-gram 索引的增量搜索
+ *
+ * - 单字符/双字符倒排索引：新查询从最短的倒排表出发验证，而不是扫描全部车牌
+ * - 查询在上一次查询基础上追加字符时，只在上一次结果中过滤
+ * - 过滤结果变化以 beginRemoveRows/beginInsertRows 差量通知视图，
+ *   不重建整个列表的 delegate
+ */
+class VehicleListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
+
+public:
+    enum Roles {
+        PlateNumberRole = Qt::UserRole + 1
+    };
+
+    explicit VehicleListModel(QObject *parent = nullptr);
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief 设置完整车牌列表并重建索引（重置模型）
+     * @param plates 已排序的车牌号列表
+     */
+    void setVehicles(const QStringList& plates);
+
+    /**
+     * @brief 按车牌号子串过滤（不区分大小写），以行差量更新视图
+     */
+    void setFilterText(const QString& text);
+
+    int totalCount() const { return m_plates.size(); }
+    Q_INVOKABLE QString plateAt(int row) const;
+
+signals:
+    void countChanged();
+    void totalCountChanged();
+
+private:
+    void buildIndex();
+    QVector<int> findMatches(const QString& foldedQuery) const;
+    void applyMatches(const QVector<int>& matches);
+
+    static quint32 bigramKey(QChar a, QChar b) { return (quint32(a.unicode()) << 16) | b.unicode(); }
+
+    QStringList m_plates;          // 原始车牌（有序）
+    QStringList m_foldedPlates;    // 大小写折叠后的车牌，用于匹配
+    QHash<QChar, QVector<int>> m_unigramIndex;   // 字符 -> 车牌下标（升序）
+    QHash<quint32, QVector<int>> m_bigramIndex;  // 相邻字符对 -> 车牌下标（升序）
+
+    QVector<int> m_visible;        // 当前可见行对应的车牌下标（升序）
+    QString m_lastQuery;           // 上一次查询（已折叠）
+};
+
+#endif // VEHICLELISTMODEL_H
@@ -1,10 +1,18 @@
 #include "VehicleManager.h"
+#include "ConfigManager.h"
+#include "Tracer.h"
 #include "CoordinateConverter.h"
+#include "StringPool.h"
+#include <QSet>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <utility>
 
 VehicleManager::VehicleManager(QObject *parent)
     : QObject(parent)
     , m_coordinateConversionEnabled(false)
     , m_excelReader(new ExcelDataReader(this))
+    , m_stopDetector(new StopDetector(this))
 {
 }
 
@@ -25,6 +33,9 @@ void VehicleManager::setVehicleList(const QList<FolderScanner::VehicleInfo>& veh
             m_selectedVehicle.clear();
             m_currentTrajectory.clear();
             m_convertedTrajectory.clear();
+            m_stopDetector->clear();
+            m_trips.clear();
+            m_trajectoryGrid.clear();
         }
     }
 }
@@ -37,6 +48,9 @@ void VehicleManager::selectVehicle(const QString& plateNumber)
         // Clear previous trajectory data
         m_currentTrajectory.clear();
         m_convertedTrajectory.clear();
+        m_stopDetector->clear();
+        m_trips.clear();
+        m_trajectoryGrid.clear();
         
         emit vehicleSelected(plateNumber);
         
@@ -60,6 +74,7 @@ void VehicleManager::selectVehicle(const QString& plateNumber)
 
 void VehicleManager::loadVehicleTrajectory(const QString& plateNumber)
 {
+    TRACE_SCOPE("VehicleManager::loadVehicleTrajectory");
     if (plateNumber.isEmpty()) {
         qWarning() << "Cannot load trajectory: plate number is empty";
         return;
@@ -82,11 +97,21 @@ void VehicleManager::loadVehicleTrajectory(const QString& plateNumber)
     
     // Clear previous trajectory data
     m_currentTrajectory.clear();
+    m_stopDetector->clear();
+    m_trips.clear();
+    m_trajectoryGrid.clear();
+    m_validationReport.clear();
     
     // Load data from all files and merge
     QList<ExcelDataReader::VehicleRecord> allRecords;
     int totalFiles = filePaths.size();
     int processedFiles = 0;
+    int rowsRead = 0;
+    QElapsedTimer readTimer;
+    readTimer.start();
+    
+    // 所有文件使用同一份列映射，加载期间修改配置不影响本次加载
+    const ConfigManager::SnapshotPtr config = ConfigManager::GetInstance()->snapshot();
     
     // Reuse the existing ExcelDataReader instance to avoid creating temporary objects
     if (!m_excelReader) {
@@ -118,7 +143,7 @@ void VehicleManager::loadVehicleTrajectory(const QString& plateNumber)
         
         try {
             // Load the file using the column mapping configuration
-            loadSuccess = m_excelReader->loadExcelFile(filePath);
+            loadSuccess = m_excelReader->loadExcelFile(filePath, config);
         } catch (const std::exception& e) {
             errorMessage = QString("文件读取异常: %1").arg(e.what());
             loadSuccess = false;
@@ -129,12 +154,17 @@ void VehicleManager::loadVehicleTrajectory(const QString& plateNumber)
             qWarning() << "Unknown exception loading file" << filePath;
         }
         
+        // 失败的文件也可能带有校验结果（例如全部行无效）
+        m_validationReport.merge(m_excelReader->validationReport());
+        
         if (loadSuccess && errorMessage.isEmpty()) {
             QList<ExcelDataReader::VehicleRecord> fileRecords = m_excelReader->getVehicleData();
+            rowsRead += fileRecords.size();
             
-            // Filter records for the selected vehicle and add to collection
+            // Filter records for the selected vehicle and add to collection (compare interned plate ids)
+            const int plateId = StringPool::plates().find(plateNumber);
             for (const auto& record : fileRecords) {
-                if (record.plateNumber == plateNumber) {
+                if (plateId >= 0 && record.plateId == plateId) {
                     allRecords.append(record);
                 }
             }
@@ -147,6 +177,7 @@ void VehicleManager::loadVehicleTrajectory(const QString& plateNumber)
         processedFiles++;
         emit loadingProgress((processedFiles * 100) / totalFiles);
     }
+    emit recordsLoaded(rowsRead, readTimer.elapsed());
     
     if (allRecords.isEmpty()) {
         qWarning() << "No records found for vehicle:" << plateNumber;
@@ -160,36 +191,14 @@ void VehicleManager::loadVehicleTrajectory(const QString& plateNumber)
                   return a.timestamp < b.timestamp;
               });
     
-    // Filter out stationary vehicle data points (speed = 0 and same mileage as previous record)
-    QList<ExcelDataReader::VehicleRecord> filteredRecords;
-    if (!allRecords.isEmpty()) {
-        filteredRecords.reserve(allRecords.size()); // Reserve space for better performance
-        
-        // Always include the first record
-        filteredRecords.append(allRecords.first());
-        
-        int originalCount = allRecords.size();
-        int filteredCount = 0;
-        
-        for (int i = 1; i < allRecords.size(); ++i) {
-            const auto& currentRecord = allRecords[i];
-            const auto& previousRecord = filteredRecords.last(); // Use last filtered record for comparison
-            
-            // Check if vehicle is stationary (speed = 0 and same mileage)
-            bool isStationary = (currentRecord.speed == 0.0) && 
-                               (currentRecord.totalMileage == previousRecord.totalMileage) &&
-                               (!currentRecord.totalMileage.isEmpty()); // Only filter if mileage data exists
-            
-            if (!isStationary) {
-                // Include this record if vehicle is moving or mileage changed
-                filteredRecords.append(currentRecord);
-            } else {
-                filteredCount++;
-            }
-        }
-    }
+    // Collapse stationary runs (speed = 0 and same mileage as previous record) into stop events
+    QList<StopDetector::StopEvent> stops;
+    m_currentTrajectory = StopDetector::detect(allRecords, stops);
+    m_stopDetector->setStops(stops);
+    m_trajectoryGrid = buildTrajectoryGrid(m_currentTrajectory);
     
-    m_currentTrajectory = filteredRecords;
+    // Split into trips at long stops and data gaps; summaries are reused by UI and exports
+    m_trips = TripSegmenter::segment(m_currentTrajectory, stops);
     
     // Apply coordinate conversion if enabled
     if (m_coordinateConversionEnabled) {
@@ -228,23 +237,13 @@ void VehicleManager::applyCoordinateConversionToCurrentTrajectory()
         ? CoordinateConverter::GCJ02 
         : CoordinateConverter::WGS84;
     
-    // Convert each record
-    for (const auto& record : m_currentTrajectory) {
-        ExcelDataReader::VehicleRecord convertedRecord = record;
-        
-        if (m_coordinateConversionEnabled) {
-            // Convert WGS84 to GCJ02
-            QGeoCoordinate originalCoord(record.latitude, record.longitude);
-            QGeoCoordinate convertedCoord = CoordinateConverter::wgs84ToGcj02(originalCoord);
-            
-            convertedRecord.latitude = convertedCoord.latitude();
-            convertedRecord.longitude = convertedCoord.longitude();
-        }
+    if (m_coordinateConversionEnabled) {
+        // Convert WGS84 to GCJ02
+        m_convertedTrajectory = convertToGcj02(m_currentTrajectory);
+    } else {
         // If conversion is disabled, keep original coordinates
-        
-        m_convertedTrajectory.append(convertedRecord);
+        m_convertedTrajectory = m_currentTrajectory;
     }
-    
 }
 
 QList<ExcelDataReader::VehicleRecord> VehicleManager::getCurrentTrajectory() const
@@ -280,3 +279,86 @@ bool VehicleManager::hasTrajectoryData() const
 {
     return !m_convertedTrajectory.isEmpty();
 }
+
+QGeoRectangle VehicleManager::trajectoryBounds() const
+{
+    if (m_convertedTrajectory.isEmpty()) {
+        return QGeoRectangle();
+    }
+
+    double minLatitude = 90.0;
+    double maxLatitude = -90.0;
+    double minLongitude = 180.0;
+    double maxLongitude = -180.0;
+    for (const auto& record : m_convertedTrajectory) {
+        minLatitude = qMin(minLatitude, record.latitude);
+        maxLatitude = qMax(maxLatitude, record.latitude);
+        minLongitude = qMin(minLongitude, record.longitude);
+        maxLongitude = qMax(maxLongitude, record.longitude);
+    }
+
+    return QGeoRectangle(QGeoCoordinate(maxLatitude, minLongitude),
+                         QGeoCoordinate(minLatitude, maxLongitude));
+}
+
+QList<ExcelDataReader::VehicleRecord> VehicleManager::convertToGcj02(
+    const QList<ExcelDataReader::VehicleRecord>& records)
+{
+    TRACE_SCOPE("VehicleManager::convertToGcj02");
+    QList<ExcelDataReader::VehicleRecord> converted;
+    converted.reserve(records.size());
+    
+    for (const auto& record : records) {
+        ExcelDataReader::VehicleRecord convertedRecord = record;
+        
+        QGeoCoordinate originalCoord(record.latitude, record.longitude);
+        QGeoCoordinate convertedCoord = CoordinateConverter::wgs84ToGcj02(originalCoord);
+        
+        convertedRecord.latitude = convertedCoord.latitude();
+        convertedRecord.longitude = convertedCoord.longitude();
+        
+        converted.append(convertedRecord);
+    }
+    
+    return converted;
+}
+
+PointGrid VehicleManager::buildTrajectoryGrid(const QList<ExcelDataReader::VehicleRecord>& trajectory)
+{
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    latitudes.reserve(trajectory.size());
+    longitudes.reserve(trajectory.size());
+    for (const auto& record : trajectory) {
+        latitudes.append(record.latitude);
+        longitudes.append(record.longitude);
+    }
+
+    PointGrid grid;
+    grid.build(std::move(latitudes), std::move(longitudes));
+    return grid;
+}
+
+int VehicleManager::countVisitDays(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                                   const PointGrid& trajectoryGrid, const StopDetector& stops,
+                                   const QGeoCoordinate& target, double radiusMeters)
+{
+    Q_ASSERT(trajectoryGrid.size() == trajectory.size());
+
+    // 用于存储到达目标区域的日期
+    QSet<QDate> visitDates;
+    
+    // 只检查目标附近网格中的轨迹点
+    for (int index : trajectoryGrid.pointsWithin(target, radiusMeters)) {
+        visitDates.insert(trajectory.at(index).timestamp.date());
+    }
+    
+    // 停留在目标区域内时，停留覆盖的每一天都算到访（如跨夜停放）
+    for (const auto& stop : stops.stopsNear(target, radiusMeters)) {
+        for (QDate date = stop.startTime.date(); date <= stop.endTime.date(); date = date.addDays(1)) {
+            visitDates.insert(date);
+        }
+    }
+    
+    return visitDates.size();
+}
@@ -4,8 +4,12 @@
 #include <QObject>
 #include <QString>
 #include <QList>
+#include <QGeoRectangle>
 #include "FolderScanner.h"
 #include "ExcelDataReader.h"
+#include "StopDetector.h"
+#include "TripSegmenter.h"
+#include "PointGrid.h"
 
 class VehicleManager : public QObject
 {
@@ -26,6 +30,23 @@ public:
     bool isCoordinateConversionEnabled() const;
     QStringList getAvailableVehicles() const;
     bool hasTrajectoryData() const;
+    QGeoRectangle trajectoryBounds() const; // 当前显示轨迹（转换后）的包围盒
+    StopDetector* stopDetector() const { return m_stopDetector; } // 当前轨迹的停留事件
+    const PointGrid& trajectoryGrid() const { return m_trajectoryGrid; } // 当前轨迹（原始坐标）的网格索引
+    QList<TripSegmenter::TripSummary> getTrips() const { return m_trips; } // 当前轨迹的行程汇总
+    const ValidationReport& lastValidationReport() const { return m_validationReport; } // 最近一次加载所有文件的校验汇总
+    
+    // 轨迹处理辅助方法（GUI 与批处理命令行共用）
+    // WGS84 -> GCJ02 批量转换
+    static QList<ExcelDataReader::VehicleRecord> convertToGcj02(
+        const QList<ExcelDataReader::VehicleRecord>& records);
+    // 轨迹点（原始坐标）的网格索引，下标与 trajectory 一致
+    static PointGrid buildTrajectoryGrid(const QList<ExcelDataReader::VehicleRecord>& trajectory);
+    // 统计落在目标半径内的不同日期数：轨迹点按自身日期，停留按其覆盖的每一天；
+    // 只检查两个网格索引中目标附近的点，同一条轨迹可对多个目标重复查询
+    static int countVisitDays(const QList<ExcelDataReader::VehicleRecord>& trajectory,
+                              const PointGrid& trajectoryGrid, const StopDetector& stops,
+                              const QGeoCoordinate& target, double radiusMeters);
     
 signals:
     void vehicleSelected(const QString& plateNumber);
@@ -34,15 +55,20 @@ signals:
     void trajectoryConverted(const QString& plateNumber,
                            const QList<ExcelDataReader::VehicleRecord>& convertedTrajectory);
     void loadingProgress(int percentage);
+    void recordsLoaded(int rowCount, qint64 elapsedMs);  // 本次加载读取的总行数与读取耗时
     
 private:
     QList<FolderScanner::VehicleInfo> m_vehicleList;
     QString m_selectedVehicle;
     QList<ExcelDataReader::VehicleRecord> m_currentTrajectory;
     QList<ExcelDataReader::VehicleRecord> m_convertedTrajectory;
+    QList<TripSegmenter::TripSummary> m_trips;
+    PointGrid m_trajectoryGrid;
+    ValidationReport m_validationReport;
     bool m_coordinateConversionEnabled;
     
     ExcelDataReader* m_excelReader;
+    StopDetector* m_stopDetector;
     
     // Helper method to apply coordinate conversion to current trajectory
     void applyCoordinateConversionToCurrentTrajectory();
@@ -0,0 +1,220 @@
+#include "VehicleStateCache.h"
+#include <utility>
+
+VehicleStateCache::VehicleStateCache(QObject *parent)
+    : QObject(parent)
+    , m_memoryBudget(DEFAULT_MEMORY_BUDGET)
+{
+    // 预先分配槽位，避免回放开始阶段反复扩容
+    m_slots.resize(INITIAL_CAPACITY);
+}
+
+bool VehicleStateCache::lookup(const Key& key, QList<VehicleDataModel::VehicleState>& states)
+{
+    int index = findSlot(packKey(key));
+    if (index < 0) {
+        m_misses++;
+        return false;
+    }
+
+    Slot& slot = m_slots[index];
+    slot.referenced = true;
+    m_hits++;
+    states = slot.states; // 隐式共享，只增加引用计数
+    return true;
+}
+
+void VehicleStateCache::insert(const Key& key, const QList<VehicleDataModel::VehicleState>& states)
+{
+    const quint64 packedKey = packKey(key);
+    const qint64 cost = estimateCost(states);
+    int index = findSlot(packedKey);
+    if (cost > m_memoryBudget) {
+        // 单个条目超过总预算，不缓存；同键的旧条目已过期，一并删除
+        if (index >= 0) {
+            removeAt(index);
+        }
+        return;
+    }
+
+    if (index >= 0) {
+        Slot& slot = m_slots[index];
+        m_memoryUsed += cost - slot.cost;
+        slot.states = states;
+        slot.cost = cost;
+        slot.referenced = true;
+    } else {
+        while (m_count > 0 && m_memoryUsed + cost > m_memoryBudget) {
+            evictOne();
+        }
+        if ((m_count + 1) * 2 > m_slots.size()) {
+            rehash(m_slots.size() * 2);
+        }
+
+        const int mask = m_slots.size() - 1;
+        index = homeSlot(packedKey);
+        while (m_slots.at(index).key != EMPTY_KEY) {
+            index = (index + 1) & mask;
+        }
+
+        Slot& slot = m_slots[index];
+        slot.key = packedKey;
+        slot.states = states;
+        slot.cost = cost;
+        slot.referenced = false; // 新条目须再次命中才能躲过下一轮 CLOCK
+        m_memoryUsed += cost;
+        m_count++;
+    }
+
+    // 条目替换后可能超出预算
+    while (m_count > 1 && m_memoryUsed > m_memoryBudget) {
+        evictOne();
+    }
+}
+
+void VehicleStateCache::clear()
+{
+    // 保留槽位数组，只释放状态数据
+    for (Slot& slot : m_slots) {
+        slot = Slot();
+    }
+    m_count = 0;
+    m_clockHand = 0;
+    m_memoryUsed = 0;
+}
+
+void VehicleStateCache::removeVehicles(const QSet<int>& vehicleIds)
+{
+    if (vehicleIds.isEmpty() || m_count == 0) {
+        return;
+    }
+
+    int index = 0;
+    while (index < m_slots.size()) {
+        const quint64 key = m_slots.at(index).key;
+        if (key != EMPTY_KEY && vehicleIds.contains(int(quint32(key >> 32)))) {
+            removeAt(index); // 不前进：回移可能把后续条目移到当前位置
+        } else {
+            index++;
+        }
+    }
+}
+
+void VehicleStateCache::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = qMax<qint64>(bytes, 0);
+    while (m_count > 0 && m_memoryUsed > m_memoryBudget) {
+        evictOne();
+    }
+}
+
+double VehicleStateCache::hitRate() const
+{
+    quint64 total = m_hits + m_misses;
+    return total > 0 ? static_cast<double>(m_hits) / total : 0.0;
+}
+
+void VehicleStateCache::resetStatistics()
+{
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 VehicleStateCache::estimateCost(const QList<VehicleDataModel::VehicleState>& states)
+{
+    // 槽位 + 每个状态的结构体大小 + 字符串内容（UTF-16）
+    qint64 cost = sizeof(Slot);
+    for (const auto& state : states) {
+        cost += sizeof(VehicleDataModel::VehicleState);
+        cost += (state.plateNumber.size() + state.color.size()) * sizeof(QChar);
+    }
+    return cost;
+}
+
+int VehicleStateCache::findSlot(quint64 packedKey) const
+{
+    const int mask = m_slots.size() - 1;
+    int index = homeSlot(packedKey);
+    while (true) {
+        const quint64 slotKey = m_slots.at(index).key;
+        if (slotKey == packedKey) {
+            return index;
+        }
+        if (slotKey == EMPTY_KEY) {
+            return -1;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+void VehicleStateCache::removeAt(int index)
+{
+    const int mask = m_slots.size() - 1;
+    m_memoryUsed -= m_slots.at(index).cost;
+    m_count--;
+
+    // 回移删除：把探测链上后续条目前移填补空位，查找时无需墓碑
+    int hole = index;
+    int next = index;
+    while (true) {
+        next = (next + 1) & mask;
+        if (m_slots.at(next).key == EMPTY_KEY) {
+            break;
+        }
+        int home = homeSlot(m_slots.at(next).key);
+        bool stays = (hole <= next) ? (hole < home && home <= next)
+                                    : (hole < home || home <= next);
+        if (!stays) {
+            m_slots[hole] = std::move(m_slots[next]);
+            hole = next;
+        }
+    }
+    m_slots[hole] = Slot();
+}
+
+void VehicleStateCache::evictOne()
+{
+    // CLOCK：访问位为真则清零放过，否则淘汰；最多转两圈
+    const int mask = m_slots.size() - 1;
+    while (true) {
+        Slot& slot = m_slots[m_clockHand];
+        if (slot.key != EMPTY_KEY) {
+            if (!slot.referenced) {
+                removeAt(m_clockHand); // 指针不前进：回移可能把下一个条目移到当前位置
+                return;
+            }
+            slot.referenced = false;
+        }
+        m_clockHand = (m_clockHand + 1) & mask;
+    }
+}
+
+void VehicleStateCache::rehash(int newCapacity)
+{
+    QVector<Slot> oldSlots = std::move(m_slots);
+    m_slots = QVector<Slot>(newCapacity);
+    m_clockHand = 0;
+
+    const int mask = newCapacity - 1;
+    for (Slot& slot : oldSlots) {
+        if (slot.key == EMPTY_KEY) {
+            continue;
+        }
+        int index = homeSlot(slot.key);
+        while (m_slots.at(index).key != EMPTY_KEY) {
+            index = (index + 1) & mask;
+        }
+        m_slots[index] = std::move(slot);
+    }
+}
+
+quint64 VehicleStateCache::mixKey(quint64 key)
+{
+    // splitmix64 终结函数：相邻分钟和相邻车辆ID分散到不同槽位
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
@@ -0,0 +1,98 @@
+#ifndef VEHICLESTATECACHE_H
+#define VEHICLESTATECACHE_H
+
+#include <QObject>
+#include <QSet>
+#include <QVector>
+#include "VehicleDataModel.h"
+
+/**
+ * @class VehicleStateCache
+ * @brief 车辆状态缓存，按 (车辆ID, 时间桶) 索引，按内存预算做 CLOCK（近似 LRU）淘汰
+ *
+ * VehicleDataModel 和 VehicleAnimationEngine 共用同一个实例：
+ * - 数据模型按 (AllVehicles, 分钟) 缓存某一时刻所有车辆的状态
+ * - 动画引擎按 (车辆ID, 分钟) 缓存单车插值结果
+ *
+ * 超出预算时只淘汰最久未使用的条目，回放中的热点时间窗口保持常驻，
+ * 不会再出现整表清空后的集中未命中。
+ *
+ * 键打包为 64 位整数 (vehicleId << 32 | 时间桶)，存放在线性探测的扁平数组中，
+ * 删除采用回移而非墓碑。命中路径不分配内存，动画每帧查询在稳定状态下零分配。
+ */
+class VehicleStateCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int AllVehicles = -1;
+
+    struct Key {
+        int vehicleId;      // VehicleDataModel 的车辆 id（从 0 开始），或 AllVehicles
+        qint64 timeBucket;  // 分钟时间桶（自纪元起的分钟数）
+
+        bool operator==(const Key& other) const {
+            return vehicleId == other.vehicleId && timeBucket == other.timeBucket;
+        }
+    };
+
+    explicit VehicleStateCache(QObject *parent = nullptr);
+
+    /**
+     * @brief 查找缓存，命中时置访问位
+     * @return 命中返回 true 并写入 states
+     */
+    bool lookup(const Key& key, QList<VehicleDataModel::VehicleState>& states);
+    void insert(const Key& key, const QList<VehicleDataModel::VehicleState>& states);
+    void clear();
+    // 删除这些车辆（可含 AllVehicles）的全部条目，其他车辆的条目保留
+    void removeVehicles(const QSet<int>& vehicleIds);
+
+    // 内存预算（字节），按条目估算大小计入
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    qint64 memoryUsed() const { return m_memoryUsed; }
+    int entryCount() const { return m_count; }
+
+    // 命中统计
+    quint64 hitCount() const { return m_hits; }
+    quint64 missCount() const { return m_misses; }
+    double hitRate() const;
+    void resetStatistics();
+
+    static qint64 estimateCost(const QList<VehicleDataModel::VehicleState>& states);
+
+    static quint64 packKey(const Key& key) {
+        return (quint64(quint32(key.vehicleId)) << 32) | quint32(key.timeBucket);
+    }
+
+private:
+    struct Slot {
+        quint64 key = EMPTY_KEY;
+        QList<VehicleDataModel::VehicleState> states;
+        qint64 cost = 0;
+        bool referenced = false;  // CLOCK 访问位
+    };
+
+    int findSlot(quint64 packedKey) const;
+    void removeAt(int index);
+    void evictOne();
+    void rehash(int newCapacity);
+    int homeSlot(quint64 packedKey) const { return int(mixKey(packedKey) & quint64(m_slots.size() - 1)); }
+
+    static quint64 mixKey(quint64 key);
+
+    QVector<Slot> m_slots;       // 容量为 2 的幂，负载不超过一半
+    int m_count = 0;
+    int m_clockHand = 0;
+    qint64 m_memoryUsed = 0;
+    qint64 m_memoryBudget;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+
+    static constexpr quint64 EMPTY_KEY = ~quint64(0); // (AllVehicles, 0xFFFFFFFF) 不会出现
+    static constexpr int INITIAL_CAPACITY = 4096;
+    static constexpr qint64 DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024; // 32MB
+};
+
+#endif // VEHICLESTATECACHE_H
@@ -0,0 +1,522 @@
+#include "WorksheetReader.h"
+#include "ErrorHandler.h"
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+enum class CellType { Number, SharedString, InlineString, String, Boolean, Error, Date };
+
+struct Tag {
+    const char* name = nullptr;         // 已去掉命名空间前缀
+    qsizetype nameLength = 0;
+    const char* attributes = nullptr;
+    const char* attributesEnd = nullptr;
+    bool closing = false;
+    bool selfClosing = false;
+
+    bool is(const char* localName) const
+    {
+        return nameLength == static_cast<qsizetype>(strlen(localName)) && memcmp(name, localName, nameLength) == 0;
+    }
+};
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const char* findChar(const char* p, const char* end, char c)
+{
+    const void* found = memchr(p, c, static_cast<size_t>(end - p));
+    return found ? static_cast<const char*>(found) : end;
+}
+
+int parseInt(const char* p, const char* end)
+{
+    int value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        value = value * 10 + (*p - '0');
+    }
+    return value;
+}
+
+// "AB12" -> 行 12、列 28；缺少行号或列号时对应输出为 0
+void parseCellReference(const char* p, const char* end, int& row, int& column)
+{
+    column = 0;
+    for (; p < end && *p >= 'A' && *p <= 'Z'; ++p) {
+        column = column * 26 + (*p - 'A' + 1);
+    }
+    row = parseInt(p, end);
+}
+
+// 解码文本中的实体引用；绝大多数单元格不含 '&'，直接转换
+QString decodeText(const char* begin, const char* end)
+{
+    if (findChar(begin, end, '&') == end) {
+        return QString::fromUtf8(begin, end - begin);
+    }
+
+    QByteArray decoded;
+    decoded.reserve(end - begin);
+    for (const char* p = begin; p < end;) {
+        if (*p != '&') {
+            decoded.append(*p++);
+            continue;
+        }
+        const char* semicolon = findChar(p, end, ';');
+        if (semicolon == end) {
+            decoded.append(p, end - p);
+            break;
+        }
+        const QByteArray entity = QByteArray::fromRawData(p + 1, semicolon - p - 1);
+        if (entity == "lt") {
+            decoded.append('<');
+        } else if (entity == "gt") {
+            decoded.append('>');
+        } else if (entity == "amp") {
+            decoded.append('&');
+        } else if (entity == "quot") {
+            decoded.append('"');
+        } else if (entity == "apos") {
+            decoded.append('\'');
+        } else if (entity.startsWith('#')) {
+            bool ok = false;
+            const char32_t code = entity.startsWith("#x") ? entity.mid(2).toUInt(&ok, 16)
+                                                          : entity.mid(1).toUInt(&ok, 10);
+            if (ok) {
+                decoded.append(QString::fromUcs4(&code, 1).toUtf8());
+            } else {
+                decoded.append(p, semicolon - p + 1);
+            }
+        } else {
+            decoded.append(p, semicolon - p + 1);
+        }
+        p = semicolon + 1;
+    }
+    return QString::fromUtf8(decoded);
+}
+
+// 从 '<' 读取一个标签，返回标签之后的位置；注释和处理指令的 nameLength 为 0
+const char* readTag(const char* p, const char* end, Tag& tag)
+{
+    tag = Tag();
+    ++p;
+    if (p < end && (*p == '!' || *p == '?')) {
+        if (end - p >= 3 && memcmp(p, "!--", 3) == 0) {
+            static const char commentEnd[] = "-->";
+            const char* close = std::search(p + 3, end, commentEnd, commentEnd + 3);
+            return close == end ? end : close + 3;
+        }
+        const char* close = findChar(p, end, '>');
+        return close == end ? end : close + 1;
+    }
+
+    if (p < end && *p == '/') {
+        tag.closing = true;
+        ++p;
+    }
+    const char* nameBegin = p;
+    while (p < end && !isSpace(*p) && *p != '>' && *p != '/') {
+        ++p;
+    }
+    const char* colon = findChar(nameBegin, p, ':');
+    tag.name = colon == p ? nameBegin : colon + 1;
+    tag.nameLength = p - tag.name;
+
+    // 属性值中允许出现 '>'，跳过引号内的内容
+    tag.attributes = p;
+    char quote = 0;
+    for (; p < end; ++p) {
+        if (quote) {
+            if (*p == quote) {
+                quote = 0;
+            }
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
+        } else if (*p == '>') {
+            break;
+        }
+    }
+    tag.attributesEnd = p;
+    if (p > tag.attributes && p[-1] == '/') {
+        tag.selfClosing = true;
+        tag.attributesEnd = p - 1;
+    }
+    return p < end ? p + 1 : end;
+}
+
+// 查找不带前缀的属性，输出未解码的属性值
+bool findAttribute(const Tag& tag, const char* name, const char*& valueBegin, const char*& valueEnd)
+{
+    const qsizetype nameLength = static_cast<qsizetype>(strlen(name));
+    const char* p = tag.attributes;
+    const char* end = tag.attributesEnd;
+    while (p < end) {
+        while (p < end && isSpace(*p)) {
+            ++p;
+        }
+        const char* attributeBegin = p;
+        while (p < end && *p != '=' && !isSpace(*p)) {
+            ++p;
+        }
+        const char* attributeEnd = p;
+        while (p < end && (isSpace(*p) || *p == '=')) {
+            ++p;
+        }
+        if (p >= end || (*p != '"' && *p != '\'')) {
+            return false;
+        }
+        const char quote = *p++;
+        const char* value = p;
+        p = findChar(p, end, quote);
+        if (attributeEnd - attributeBegin == nameLength && memcmp(attributeBegin, name, nameLength) == 0) {
+            valueBegin = value;
+            valueEnd = p;
+            return true;
+        }
+        ++p;
+    }
+    return false;
+}
+
+CellType parseCellType(const char* p, const char* end)
+{
+    const QByteArray type = QByteArray::fromRawData(p, end - p);
+    if (type == "s") {
+        return CellType::SharedString;
+    } else if (type == "inlineStr") {
+        return CellType::InlineString;
+    } else if (type == "str") {
+        return CellType::String;
+    } else if (type == "b") {
+        return CellType::Boolean;
+    } else if (type == "e") {
+        return CellType::Error;
+    } else if (type == "d") {
+        return CellType::Date;
+    }
+    return CellType::Number;
+}
+
+QVariant cellValue(CellType type, const char* valueBegin, const char* valueEnd,
+                   const QString& inlineText, bool hasInlineText, const QStringList& sharedStrings)
+{
+    if (type == CellType::InlineString) {
+        return hasInlineText ? QVariant(inlineText) : QVariant();
+    }
+    if (!valueBegin || valueBegin == valueEnd) {
+        return QVariant();
+    }
+
+    switch (type) {
+        case CellType::SharedString: {
+            const int index = parseInt(valueBegin, valueEnd);
+            return index < sharedStrings.size() ? QVariant(sharedStrings[index]) : QVariant();
+        }
+        case CellType::Boolean:
+            return QVariant(*valueBegin == '1');
+        case CellType::String:
+        case CellType::Error:
+        case CellType::Date:
+            return QVariant(decodeText(valueBegin, valueEnd));
+        default: {
+            bool ok = false;
+            const double number = QByteArray::fromRawData(valueBegin, valueEnd - valueBegin).toDouble(&ok);
+            return ok ? QVariant(number) : QVariant(decodeText(valueBegin, valueEnd));
+        }
+    }
+}
+
+} // namespace
+
+bool WorksheetReader::open(const QString& filePath, QString& errorMessage)
+{
+    m_sheetEntry = nullptr;
+    m_sharedStrings.clear();
+    m_rowTag = "<row";
+    m_lastRow = 0;
+    m_lastColumn = 0;
+    m_bytesRead = 0;
+
+    if (!m_archive.open(filePath, errorMessage)) {
+        return false;
+    }
+
+    m_sheetEntry = m_archive.findEntry(m_archive.firstWorksheetPath());
+    if (!m_sheetEntry) {
+        errorMessage = HANDLE_DATA_ERROR(QFileInfo(filePath).fileName(), "Excel文件中没有找到工作表");
+        return false;
+    }
+    return loadSharedStrings(errorMessage);
+}
+
+bool WorksheetReader::loadSharedStrings(QString& errorMessage)
+{
+    // 全部为数字的工作簿没有共享字符串表
+    const XlsxArchive::Entry* entry = m_archive.findEntry("xl/sharedStrings.xml");
+    if (!entry) {
+        return true;
+    }
+
+    QByteArray buffer;
+    if (!m_archive.readEntry(*entry, buffer, errorMessage)) {
+        return false;
+    }
+
+    // 富文本由多个 <r><t> 组成；<rPh> 中的注音文字不属于单元格内容
+    QXmlStreamReader xml(buffer);
+    QString text;
+    int phoneticDepth = 0;
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            if (xml.name() == QLatin1String("sst")) {
+                m_sharedStrings.reserve(xml.attributes().value("uniqueCount").toInt());
+            } else if (xml.name() == QLatin1String("si")) {
+                text.clear();
+            } else if (xml.name() == QLatin1String("rPh")) {
+                phoneticDepth++;
+            } else if (xml.name() == QLatin1String("t") && phoneticDepth == 0) {
+                text += xml.readElementText();
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            if (xml.name() == QLatin1String("si")) {
+                m_sharedStrings.append(text);
+            } else if (xml.name() == QLatin1String("rPh")) {
+                phoneticDepth--;
+            }
+        }
+    }
+
+    if (xml.hasError()) {
+        errorMessage = HANDLE_DATA_ERROR(QFileInfo(m_archive.filePath()).fileName(),
+                                         QString("共享字符串表解析失败: %1").arg(xml.errorString()));
+        return false;
+    }
+    return true;
+}
+
+bool WorksheetReader::parseSheetPrefix(const QByteArray& data)
+{
+    const qsizetype sheetData = data.indexOf("sheetData");
+    if (sheetData < 0) {
+        return false;
+    }
+
+    // <sheetData> 与 <row> 使用相同的命名空间前缀
+    const qsizetype tagStart = data.lastIndexOf('<', sheetData);
+    m_rowTag = "<" + data.mid(tagStart + 1, sheetData - tagStart - 1) + "row";
+
+    // <dimension ref="A1:K12345"/> 位于 <sheetData> 之前
+    const qsizetype dimension = data.lastIndexOf("dimension", sheetData);
+    const qsizetype ref = dimension < 0 ? -1 : data.indexOf("ref=", dimension);
+    if (ref >= 0 && ref + 5 < sheetData) {
+        const char* begin = data.constData() + ref + 5;
+        const char* end = findChar(begin, data.constData() + sheetData, data.at(ref + 4));
+        const char* separator = findChar(begin, end, ':');
+        parseCellReference(separator == end ? begin : separator + 1, end, m_lastRow, m_lastColumn);
+    }
+    return true;
+}
+
+qsizetype WorksheetReader::lastRowStart(const QByteArray& data, qsizetype before) const
+{
+    // 标签名之后至少还要有一个字符，才能排除 <rowBreaks> 等同前缀的元素
+    qsizetype from = qMin(before - 1, data.size() - m_rowTag.size() - 1);
+    while (from >= 0) {
+        const qsizetype pos = data.lastIndexOf(m_rowTag, from);
+        if (pos < 0) {
+            return -1;
+        }
+        const char next = data.at(pos + m_rowTag.size());
+        if (isSpace(next) || next == '>' || next == '/') {
+            return pos;
+        }
+        from = pos - 1;
+    }
+    return -1;
+}
+
+int WorksheetReader::lastRowNumber(const QByteArray& data, int previousRow) const
+{
+    // 通常每行都带 r 属性，只需读最后一行；缺省时向前数到带 r 的行或块首
+    const char* end = data.constData() + data.size();
+    int uncounted = 0;
+    for (qsizetype pos = lastRowStart(data, data.size()); pos >= 0; pos = lastRowStart(data, pos)) {
+        Tag tag;
+        readTag(data.constData() + pos, end, tag);
+        const char* attributeBegin = nullptr;
+        const char* attributeEnd = nullptr;
+        if (findAttribute(tag, "r", attributeBegin, attributeEnd)) {
+            return parseInt(attributeBegin, attributeEnd) + uncounted;
+        }
+        uncounted++;
+    }
+    return previousRow + uncounted;
+}
+
+bool WorksheetReader::readChunks(qsizetype targetSize, const ChunkHandler& handler, QString& errorMessage)
+{
+    if (!m_sheetEntry) {
+        errorMessage = HANDLE_DATA_ERROR(QFileInfo(m_archive.filePath()).fileName(), "Excel文件中没有找到工作表");
+        return false;
+    }
+
+    m_bytesRead = 0;
+    QByteArray pending;
+    pending.reserve(targetSize + XlsxArchive::CHUNK_SIZE);
+    bool prefixParsed = false;
+    bool stopped = false;
+    int previousRow = 0;    // 已切出的块中最后一行的行号
+
+    const bool read = m_archive.readEntry(*m_sheetEntry, [&](const char* data, qsizetype size) {
+        pending.append(data, size);
+        m_bytesRead += size;
+        if (!prefixParsed) {
+            prefixParsed = parseSheetPrefix(pending);
+        }
+        if (!prefixParsed || pending.size() < targetSize) {
+            return true;
+        }
+
+        const qsizetype cut = lastRowStart(pending, pending.size());
+        if (cut <= 0) {
+            return true;    // 单行超过块大小，继续累积
+        }
+
+        // 切出的块直接交给调用方，只把末尾不完整的一行移到新缓冲区
+        QByteArray chunk;
+        chunk.swap(pending);
+        pending.reserve(targetSize + XlsxArchive::CHUNK_SIZE);
+        pending.append(chunk.constData() + cut, chunk.size() - cut);
+        chunk.truncate(cut);
+        const int chunkPreviousRow = previousRow;
+        previousRow = lastRowNumber(chunk, previousRow);
+        if (!handler(chunk, chunkPreviousRow)) {
+            stopped = true;
+            return false;
+        }
+        return true;
+    }, errorMessage);
+    if (!read) {
+        return false;
+    }
+
+    if (!stopped && !pending.isEmpty()) {
+        if (!prefixParsed) {
+            parseSheetPrefix(pending);
+        }
+        handler(pending, previousRow);
+    }
+    return true;
+}
+
+void WorksheetReader::parseRows(const QByteArray& chunk, int previousRow, const QStringList& sharedStrings,
+                                int maxColumn, const RowHandler& handler)
+{
+    const char* p = chunk.constData();
+    const char* end = p + chunk.size();
+
+    RowCells cells;
+    int row = previousRow;
+    int column = 0;
+    bool inRow = false;
+    bool inCell = false;
+    bool inInlineString = false;
+    int phoneticDepth = 0;
+
+    CellType cellType = CellType::Number;
+    const char* valueBegin = nullptr;
+    const char* valueEnd = nullptr;
+    QString inlineText;
+    bool hasInlineText = false;
+
+    Tag tag;
+    while (p < end) {
+        p = findChar(p, end, '<');
+        if (p == end) {
+            break;
+        }
+        p = readTag(p, end, tag);
+        if (tag.nameLength == 0) {
+            continue;
+        }
+
+        if (tag.is("row")) {
+            if (!tag.closing) {
+                const char* attributeBegin = nullptr;
+                const char* attributeEnd = nullptr;
+                row = findAttribute(tag, "r", attributeBegin, attributeEnd)
+                      ? parseInt(attributeBegin, attributeEnd) : row + 1;
+                cells.resize(0);    // 保留容量，整块复用
+                column = 0;
+                inRow = !tag.selfClosing;
+                if (tag.selfClosing && !handler(row, cells)) {
+                    return;
+                }
+            } else if (inRow) {
+                inRow = false;
+                if (!handler(row, cells)) {
+                    return;
+                }
+            }
+        } else if (!inRow) {
+            continue;
+        } else if (tag.is("c")) {
+            if (!tag.closing) {
+                const char* attributeBegin = nullptr;
+                const char* attributeEnd = nullptr;
+                int referenceRow = 0;
+                int referenceColumn = 0;
+                if (findAttribute(tag, "r", attributeBegin, attributeEnd)) {
+                    parseCellReference(attributeBegin, attributeEnd, referenceRow, referenceColumn);
+                }
+                column = referenceColumn > 0 ? referenceColumn : column + 1;
+                cellType = findAttribute(tag, "t", attributeBegin, attributeEnd)
+                           ? parseCellType(attributeBegin, attributeEnd) : CellType::Number;
+                valueBegin = nullptr;
+                valueEnd = nullptr;
+                inlineText.clear();
+                hasInlineText = false;
+                inCell = !tag.selfClosing;
+            } else if (inCell) {
+                inCell = false;
+                if (maxColumn > 0 && column > maxColumn) {
+                    continue;
+                }
+                const QVariant value = cellValue(cellType, valueBegin, valueEnd,
+                                                 inlineText, hasInlineText, sharedStrings);
+                if (value.isValid()) {
+                    if (cells.size() < column) {
+                        cells.resize(column);
+                    }
+                    cells[column - 1] = value;
+                }
+            }
+        } else if (!inCell) {
+            continue;
+        } else if (tag.is("v")) {
+            // 公式单元格的 <f> 会被跳过，只取缓存的计算结果
+            if (!tag.closing && !tag.selfClosing) {
+                valueBegin = p;
+                valueEnd = findChar(p, end, '<');
+                p = valueEnd;
+            }
+        } else if (tag.is("is")) {
+            inInlineString = !tag.closing && !tag.selfClosing;
+            hasInlineText = true;
+        } else if (tag.is("rPh")) {
+            phoneticDepth += tag.selfClosing ? 0 : (tag.closing ? -1 : 1);
+        } else if (tag.is("t")) {
+            if (inInlineString && phoneticDepth == 0 && !tag.closing && !tag.selfClosing) {
+                const char* textEnd = findChar(p, end, '<');
+                inlineText += decodeText(p, textEnd);
+                p = textEnd;
+            }
+        }
+    }
+}
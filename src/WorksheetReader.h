@@ -0,0 +1,83 @@
+#ifndef WORKSHEETREADER_H
+#define WORKSHEETREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QVariant>
+#include <functional>
+#include "XlsxArchive.h"
+
+/**
+ * @class WorksheetReader
+ * @brief 不经过 QXlsx 读取 xlsx 第一个工作表的单元格，支持按行分块并行解析
+ *
+ * - 共享字符串表在 open() 时解析一次，之后只读，可被多个解析线程同时使用
+ * - readChunks() 流式解压工作表 XML，在 <row> 起始处切成约 targetSize 字节的块，
+ *   块之间不重叠、按行号顺序交给调用方，同时给出前一块最后一行的行号，
+ *   省略了 r 属性的行按它顺延编号
+ * - parseRows() 是无状态的静态函数，只做轻量扫描（row / c / v / is / t），
+ *   不构建 DOM，也不要求块是完整的 XML 文档
+ *
+ * 单元格值与 QXlsx 的 read() 基本一致：字符串、数字（double）、布尔；
+ * 日期样式的数字保持为 Excel 序列日期，由调用方按数字解析。
+ *
+ * @see XlsxArchive
+ * @see ExcelDataReader
+ */
+class WorksheetReader
+{
+public:
+    using RowCells = QVector<QVariant>;     // 下标为列号 - 1，缺失的单元格为空 QVariant
+    // 每解析出一行回调一次，返回 false 停止解析
+    using RowHandler = std::function<bool(int row, const RowCells& cells)>;
+    // 每切出一块回调一次（在调用 readChunks 的线程中），返回 false 停止读取；
+    // previousRow 为之前各块最后一行的行号，第一块为 0
+    using ChunkHandler = std::function<bool(const QByteArray& chunk, int previousRow)>;
+
+    bool open(const QString& filePath, QString& errorMessage);
+
+    // <dimension> 给出的范围，工作表没有该元素时为 0
+    int lastRow() const { return m_lastRow; }
+    int lastColumn() const { return m_lastColumn; }
+
+    // 工作表 XML 解压后的大小和已解压的字节数，用于估算进度
+    qint64 sheetSize() const { return m_sheetEntry ? m_sheetEntry->uncompressedSize : 0; }
+    qint64 bytesRead() const { return m_bytesRead; }
+
+    const QStringList& sharedStrings() const { return m_sharedStrings; }
+
+    bool readChunks(qsizetype targetSize, const ChunkHandler& handler, QString& errorMessage);
+
+    /**
+     * @brief 解析一块工作表 XML 中的所有行
+     * @param chunk readChunks() 切出的块
+     * @param previousRow readChunks() 给出的前一行行号，块中没有 r 属性的行从它开始顺延
+     * @param sharedStrings 共享字符串表（只读）
+     * @param maxColumn 只解析不超过该列的单元格，0 表示全部
+     * @param handler 每行回调一次
+     *
+     * @note 可在任意线程中并发调用
+     */
+    static void parseRows(const QByteArray& chunk, int previousRow, const QStringList& sharedStrings,
+                          int maxColumn, const RowHandler& handler);
+
+private:
+    bool loadSharedStrings(QString& errorMessage);
+    bool parseSheetPrefix(const QByteArray& data);
+    // before 之前最后一个 <row> 的起始位置，没有时返回 -1
+    qsizetype lastRowStart(const QByteArray& data, qsizetype before) const;
+    // 块中最后一行的行号
+    int lastRowNumber(const QByteArray& data, int previousRow) const;
+
+    XlsxArchive m_archive;
+    const XlsxArchive::Entry* m_sheetEntry = nullptr;
+    QStringList m_sharedStrings;
+    QByteArray m_rowTag = "<row";           // 带命名空间前缀时为 "<x:row"
+    int m_lastRow = 0;
+    int m_lastColumn = 0;
+    qint64 m_bytesRead = 0;
+};
+
+#endif // WORKSHEETREADER_H
@@ -0,0 +1,392 @@
+#include "XlsxArchive.h"
+#include "ErrorHandler.h"
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <QtEndian>
+#include <cstring>
+#include <QDebug>
+
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#else
+#include <QtZlib/zlib.h>
+#endif
+
+namespace {
+
+const quint32 LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const quint32 CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const quint32 END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+const quint32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+const quint32 ZIP64_END_OF_DIRECTORY_SIGNATURE = 0x06064b50;
+const int END_OF_DIRECTORY_SIZE = 22;
+const int MAX_COMMENT_SIZE = 0xFFFF;
+const qint64 MAX_INFLATE_STEP = 1 << 30;    // z_stream 的长度字段是 32 位
+
+quint16 readU16(const uchar* p) { return qFromLittleEndian<quint16>(p); }
+quint32 readU32(const uchar* p) { return qFromLittleEndian<quint32>(p); }
+quint64 readU64(const uchar* p) { return qFromLittleEndian<quint64>(p); }
+
+} // namespace
+
+XlsxArchive::~XlsxArchive()
+{
+    close();
+}
+
+bool XlsxArchive::open(const QString& filePath, QString& errorMessage)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "读取");
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < END_OF_DIRECTORY_SIZE) {
+        errorMessage = HANDLE_DATA_ERROR(QFileInfo(filePath).fileName(), "文件不是有效的xlsx（zip）格式");
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        errorMessage = HANDLE_FILE_ERROR(filePath, "映射");
+        close();
+        return false;
+    }
+
+    if (!readCentralDirectory(errorMessage)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void XlsxArchive::close()
+{
+    if (m_data) {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_entries.clear();
+    m_entryIndex.clear();
+}
+
+QStringList XlsxArchive::entryNames() const
+{
+    QStringList names;
+    names.reserve(m_entries.size());
+    for (const Entry& entry : m_entries) {
+        names.append(entry.name);
+    }
+    return names;
+}
+
+const XlsxArchive::Entry* XlsxArchive::findEntry(const QString& name) const
+{
+    auto it = m_entryIndex.constFind(name);
+    return it == m_entryIndex.cend() ? nullptr : &m_entries[it.value()];
+}
+
+bool XlsxArchive::readCentralDirectory(QString& errorMessage)
+{
+    const QString fileName = QFileInfo(m_file.fileName()).fileName();
+
+    // 中央目录结束记录在文件末尾，后面最多跟 64KB 注释
+    qint64 endOffset = -1;
+    const qint64 searchStart = m_size - END_OF_DIRECTORY_SIZE;
+    const qint64 searchEnd = qMax<qint64>(0, searchStart - MAX_COMMENT_SIZE);
+    for (qint64 offset = searchStart; offset >= searchEnd; --offset) {
+        if (readU32(m_data + offset) == END_OF_DIRECTORY_SIGNATURE) {
+            endOffset = offset;
+            break;
+        }
+    }
+    if (endOffset < 0) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, "文件不是有效的xlsx（zip）格式，找不到中央目录");
+        return false;
+    }
+
+    const uchar* end = m_data + endOffset;
+    qint64 entryCount = readU16(end + 10);
+    qint64 directorySize = readU32(end + 12);
+    qint64 directoryOffset = readU32(end + 16);
+
+    // ZIP64：字段溢出时从 ZIP64 结束记录读取实际值
+    if ((entryCount == 0xFFFF || directoryOffset == 0xFFFFFFFF) && endOffset >= 20 &&
+        readU32(end - 20) == ZIP64_LOCATOR_SIGNATURE) {
+        const qint64 zip64EndOffset = static_cast<qint64>(readU64(end - 20 + 8));
+        if (zip64EndOffset < 0 || zip64EndOffset > m_size - 56 ||
+            readU32(m_data + zip64EndOffset) != ZIP64_END_OF_DIRECTORY_SIGNATURE) {
+            errorMessage = HANDLE_DATA_ERROR(fileName, "ZIP64 中央目录损坏");
+            return false;
+        }
+        const uchar* zip64End = m_data + zip64EndOffset;
+        entryCount = static_cast<qint64>(readU64(zip64End + 32));
+        directorySize = static_cast<qint64>(readU64(zip64End + 40));
+        directoryOffset = static_cast<qint64>(readU64(zip64End + 48));
+    }
+
+    // 先比较再相加，ZIP64 中的 64 位字段相加可能溢出
+    if (directoryOffset < 0 || directorySize < 0 || directoryOffset > m_size ||
+        directorySize > m_size - directoryOffset) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, "中央目录超出文件范围，文件可能已损坏");
+        return false;
+    }
+
+    m_entries.reserve(static_cast<int>(qMin<qint64>(entryCount, 1 << 16)));
+    const uchar* p = m_data + directoryOffset;
+    const uchar* directoryEnd = p + directorySize;
+    for (qint64 i = 0; i < entryCount; ++i) {
+        if (p + 46 > directoryEnd || readU32(p) != CENTRAL_HEADER_SIGNATURE) {
+            errorMessage = HANDLE_DATA_ERROR(fileName, "中央目录条目损坏");
+            return false;
+        }
+
+        Entry entry;
+        entry.flags = readU16(p + 8);
+        entry.method = readU16(p + 10);
+        entry.compressedSize = readU32(p + 20);
+        entry.uncompressedSize = readU32(p + 24);
+        const quint16 nameLength = readU16(p + 28);
+        const quint16 extraLength = readU16(p + 30);
+        const quint16 commentLength = readU16(p + 32);
+        entry.localHeaderOffset = readU32(p + 42);
+
+        const uchar* name = p + 46;
+        const uchar* extra = name + nameLength;
+        const uchar* next = extra + extraLength + commentLength;
+        if (next > directoryEnd) {
+            errorMessage = HANDLE_DATA_ERROR(fileName, "中央目录条目损坏");
+            return false;
+        }
+        entry.name = QString::fromUtf8(reinterpret_cast<const char*>(name), nameLength);
+
+        // ZIP64 扩展字段按顺序只包含溢出的字段
+        for (const uchar* field = extra; field + 4 <= extra + extraLength;) {
+            const quint16 fieldId = readU16(field);
+            const quint16 fieldSize = readU16(field + 2);
+            const uchar* value = field + 4;
+            const uchar* valueEnd = value + fieldSize;
+            if (valueEnd > extra + extraLength) {
+                break;
+            }
+            if (fieldId == 0x0001) {
+                if (entry.uncompressedSize == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                    entry.uncompressedSize = static_cast<qint64>(readU64(value));
+                    value += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                    entry.compressedSize = static_cast<qint64>(readU64(value));
+                    value += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && value + 8 <= valueEnd) {
+                    entry.localHeaderOffset = static_cast<qint64>(readU64(value));
+                }
+                break;
+            }
+            field = valueEnd;
+        }
+
+        m_entryIndex.insert(entry.name, m_entries.size());
+        m_entries.append(entry);
+        p = next;
+    }
+    return true;
+}
+
+bool XlsxArchive::entryData(const Entry& entry, const uchar*& data, QString& errorMessage) const
+{
+    const QString fileName = QFileInfo(m_file.fileName()).fileName();
+
+    if (entry.flags & 0x0001) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 已加密，无法读取").arg(entry.name));
+        return false;
+    }
+    if (entry.method != 0 && entry.method != Z_DEFLATED) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 使用了不支持的压缩方式 %2")
+                                         .arg(entry.name).arg(entry.method));
+        return false;
+    }
+
+    // 存储条目按压缩大小读取映射区域，两个大小必须一致
+    if (entry.method == 0 && entry.compressedSize != entry.uncompressedSize) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 的存储大小与原始大小不一致，文件可能已损坏")
+                                         .arg(entry.name));
+        return false;
+    }
+    if (entry.compressedSize < 0 || entry.uncompressedSize < 0) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 的大小无效，文件可能已损坏").arg(entry.name));
+        return false;
+    }
+
+    // 本地文件头的扩展字段长度可能与中央目录不同，以本地头为准
+    const qint64 headerOffset = entry.localHeaderOffset;
+    if (headerOffset < 0 || headerOffset > m_size - 30 ||
+        readU32(m_data + headerOffset) != LOCAL_HEADER_SIGNATURE) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 的本地文件头损坏").arg(entry.name));
+        return false;
+    }
+    const qint64 dataOffset = headerOffset + 30 + readU16(m_data + headerOffset + 26) +
+                              readU16(m_data + headerOffset + 28);
+    if (dataOffset > m_size || entry.compressedSize > m_size - dataOffset) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 超出文件范围，文件可能已损坏").arg(entry.name));
+        return false;
+    }
+
+    data = m_data + dataOffset;
+    return true;
+}
+
+bool XlsxArchive::readEntry(const Entry& entry, const ChunkSink& sink, QString& errorMessage)
+{
+    const uchar* data = nullptr;
+    if (!entryData(entry, data, errorMessage)) {
+        return false;
+    }
+
+    if (entry.method == 0) {
+        // 存储条目直接交出映射区域
+        const char* p = reinterpret_cast<const char*>(data);
+        qint64 remaining = entry.compressedSize;
+        while (remaining > 0) {
+            const qsizetype size = static_cast<qsizetype>(qMin<qint64>(remaining, CHUNK_SIZE));
+            if (!sink(p, size)) {
+                return true;
+            }
+            p += size;
+            remaining -= size;
+        }
+        return true;
+    }
+
+    if (m_chunkBuffer.size() < CHUNK_SIZE) {
+        m_chunkBuffer.resize(CHUNK_SIZE);
+    }
+    return inflateEntry(entry, data, m_chunkBuffer.data(), CHUNK_SIZE, &sink, errorMessage);
+}
+
+bool XlsxArchive::readEntry(const Entry& entry, QByteArray& buffer, QString& errorMessage)
+{
+    const uchar* data = nullptr;
+    if (!entryData(entry, data, errorMessage)) {
+        return false;
+    }
+
+    // resize 不会缩小已有容量，同一个缓冲区读取多个文件时只在变大时重新分配
+    buffer.resize(static_cast<qsizetype>(entry.uncompressedSize));
+    if (entry.method == 0) {
+        memcpy(buffer.data(), data, static_cast<size_t>(entry.compressedSize));
+        return true;
+    }
+    return inflateEntry(entry, data, buffer.data(), buffer.size(), nullptr, errorMessage);
+}
+
+bool XlsxArchive::inflateEntry(const Entry& entry, const uchar* input, char* output, qsizetype outputSize,
+                               const ChunkSink* sink, QString& errorMessage)
+{
+    const QString fileName = QFileInfo(m_file.fileName()).fileName();
+
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {   // zip 中是不带 zlib 头的原始 deflate 流
+        errorMessage = HANDLE_MEMORY_ERROR("初始化解压");
+        return false;
+    }
+
+    const uchar* nextInput = input;
+    qint64 inputRemaining = entry.compressedSize;
+    char* outputPos = output;
+    qint64 outputRemaining = outputSize;
+    int status = Z_OK;
+
+    while (status != Z_STREAM_END) {
+        if (stream.avail_in == 0 && inputRemaining > 0) {
+            const uInt step = static_cast<uInt>(qMin(inputRemaining, MAX_INFLATE_STEP));
+            stream.next_in = const_cast<Bytef*>(nextInput);
+            stream.avail_in = step;
+            nextInput += step;
+            inputRemaining -= step;
+        }
+
+        // 流式读取每次从块缓冲区开头写；整体读取则接着上次的位置写
+        char* chunkStart = sink ? output : outputPos;
+        stream.next_out = reinterpret_cast<Bytef*>(chunkStart);
+        stream.avail_out = static_cast<uInt>(sink ? outputSize : qMin(outputRemaining, MAX_INFLATE_STEP));
+
+        status = inflate(&stream, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END) {
+            // Z_BUF_ERROR：输入已用完仍未结束，或解压结果超过声明大小
+            inflateEnd(&stream);
+            errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 解压失败（%2），文件可能已损坏")
+                                             .arg(entry.name).arg(status));
+            return false;
+        }
+
+        const qsizetype written = reinterpret_cast<char*>(stream.next_out) - chunkStart;
+        if (sink) {
+            if (written > 0 && !(*sink)(output, written)) {
+                inflateEnd(&stream);
+                return true;
+            }
+        } else {
+            outputPos += written;
+            outputRemaining -= written;
+        }
+    }
+
+    inflateEnd(&stream);
+    if (!sink && outputRemaining != 0) {
+        errorMessage = HANDLE_DATA_ERROR(fileName, QString("条目 %1 的解压大小与目录记录不一致").arg(entry.name));
+        return false;
+    }
+    return true;
+}
+
+QString XlsxArchive::firstWorksheetPath()
+{
+    const QString fallback = "xl/worksheets/sheet1.xml";
+    const Entry* workbookEntry = findEntry("xl/workbook.xml");
+    const Entry* relsEntry = findEntry("xl/_rels/workbook.xml.rels");
+    if (!workbookEntry || !relsEntry) {
+        return fallback;
+    }
+
+    // 工作簿和关系文件都很小，整体读取
+    QByteArray buffer;
+    QString errorMessage;
+    QString relationId;
+    if (readEntry(*workbookEntry, buffer, errorMessage)) {
+        QXmlStreamReader xml(buffer);
+        while (!xml.atEnd() && relationId.isEmpty()) {
+            if (xml.readNext() == QXmlStreamReader::StartElement && xml.name() == QLatin1String("sheet")) {
+                for (const QXmlStreamAttribute& attribute : xml.attributes()) {
+                    if (attribute.name() == QLatin1String("id")) {   // r:id
+                        relationId = attribute.value().toString();
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    if (relationId.isEmpty() || !readEntry(*relsEntry, buffer, errorMessage)) {
+        return fallback;
+    }
+
+    QXmlStreamReader xml(buffer);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement &&
+            xml.name() == QLatin1String("Relationship") &&
+            xml.attributes().value("Id") == relationId) {
+            const QString target = xml.attributes().value("Target").toString();
+            // 目标为绝对路径（/xl/...）或相对 xl/ 目录
+            const QString path = target.startsWith('/') ? target.mid(1) : "xl/" + target;
+            return findEntry(path) ? path : fallback;
+        }
+    }
+    return fallback;
+}
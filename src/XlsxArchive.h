@@ -0,0 +1,83 @@
+#ifndef XLSXARCHIVE_H
+#define XLSXARCHIVE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <functional>
+
+/**
+ * @class XlsxArchive
+ * @brief 只读的 XLSX（zip）容器：内存映射文件，直接读取中央目录，按块流式解压条目
+ *
+ * - 打开时只映射文件并解析文件末尾的中央目录（支持 ZIP64），不读取任何条目内容
+ * - 存储（未压缩）条目直接把映射区域交给调用方，零拷贝
+ * - deflate 条目的输入直接取自映射区域，输出写入可复用的缓冲区：
+ *   流式读取时每 CHUNK_SIZE 字节回调一次；整体读取时直接解压到调用方的 QByteArray，
+ *   同一个缓冲区在多个文件间复用不会重新分配
+ *
+ * 页缓存由内核维护，同一批文件重复打开时不会再走 QFile 读取路径。
+ * 每个实例只应在一个线程中使用；多线程读取同一文件时各自打开实例。
+ *
+ * @see ExcelDataReader
+ */
+class XlsxArchive
+{
+public:
+    struct Entry {
+        QString name;
+        quint16 method = 0;            // 0 = 存储, 8 = deflate
+        quint16 flags = 0;
+        qint64 compressedSize = 0;
+        qint64 uncompressedSize = 0;
+        qint64 localHeaderOffset = 0;
+    };
+
+    // 每解压出一块数据回调一次，返回 false 提前结束读取（不视为错误）
+    using ChunkSink = std::function<bool(const char* data, qsizetype size)>;
+
+    XlsxArchive() = default;
+    ~XlsxArchive();
+
+    XlsxArchive(const XlsxArchive&) = delete;
+    XlsxArchive& operator=(const XlsxArchive&) = delete;
+
+    bool open(const QString& filePath, QString& errorMessage);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString filePath() const { return m_file.fileName(); }
+
+    QStringList entryNames() const;
+    const Entry* findEntry(const QString& name) const;
+
+    // 流式读取条目
+    bool readEntry(const Entry& entry, const ChunkSink& sink, QString& errorMessage);
+    // 整体解压到 buffer（复用其已有容量）
+    bool readEntry(const Entry& entry, QByteArray& buffer, QString& errorMessage);
+
+    /**
+     * @brief 工作簿中第一个工作表的条目路径
+     * @return 例如 "xl/worksheets/sheet1.xml"；找不到关系时按约定返回 sheet1
+     */
+    QString firstWorksheetPath();
+
+    static constexpr qsizetype CHUNK_SIZE = 256 * 1024;
+
+private:
+    bool readCentralDirectory(QString& errorMessage);
+    bool entryData(const Entry& entry, const uchar*& data, QString& errorMessage) const;
+    bool inflateEntry(const Entry& entry, const uchar* input, char* output, qsizetype outputSize,
+                      const ChunkSink* sink, QString& errorMessage);
+
+    QFile m_file;
+    uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_entryIndex;
+    QByteArray m_chunkBuffer;           // 流式解压的输出块，跨条目复用
+};
+
+#endif // XLSXARCHIVE_H
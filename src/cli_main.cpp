@@ -0,0 +1,160 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+
+#include "BatchProcessor.h"
+#include "Tracer.h"
+
+// 解析 "纬度,经度,半径米" 形式的目标区域参数
+static bool parseVisitTarget(const QString& text, BatchProcessor::VisitTarget& target)
+{
+    QStringList parts = text.split(',');
+    if (parts.size() != 3) {
+        return false;
+    }
+
+    bool okLat = false, okLon = false, okRadius = false;
+    double lat = parts[0].trimmed().toDouble(&okLat);
+    double lon = parts[1].trimmed().toDouble(&okLon);
+    double radius = parts[2].trimmed().toDouble(&okRadius);
+    if (!okLat || !okLon || !okRadius || radius <= 0.0) {
+        return false;
+    }
+
+    target.center = QGeoCoordinate(lat, lon);
+    target.radiusMeters = radius;
+    return target.center.isValid();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    app.setApplicationName("carmove-cli");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("CarMove");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CarMove 批处理工具：批量解析车辆轨迹并输出转换结果与统计");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("folder", "包含车辆Excel数据的文件夹");
+
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                    "输出目录（默认：<folder>/carmove_output）", "dir");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                  "并行线程数（默认：全部核心）", "n");
+    QCommandLineOption gcjOption("gcj02", "输出轨迹转换为GCJ02（火星坐标）");
+    QCommandLineOption statsOnlyOption("stats-only", "只输出统计，不写轨迹文件");
+    QCommandLineOption visitOption("visit",
+                                   "统计到访天数的目标区域，可重复指定", "lat,lon,radiusMeters");
+    QCommandLineOption fuelOption("fuel", "卸油记录JSON，逐条与轨迹核对", "file");
+    QCommandLineOption fuelWindowOption("fuel-window", "卸油核对时间窗口（分钟，默认30）", "minutes");
+    QCommandLineOption fuelToleranceOption("fuel-tolerance", "卸油核对距离容差（米，默认500）", "meters");
+    QCommandLineOption traceOption("trace", "记录耗时追踪，结束时写出 Chrome Trace JSON（可用 Perfetto 打开）", "file");
+    QCommandLineOption regionsOption("regions", "行政区边界GeoJSON，输出每车每天所在的行政区", "file");
+    parser.addOption(outputOption);
+    parser.addOption(jobsOption);
+    parser.addOption(gcjOption);
+    parser.addOption(statsOnlyOption);
+    parser.addOption(visitOption);
+    parser.addOption(fuelOption);
+    parser.addOption(fuelWindowOption);
+    parser.addOption(fuelToleranceOption);
+    parser.addOption(regionsOption);
+    parser.addOption(traceOption);
+
+    parser.process(app);
+
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 1) {
+        parser.showHelp(1);
+    }
+
+    BatchProcessor::Options options;
+    options.inputFolder = QDir(positional.first()).absolutePath();
+    options.outputFolder = parser.isSet(outputOption)
+                           ? QDir(parser.value(outputOption)).absolutePath()
+                           : QDir(options.inputFolder).filePath("carmove_output");
+    options.convertToGcj02 = parser.isSet(gcjOption);
+    options.writeTrajectories = !parser.isSet(statsOnlyOption);
+
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        options.threadCount = parser.value(jobsOption).toInt(&ok);
+        if (!ok || options.threadCount < 1) {
+            qCritical().noquote() << "无效的线程数:" << parser.value(jobsOption);
+            return 1;
+        }
+    }
+
+    for (const QString& value : parser.values(visitOption)) {
+        BatchProcessor::VisitTarget target;
+        if (!parseVisitTarget(value, target)) {
+            qCritical().noquote() << "无效的目标区域参数:" << value;
+            return 1;
+        }
+        options.visitTargets.append(target);
+    }
+
+    if (parser.isSet(fuelOption)) {
+        options.fuelRecordsFile = QDir(parser.value(fuelOption)).absolutePath();
+    }
+    if (parser.isSet(fuelWindowOption)) {
+        bool ok = false;
+        int minutes = parser.value(fuelWindowOption).toInt(&ok);
+        if (!ok || minutes < 0) {
+            qCritical().noquote() << "无效的时间窗口:" << parser.value(fuelWindowOption);
+            return 1;
+        }
+        options.fuelTimeWindowSecs = minutes * 60LL;
+    }
+    if (parser.isSet(fuelToleranceOption)) {
+        bool ok = false;
+        options.fuelToleranceMeters = parser.value(fuelToleranceOption).toDouble(&ok);
+        if (!ok || options.fuelToleranceMeters <= 0.0) {
+            qCritical().noquote() << "无效的距离容差:" << parser.value(fuelToleranceOption);
+            return 1;
+        }
+    }
+
+    if (parser.isSet(regionsOption)) {
+        options.regionBoundariesFile = QDir(parser.value(regionsOption)).absolutePath();
+    }
+
+    const QString traceFile = parser.isSet(traceOption) ? QDir(parser.value(traceOption)).absolutePath() : QString();
+    Tracer::setEnabled(!traceFile.isEmpty());
+
+    BatchProcessor processor(options);
+
+    // 信号在工作线程中发出，使用直接连接输出进度
+    QObject::connect(&processor, &BatchProcessor::vehicleProcessed, &processor,
+                     [](const QString& plateNumber, int processed, int total) {
+        qInfo().noquote() << QString("[%1/%2] %3").arg(processed).arg(total).arg(plateNumber);
+    }, Qt::DirectConnection);
+    QObject::connect(&processor, &BatchProcessor::vehicleFailed, &processor,
+                     [](const QString& plateNumber, const QString& error) {
+        qWarning().noquote() << QString("车辆 %1 处理失败: %2").arg(plateNumber, error);
+    }, Qt::DirectConnection);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int exitCode = processor.run();
+
+    qInfo().noquote() << QString("完成，用时 %1 秒，输出目录：%2")
+                         .arg(timer.elapsed() / 1000.0, 0, 'f', 1)
+                         .arg(options.outputFolder);
+
+    if (!traceFile.isEmpty()) {
+        QString traceError;
+        if (Tracer::writeChromeTrace(traceFile, traceError)) {
+            qInfo().noquote() << "追踪已写入:" << traceFile;
+        } else {
+            qWarning().noquote() << traceError;
+        }
+    }
+
+    return exitCode;
+}
@@ -15,6 +15,12 @@
 #include "FuelUnloadingDataLoader.h"
 #include "ConfigManager.h"
 #include "TiandituGeocoder.h"
+#include "VehicleListModel.h"
+#include "FuelVehicleListModel.h"
+#include "AdminRegionListModel.h"
+#include "OfflineTileProvider.h"
+#include "Tracer.h"
+#include "PerformanceMonitor.h"
 
 int main(int argc, char *argv[])
 {
@@ -25,6 +31,18 @@ int main(int argc, char *argv[])
     app.setApplicationVersion("1.0.0");
     app.setOrganizationName("CarMove");
     
+    // 设置 CARMOVE_TRACE=<文件> 时从启动开始追踪，退出时写出 Chrome Trace JSON
+    const QString traceFile = qEnvironmentVariable("CARMOVE_TRACE");
+    if (!traceFile.isEmpty()) {
+        Tracer::setEnabled(true);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [traceFile]() {
+            QString errorMessage;
+            if (!Tracer::writeChromeTrace(traceFile, errorMessage)) {
+                qWarning().noquote() << errorMessage;
+            }
+        });
+    }
+    
     // Set Qt Quick style to Basic for better customization support
     QQuickStyle::setStyle("Material");
     
@@ -37,10 +55,17 @@ int main(int argc, char *argv[])
     qmlRegisterType<FuelUnloadingDataLoader>("CarMove", 1, 0, "FuelUnloadingDataLoader");
     qmlRegisterType<ConfigManager>("CarMove", 1, 0, "ConfigManager");
     qmlRegisterType<TiandituGeocoder>("CarMove", 1, 0, "TiandituGeocoder");
+    qmlRegisterType<AdminRegionListModel>("CarMove", 1, 0, "AdminRegionListModel");
 
     // Register uncreatable types (utility classes)
     qmlRegisterUncreatableType<CoordinateConverter>("CarMove", 1, 0, "CoordinateConverter", 
                                                    "CoordinateConverter is a utility class");
+    qmlRegisterUncreatableType<VehicleListModel>("CarMove", 1, 0, "VehicleListModel",
+                                                 "VehicleListModel is provided by MainController");
+    qmlRegisterUncreatableType<FuelVehicleListModel>("CarMove", 1, 0, "FuelVehicleListModel",
+                                                     "FuelVehicleListModel is provided by FuelUnloadingDataLoader");
+    qmlRegisterUncreatableType<OfflineTileProvider>("CarMove", 1, 0, "OfflineTileProvider",
+                                                    "OfflineTileProvider is provided by MainController");
     
     // Create QML engine
     QQmlApplicationEngine engine;
@@ -48,6 +73,10 @@ int main(int argc, char *argv[])
     // Create and register main controller
     MainController controller;
     engine.rootContext()->setContextProperty("controller", &controller);
+    
+    PerformanceMonitor performanceMonitor;
+    performanceMonitor.attach(&controller);
+    engine.rootContext()->setContextProperty("performanceMonitor", &performanceMonitor);
 
     TiandituGeocoder geocoder;
     engine.rootContext()->setContextProperty("geocoder", &geocoder);
@@ -0,0 +1,124 @@
+#ifndef MOCKGEOCODESERVER_H
+#define MOCKGEOCODESERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+
+/**
+ * @brief 测试用：在 127.0.0.1 上模拟天地图地名搜索 V2.0 服务
+ *
+ * 只应答 TiandituGeocoder 发出的 GET 请求（postStr 中的 keyWord），返回一条 POI，
+ * 名称即关键字。支持 keep-alive；可让每个关键字的前几次请求返回 503、给应答加延迟，
+ * 用于验证重试、限速和取消。
+ */
+class MockGeocodeServer
+{
+public:
+    MockGeocodeServer()
+    {
+        QObject::connect(&m_server, &QTcpServer::newConnection, [this] {
+            while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, [this, socket] { readRequests(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    bool listen() { return m_server.listen(QHostAddress::LocalHost); }
+
+    QUrl url() const
+    {
+        return QUrl(QStringLiteral("http://127.0.0.1:%1/v2/search").arg(m_server.serverPort()));
+    }
+
+    // 每个关键字的前 count 次请求返回 503
+    void setFailuresPerKeyWord(int count) { m_failuresPerKeyWord = count; }
+    void setResponseDelay(int milliseconds) { m_responseDelayMs = milliseconds; }
+
+    int requestCount() const { return m_requestCount; }
+    int requestCount(const QString& keyWord) const { return m_requestsByKeyWord.value(keyWord); }
+
+    void reset()
+    {
+        m_requestCount = 0;
+        m_requestsByKeyWord.clear();
+    }
+
+    static QByteArray replyBody(const QString& keyWord)
+    {
+        QJsonObject poi;
+        poi["lonlat"] = QStringLiteral("116.397,39.909");
+        poi["name"] = keyWord;
+        poi["address"] = QStringLiteral("模拟地址");
+
+        QJsonObject root;
+        root["status"] = QJsonObject{{"infocode", 1000}};
+        root["resultType"] = 1;
+        root["pois"] = QJsonArray{poi};
+        return QJsonDocument(root).toJson(QJsonDocument::Compact);
+    }
+
+private:
+    void readRequests(QTcpSocket* socket)
+    {
+        QByteArray buffer = socket->property("mockBuffer").toByteArray() + socket->readAll();
+        qsizetype headerEnd;
+        while ((headerEnd = buffer.indexOf("\r\n\r\n")) >= 0) {
+            const QByteArray requestLine = buffer.left(buffer.indexOf("\r\n"));
+            buffer.remove(0, headerEnd + 4);
+
+            const QList<QByteArray> parts = requestLine.split(' ');
+            const QByteArray target = parts.size() >= 2 ? parts.at(1) : QByteArray();
+            respond(socket, target);
+        }
+        socket->setProperty("mockBuffer", buffer);
+    }
+
+    void respond(QTcpSocket* socket, const QByteArray& target)
+    {
+        const QUrlQuery query(QUrl::fromEncoded("http://127.0.0.1" + target).query(QUrl::FullyEncoded));
+        const QJsonObject post = QJsonDocument::fromJson(
+            query.queryItemValue("postStr", QUrl::FullyDecoded).toUtf8()).object();
+        const QString keyWord = post["keyWord"].toString();
+
+        m_requestCount++;
+        const int attempt = ++m_requestsByKeyWord[keyWord];
+
+        QByteArray response;
+        if (attempt <= m_failuresPerKeyWord) {
+            response = "HTTP/1.1 503 Service Unavailable\r\n"
+                       "Content-Length: 0\r\n"
+                       "Connection: keep-alive\r\n\r\n";
+        } else {
+            const QByteArray body = replyBody(keyWord);
+            response = "HTTP/1.1 200 OK\r\n"
+                       "Content-Type: application/json\r\n"
+                       "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                       "Connection: keep-alive\r\n\r\n" + body;
+        }
+
+        if (m_responseDelayMs > 0) {
+            // 以 socket 为上下文，连接被客户端中止后不再写入
+            QTimer::singleShot(m_responseDelayMs, socket, [socket, response] { socket->write(response); });
+        } else {
+            socket->write(response);
+        }
+    }
+
+    QTcpServer m_server;
+    int m_failuresPerKeyWord = 0;
+    int m_responseDelayMs = 0;
+    int m_requestCount = 0;
+    QHash<QString, int> m_requestsByKeyWord;
+};
+
+#endif // MOCKGEOCODESERVER_H
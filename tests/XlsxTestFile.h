@@ -0,0 +1,112 @@
+#ifndef XLSXTESTFILE_H
+#define XLSXTESTFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QtEndian>
+
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#else
+#include <QtZlib/zlib.h>
+#endif
+
+/**
+ * @brief 测试用：把若干条目以存储方式（不压缩）写成 zip/xlsx 文件
+ *
+ * 只写本地文件头、中央目录和结束记录，足够 XlsxArchive 与 QXlsx 读取。
+ */
+namespace XlsxTestFile {
+
+using Entries = QList<QPair<QString, QByteArray>>;
+
+inline void appendU16(QByteArray& out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 2);
+}
+
+inline void appendU32(QByteArray& out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+
+inline bool write(const QString& filePath, const Entries& entries)
+{
+    QByteArray archive;
+    QByteArray directory;
+    for (const auto& entry : entries) {
+        const QByteArray name = entry.first.toUtf8();
+        const QByteArray& data = entry.second;
+        const quint32 crc = crc32(0, reinterpret_cast<const Bytef*>(data.constData()),
+                                  static_cast<uInt>(data.size()));
+        const quint32 offset = static_cast<quint32>(archive.size());
+
+        appendU32(archive, 0x04034b50);
+        appendU16(archive, 20);         // 所需版本
+        appendU16(archive, 0);          // 标志
+        appendU16(archive, 0);          // 存储
+        appendU32(archive, 0);          // 修改时间、日期
+        appendU32(archive, crc);
+        appendU32(archive, static_cast<quint32>(data.size()));
+        appendU32(archive, static_cast<quint32>(data.size()));
+        appendU16(archive, static_cast<quint16>(name.size()));
+        appendU16(archive, 0);
+        archive.append(name);
+        archive.append(data);
+
+        appendU32(directory, 0x02014b50);
+        appendU16(directory, 20);       // 创建版本
+        appendU16(directory, 20);
+        appendU16(directory, 0);
+        appendU16(directory, 0);
+        appendU32(directory, 0);
+        appendU32(directory, crc);
+        appendU32(directory, static_cast<quint32>(data.size()));
+        appendU32(directory, static_cast<quint32>(data.size()));
+        appendU16(directory, static_cast<quint16>(name.size()));
+        appendU16(directory, 0);        // 扩展字段
+        appendU16(directory, 0);        // 注释
+        appendU16(directory, 0);        // 磁盘号
+        appendU16(directory, 0);        // 内部属性
+        appendU32(directory, 0);        // 外部属性
+        appendU32(directory, offset);
+        directory.append(name);
+    }
+
+    const quint32 directoryOffset = static_cast<quint32>(archive.size());
+    archive.append(directory);
+    appendU32(archive, 0x06054b50);
+    appendU16(archive, 0);
+    appendU16(archive, 0);
+    appendU16(archive, static_cast<quint16>(entries.size()));
+    appendU16(archive, static_cast<quint16>(entries.size()));
+    appendU32(archive, static_cast<quint32>(directory.size()));
+    appendU32(archive, directoryOffset);
+    appendU16(archive, 0);
+
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(archive) == archive.size();
+}
+
+// 只有一个工作表的最小工作簿，rows 为 <sheetData> 中的内容
+inline bool writeWorksheet(const QString& filePath, const QByteArray& rows, const QByteArray& dimension = QByteArray())
+{
+    QByteArray sheet = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+                       "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">";
+    if (!dimension.isEmpty()) {
+        sheet += "<dimension ref=\"" + dimension + "\"/>";
+    }
+    sheet += "<sheetData>" + rows + "</sheetData></worksheet>";
+    return write(filePath, {{"xl/worksheets/sheet1.xml", sheet}});
+}
+
+} // namespace XlsxTestFile
+
+#endif // XLSXTESTFILE_H
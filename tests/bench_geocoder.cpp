@@ -0,0 +1,150 @@
+#include <QtTest>
+#include <QStandardPaths>
+#include "TiandituGeocoder.h"
+#include "MockGeocodeServer.h"
+
+// 批量地名搜索对本地模拟服务的吞吐量：令牌桶限速、503 重试、取消
+class BenchGeocoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void batchThroughput_data();
+    void batchThroughput();
+    void cancelBatchStopsRequests();
+
+private:
+    QList<TiandituGeocoder::BatchQuery> queries(int count);
+
+    MockGeocodeServer m_server;
+    int m_run = 0;  // 每轮使用不同的关键字，避免命中上一轮的缓存
+
+    static constexpr const char* REGION = "156110000";
+    static constexpr int BATCH_TIMEOUT_MS = 30000;
+};
+
+void BenchGeocoder::initTestCase()
+{
+    // 缓存文件写到测试专用目录
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_server.listen());
+}
+
+void BenchGeocoder::init()
+{
+    m_server.reset();
+    m_server.setFailuresPerKeyWord(0);
+    m_server.setResponseDelay(0);
+    m_run++;
+}
+
+QList<TiandituGeocoder::BatchQuery> BenchGeocoder::queries(int count)
+{
+    QList<TiandituGeocoder::BatchQuery> result;
+    for (int i = 0; i < count; ++i) {
+        result.append({QStringLiteral("站点%1-%2").arg(m_run).arg(i), QString::fromLatin1(REGION)});
+    }
+    return result;
+}
+
+void BenchGeocoder::batchThroughput_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("maxConcurrent");
+    QTest::addColumn<double>("requestsPerSecond");
+    QTest::addColumn<int>("burst");
+    QTest::addColumn<int>("failuresPerKeyWord");
+
+    QTest::newRow("unthrottled") << 400 << 8 << 100000.0 << 100000 << 0;
+    QTest::newRow("tokenBucket") << 100 << 4 << 50.0 << 10 << 0;
+    QTest::newRow("retryOn503") << 100 << 8 << 100000.0 << 100000 << 1;
+}
+
+void BenchGeocoder::batchThroughput()
+{
+    QFETCH(int, count);
+    QFETCH(int, maxConcurrent);
+    QFETCH(double, requestsPerSecond);
+    QFETCH(int, burst);
+    QFETCH(int, failuresPerKeyWord);
+
+    m_server.setFailuresPerKeyWord(failuresPerKeyWord);
+
+    TiandituGeocoder geocoder;
+    geocoder.setServiceUrl(m_server.url());
+    geocoder.clearCache();
+
+    TiandituGeocoder::BatchOptions options;
+    options.maxConcurrent = maxConcurrent;
+    options.requestsPerSecond = requestsPerSecond;
+    options.burst = burst;
+    options.retryBaseDelayMs = 20;
+    geocoder.setBatchOptions(options);
+
+    int succeeded = 0;
+    connect(&geocoder, &TiandituGeocoder::batchResultReady, this,
+            [&succeeded](int, bool success) { succeeded += success; });
+    QSignalSpy finished(&geocoder, &TiandituGeocoder::batchFinished);
+
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK_ONCE {
+        geocoder.geocodeBatch(queries(count));
+        QVERIFY(finished.wait(BATCH_TIMEOUT_MS));
+    }
+    const qint64 elapsedMs = qMax<qint64>(timer.elapsed(), 1);
+
+    QCOMPARE(succeeded, count);
+    QCOMPARE(m_server.requestCount(), count * (failuresPerKeyWord + 1));
+
+    // 桶中最多 burst 个令牌，其余请求按补充速率发出
+    const double minimumMs = qMax(0, count - burst) * 1000.0 / requestsPerSecond;
+    QVERIFY2(elapsedMs >= minimumMs * 0.9,
+             qPrintable(QStringLiteral("%1 ms < %2 ms").arg(elapsedMs).arg(minimumMs)));
+
+    qInfo().noquote() << QStringLiteral("%1: %2 条, %3 次请求, %4 ms, %5 条/秒")
+                             .arg(QString::fromLatin1(QTest::currentDataTag()))
+                             .arg(count)
+                             .arg(m_server.requestCount())
+                             .arg(elapsedMs)
+                             .arg(count * 1000.0 / elapsedMs, 0, 'f', 1);
+}
+
+void BenchGeocoder::cancelBatchStopsRequests()
+{
+    m_server.setResponseDelay(100);
+
+    TiandituGeocoder geocoder;
+    geocoder.setServiceUrl(m_server.url());
+    geocoder.clearCache();
+
+    TiandituGeocoder::BatchOptions options;
+    options.maxConcurrent = 4;
+    options.requestsPerSecond = 100000.0;
+    options.burst = 100000;
+    geocoder.setBatchOptions(options);
+
+    // 第一条结果返回时取消
+    int results = 0;
+    connect(&geocoder, &TiandituGeocoder::batchResultReady, this, [&] {
+        if (++results == 1) {
+            geocoder.cancelBatch();
+        }
+    });
+    QSignalSpy finished(&geocoder, &TiandituGeocoder::batchFinished);
+
+    geocoder.geocodeBatch(queries(40));
+    QVERIFY(finished.wait(BATCH_TIMEOUT_MS));
+    QVERIFY(!geocoder.isBatchRunning());
+
+    // 被中止的请求和队列中的查询都不再产生结果或新请求
+    QTest::qWait(500);
+    QCOMPARE(results, 1);
+    QCOMPARE(finished.size(), 1);
+    QVERIFY(m_server.requestCount() <= options.maxConcurrent);
+}
+
+QTEST_GUILESS_MAIN(BenchGeocoder)
+#include "bench_geocoder.moc"
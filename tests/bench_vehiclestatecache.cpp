@@ -0,0 +1,282 @@
+#include <QtTest>
+#include <atomic>
+#include <functional>
+#include "VehicleStateCache.h"
+#include "VehicleAnimationEngine.h"
+
+// 统计堆分配次数：glibc 下在可执行文件中覆盖 malloc 系列，operator new 和
+// QArrayData 的分配都经由这里；其他平台跳过分配计数
+#if defined(__GLIBC__)
+#define CARMOVE_COUNT_ALLOCATIONS 1
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+
+namespace {
+std::atomic<bool> s_counting{false};
+std::atomic<quint64> s_allocations{0};
+
+void countAllocation()
+{
+    if (s_counting.load(std::memory_order_relaxed)) {
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+}
+
+extern "C" void* malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+#endif
+
+class BenchVehicleStateCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void oversizedInsertDropsStaleEntry();
+    void removeVehiclesKeepsOthers();
+    void insertDoesNotAllocate();
+    void lookupDoesNotAllocate();
+    void warmFramesDoNotAllocate();
+    void insertWithEviction();
+    void lookupHit();
+    void warmFrame();
+
+private:
+    // 插入 count 个不同的键，预算只容纳约 CACHED_ENTRIES 个，持续触发 CLOCK 淘汰
+    void insertKeys(VehicleStateCache& cache, int count, int firstBucket);
+    // 每辆车在回放时刻前后各一条记录，首帧即可插值并写入缓存
+    QList<ExcelDataReader::VehicleRecord> bracketingRecords() const;
+    quint64 countAllocations(const std::function<void()>& work);
+
+    QList<VehicleDataModel::VehicleState> m_states;
+
+    static constexpr int VEHICLES_PER_ENTRY = 50;
+    static constexpr int CACHED_ENTRIES = 1000;   // 低于初始容量的一半，测量期间不扩容
+    static constexpr int INSERTS = 100000;
+    static constexpr int WARM_FRAMES = 1000;
+};
+
+void BenchVehicleStateCache::init()
+{
+    // 状态数据在测量之外构造一次，缓存条目与它隐式共享
+    m_states.clear();
+    const QDateTime timestamp(QDate(2025, 5, 23), QTime(8, 0), QTimeZone::UTC);
+    for (int i = 0; i < VEHICLES_PER_ENTRY; ++i) {
+        VehicleDataModel::VehicleState state;
+        state.plateNumber = QStringLiteral("冀JY%1").arg(8700 + i);
+        state.position = QGeoCoordinate(39.0 + i * 0.001, 117.0);
+        state.speed = 60.0;
+        state.direction = 90;
+        state.timestamp = timestamp;
+        state.color = QStringLiteral("黄色");
+        m_states.append(state);
+    }
+}
+
+void BenchVehicleStateCache::insertKeys(VehicleStateCache& cache, int count, int firstBucket)
+{
+    for (int i = 0; i < count; ++i) {
+        cache.insert({VehicleStateCache::AllVehicles, firstBucket + i}, m_states);
+    }
+}
+
+QList<ExcelDataReader::VehicleRecord> BenchVehicleStateCache::bracketingRecords() const
+{
+    QList<ExcelDataReader::VehicleRecord> records;
+    for (const auto& state : m_states) {
+        for (int step = 0; step < 2; ++step) {
+            ExcelDataReader::VehicleRecord record;
+            record.plateNumber = state.plateNumber;
+            record.vehicleColor = state.color;
+            record.speed = state.speed;
+            record.longitude = state.position.longitude() + step * 0.01;
+            record.latitude = state.position.latitude();
+            record.direction = state.direction;
+            record.distance = 0.0;
+            record.timestamp = state.timestamp.addSecs(step * 600);
+            records.append(record);
+        }
+    }
+    return records;
+}
+
+quint64 BenchVehicleStateCache::countAllocations(const std::function<void()>& work)
+{
+#ifdef CARMOVE_COUNT_ALLOCATIONS
+    s_allocations.store(0);
+    s_counting.store(true);
+    work();
+    s_counting.store(false);
+    return s_allocations.load();
+#else
+    work();
+    return 0;
+#endif
+}
+
+void BenchVehicleStateCache::oversizedInsertDropsStaleEntry()
+{
+    VehicleStateCache cache;
+    const VehicleStateCache::Key key{7, 1000};
+    cache.setMemoryBudget(VehicleStateCache::estimateCost(m_states));
+    cache.insert(key, m_states.mid(0, 1));
+    QCOMPARE(cache.entryCount(), 1);
+
+    QList<VehicleDataModel::VehicleState> larger = m_states;
+    larger.append(m_states.first());
+    cache.insert(key, larger);
+
+    QList<VehicleDataModel::VehicleState> states;
+    QVERIFY(!cache.lookup(key, states));
+    QCOMPARE(cache.entryCount(), 0);
+    QCOMPARE(cache.memoryUsed(), 0);
+}
+
+void BenchVehicleStateCache::removeVehiclesKeepsOthers()
+{
+    VehicleStateCache cache;
+    for (int bucket = 0; bucket < 100; ++bucket) {
+        for (int vehicleId = VehicleStateCache::AllVehicles; vehicleId < 5; ++vehicleId) {
+            cache.insert({vehicleId, bucket}, m_states.mid(0, 1));
+        }
+    }
+    QCOMPARE(cache.entryCount(), 600);
+
+    cache.removeVehicles({VehicleStateCache::AllVehicles, 3});
+    QCOMPARE(cache.entryCount(), 400);
+
+    QList<VehicleDataModel::VehicleState> states;
+    for (int bucket = 0; bucket < 100; ++bucket) {
+        QVERIFY(!cache.lookup({VehicleStateCache::AllVehicles, bucket}, states));
+        QVERIFY(!cache.lookup({3, bucket}, states));
+        QVERIFY(cache.lookup({0, bucket}, states));
+        QVERIFY(cache.lookup({4, bucket}, states));
+    }
+}
+
+void BenchVehicleStateCache::insertDoesNotAllocate()
+{
+#ifndef CARMOVE_COUNT_ALLOCATIONS
+    QSKIP("分配计数仅支持 glibc");
+#endif
+    VehicleStateCache cache;
+    cache.setMemoryBudget(VehicleStateCache::estimateCost(m_states) * CACHED_ENTRIES);
+
+    // 预热：填满预算，之后每次插入都伴随一次淘汰
+    insertKeys(cache, CACHED_ENTRIES * 2, 0);
+    QVERIFY(cache.entryCount() <= CACHED_ENTRIES);
+
+    const quint64 allocations = countAllocations([&] {
+        insertKeys(cache, INSERTS, CACHED_ENTRIES * 2);
+    });
+    QCOMPARE(allocations, quint64(0));
+    QVERIFY(cache.entryCount() <= CACHED_ENTRIES);
+}
+
+void BenchVehicleStateCache::lookupDoesNotAllocate()
+{
+#ifndef CARMOVE_COUNT_ALLOCATIONS
+    QSKIP("分配计数仅支持 glibc");
+#endif
+    VehicleStateCache cache;
+    insertKeys(cache, CACHED_ENTRIES, 0);
+
+    QList<VehicleDataModel::VehicleState> states;
+    int hits = 0;
+    const quint64 allocations = countAllocations([&] {
+        for (int i = 0; i < INSERTS; ++i) {
+            hits += cache.lookup({VehicleStateCache::AllVehicles, i % CACHED_ENTRIES}, states);
+        }
+    });
+    QCOMPARE(allocations, quint64(0));
+    QCOMPARE(hits, INSERTS);
+}
+
+void BenchVehicleStateCache::warmFramesDoNotAllocate()
+{
+#ifndef CARMOVE_COUNT_ALLOCATIONS
+    QSKIP("分配计数仅支持 glibc");
+#endif
+    VehicleDataModel model;
+    model.setVehicleData(bracketingRecords());
+    QCOMPARE(model.getVehicleList().size(), VEHICLES_PER_ENTRY);
+
+    VehicleAnimationEngine engine;
+    int updates = 0;
+    connect(&engine, &VehicleAnimationEngine::vehiclePositionUpdated, this, [&updates]() {
+        updates++;
+    });
+
+    // 冷帧：逐车插值并写入缓存；之后同一分钟内的帧全部命中
+    engine.setVehicleModel(&model);
+    engine.setCurrentTime(m_states.first().timestamp.addSecs(300));
+
+    updates = 0;
+    const quint64 allocations = countAllocations([&] {
+        for (int frame = 0; frame < WARM_FRAMES; ++frame) {
+            engine.updateVehiclePositions();
+        }
+    });
+    QCOMPARE(allocations, quint64(0));
+    QCOMPARE(updates, WARM_FRAMES * VEHICLES_PER_ENTRY);
+}
+
+void BenchVehicleStateCache::insertWithEviction()
+{
+    VehicleStateCache cache;
+    cache.setMemoryBudget(VehicleStateCache::estimateCost(m_states) * CACHED_ENTRIES);
+    insertKeys(cache, CACHED_ENTRIES * 2, 0);
+
+    int firstBucket = CACHED_ENTRIES * 2;
+    QBENCHMARK {
+        insertKeys(cache, INSERTS, firstBucket);
+        firstBucket += INSERTS;
+    }
+}
+
+void BenchVehicleStateCache::lookupHit()
+{
+    VehicleStateCache cache;
+    insertKeys(cache, CACHED_ENTRIES, 0);
+
+    QList<VehicleDataModel::VehicleState> states;
+    QBENCHMARK {
+        for (int i = 0; i < INSERTS; ++i) {
+            cache.lookup({VehicleStateCache::AllVehicles, i % CACHED_ENTRIES}, states);
+        }
+    }
+}
+
+void BenchVehicleStateCache::warmFrame()
+{
+    VehicleDataModel model;
+    model.setVehicleData(bracketingRecords());
+    VehicleAnimationEngine engine;
+    engine.setVehicleModel(&model);
+    engine.setCurrentTime(m_states.first().timestamp.addSecs(300));
+
+    QBENCHMARK {
+        engine.updateVehiclePositions();
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchVehicleStateCache)
+#include "bench_vehiclestatecache.moc"
@@ -0,0 +1,217 @@
+#include <QtTest>
+#include "ColumnLayoutDetector.h"
+
+using Layout = ColumnLayoutDetector::Layout;
+using Sheet = QList<QVariantList>;
+
+class TestColumnLayoutDetector : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void matchingConfigIsReused();
+    void reorderedColumnsAreDetected();
+    void titleRowsAndSynonyms();
+    void valueSniffing();
+    void headerlessSheetUsesConfig();
+    void unrecognizedLayoutUsesConfig();
+    void configVersionInvalidatesCache();
+
+private:
+    // 厂商 A：第 1 行表头，中文标准列名，与 standardConfig() 一致
+    static Sheet vendorA(int dataRows);
+    // 厂商 C：只有速度、方向可按列名识别，其余列需按取值判断
+    static Sheet vendorC(int dataRows);
+    static Layout resolve(const Sheet& sheet, const ConfigManager::Snapshot& config, int* maxRowRead = nullptr);
+    static ConfigManager::Snapshot standardConfig(quint64 version);
+    static int column(const Layout& layout, const QString& fieldName);
+};
+
+Sheet TestColumnLayoutDetector::vendorA(int dataRows)
+{
+    Sheet sheet = {{"车牌号", "车牌颜色", "速度(km/h)", "经度", "纬度", "方向", "上报时间", "总里程"}};
+    for (int i = 0; i < dataRows; ++i) {
+        sheet.append({"冀JY8706", "黄色", 60, 117.7 + i * 0.001, 39.08, 90,
+                      QString("2025-05-23 08:%1:00").arg(i % 60, 2, 10, QLatin1Char('0')), 55511});
+    }
+    return sheet;
+}
+
+Sheet TestColumnLayoutDetector::vendorC(int dataRows)
+{
+    // 里程数列是 73~135 之间的整数，不能被当作经度
+    Sheet sheet = {{"序号", "终端", "回传", "里程数", "X", "Y", "速度", "方向"}};
+    for (int i = 0; i < dataRows; ++i) {
+        sheet.append({i + 1, "冀JY8706", QString("2025/5/23 8:%1:00").arg(i % 60, 2, 10, QLatin1Char('0')),
+                      100 + i % 10, 117.123456 + i * 0.001, 39.123, 45.5, 180});
+    }
+    return sheet;
+}
+
+Layout TestColumnLayoutDetector::resolve(const Sheet& sheet, const ConfigManager::Snapshot& config, int* maxRowRead)
+{
+    int lastColumn = 0;
+    for (const QVariantList& row : sheet) {
+        lastColumn = qMax(lastColumn, int(row.size()));
+    }
+    if (maxRowRead) {
+        *maxRowRead = 0;
+    }
+    return ColumnLayoutDetector::resolve([&sheet, maxRowRead](int row, int column) {
+        if (maxRowRead) {
+            *maxRowRead = qMax(*maxRowRead, row);
+        }
+        return sheet.value(row - 1).value(column - 1);
+    }, int(sheet.size()), lastColumn, config, "test.xlsx");
+}
+
+ConfigManager::Snapshot TestColumnLayoutDetector::standardConfig(quint64 version)
+{
+    ConfigManager::Snapshot config;
+    config.version = version;
+    config.dataStartRow = 2;
+    const QStringList fields = ConfigManager::getStandardFieldNames();
+    const QStringList required = ConfigManager::getRequiredFieldNames();
+    for (int i = 0; i < fields.size(); ++i) {
+        config.fieldMappings.append(ConfigManager::FieldMapping(fields[i], i + 1, required.contains(fields[i]),
+                                                                fields[i], "text"));
+    }
+    return config;
+}
+
+int TestColumnLayoutDetector::column(const Layout& layout, const QString& fieldName)
+{
+    for (const auto& mapping : layout.fieldMappings) {
+        if (mapping.fieldName == fieldName) {
+            return mapping.columnIndex;
+        }
+    }
+    return 0;
+}
+
+void TestColumnLayoutDetector::init()
+{
+    ColumnLayoutDetector::clearCache();
+}
+
+void TestColumnLayoutDetector::matchingConfigIsReused()
+{
+    const ConfigManager::Snapshot config = standardConfig(1);
+    const Layout layout = resolve(vendorA(10), config);
+    QVERIFY(!layout.detected);
+    QCOMPARE(layout.dataStartRow, 2);
+    QCOMPARE(layout.fieldMappings, config.fieldMappings);
+}
+
+void TestColumnLayoutDetector::reorderedColumnsAreDetected()
+{
+    // 配置把经纬度接反：表头在配置列上识别为其他字段
+    ConfigManager::Snapshot config = standardConfig(1);
+    config.fieldMappings[3].columnIndex = 5;
+    config.fieldMappings[4].columnIndex = 4;
+    Layout layout = resolve(vendorA(10), config);
+    QVERIFY(layout.detected);
+    QCOMPARE(column(layout, "经度"), 4);
+    QCOMPARE(column(layout, "纬度"), 5);
+    QCOMPARE(column(layout, "速度"), 3);
+
+    // 起始行与表头不符同样按表头识别
+    config = standardConfig(2);
+    config.dataStartRow = 3;
+    layout = resolve(vendorA(10), config);
+    QVERIFY(layout.detected);
+    QCOMPARE(layout.dataStartRow, 2);
+}
+
+void TestColumnLayoutDetector::titleRowsAndSynonyms()
+{
+    // 厂商 B：标题行 + 空行，第 3 行为英文表头（大小写、空格、单位不同）
+    Sheet sheet = {{"XX平台轨迹明细"}, {}, {"Plate No", "GPS Time", "备注", "Lat", "Lng", "Speed(km/h)", "Heading",
+                                          "Mileage"}};
+    for (int i = 0; i < 10; ++i) {
+        sheet.append({"冀JY8706", "2025-05-23 08:00:00", "", 39.08, 117.7, 60, 90, 55511});
+    }
+
+    const Layout layout = resolve(sheet, standardConfig(1));
+    QVERIFY(layout.detected);
+    QCOMPARE(layout.dataStartRow, 4);
+    QCOMPARE(column(layout, "车牌号"), 1);
+    QCOMPARE(column(layout, "上报时间"), 2);
+    QCOMPARE(column(layout, "纬度"), 4);
+    QCOMPARE(column(layout, "经度"), 5);
+    QCOMPARE(column(layout, "速度"), 6);
+    QCOMPARE(column(layout, "方向"), 7);
+    QCOMPARE(column(layout, "总里程"), 8);
+    QCOMPARE(column(layout, "车牌颜色"), 0);
+    QCOMPARE(layout.fieldMappings.size(), 7);
+}
+
+void TestColumnLayoutDetector::valueSniffing()
+{
+    const Layout layout = resolve(vendorC(30), standardConfig(1));
+    QVERIFY(layout.detected);
+    QCOMPARE(layout.dataStartRow, 2);
+    QCOMPARE(column(layout, "车牌号"), 2);
+    QCOMPARE(column(layout, "上报时间"), 3);
+    QCOMPARE(column(layout, "经度"), 5);
+    QCOMPARE(column(layout, "纬度"), 6);
+    QCOMPARE(column(layout, "速度"), 7);
+    QCOMPARE(column(layout, "方向"), 8);
+    QCOMPARE(layout.fieldMappings.size(), 6);
+}
+
+void TestColumnLayoutDetector::headerlessSheetUsesConfig()
+{
+    Sheet sheet = vendorA(10);
+    sheet.removeFirst();
+
+    const ConfigManager::Snapshot config = standardConfig(1);
+    const Layout layout = resolve(sheet, config);
+    QVERIFY(!layout.detected);
+    QCOMPARE(layout.dataStartRow, config.dataStartRow);
+    QCOMPARE(layout.fieldMappings, config.fieldMappings);
+}
+
+void TestColumnLayoutDetector::unrecognizedLayoutUsesConfig()
+{
+    // 表头可识别，但纬度列的取值不在范围内，识别不全
+    Sheet sheet = vendorC(10);
+    for (int row = 1; row < sheet.size(); ++row) {
+        sheet[row][5] = 88.5;
+    }
+
+    ConfigManager::Snapshot config = standardConfig(1);
+    config.dataStartRow = 5;
+    const Layout layout = resolve(sheet, config);
+    QVERIFY(!layout.detected);
+    QCOMPARE(layout.dataStartRow, 5);
+    QCOMPARE(layout.fieldMappings, config.fieldMappings);
+}
+
+void TestColumnLayoutDetector::configVersionInvalidatesCache()
+{
+    const Sheet sheet = vendorC(30);
+    int maxRowRead = 0;
+    const Layout detected = resolve(sheet, standardConfig(1), &maxRowRead);
+    QVERIFY(detected.detected);
+    QVERIFY(maxRowRead > ColumnLayoutDetector::MAX_HEADER_SCAN_ROWS);
+
+    // 同一表头、同一配置版本：只读表头扫描行，直接复用
+    Layout layout = resolve(sheet, standardConfig(1), &maxRowRead);
+    QCOMPARE(maxRowRead, ColumnLayoutDetector::MAX_HEADER_SCAN_ROWS);
+    QCOMPARE(layout.fieldMappings, detected.fieldMappings);
+
+    // 用户按识别结果修改列映射后版本变化，改为沿用配置
+    ConfigManager::Snapshot config;
+    config.version = 2;
+    config.dataStartRow = detected.dataStartRow;
+    config.fieldMappings = detected.fieldMappings;
+    config.fieldMappings[0].displayName = "终端车牌";
+    layout = resolve(sheet, config);
+    QVERIFY(!layout.detected);
+    QCOMPARE(layout.fieldMappings, config.fieldMappings);
+}
+
+QTEST_GUILESS_MAIN(TestColumnLayoutDetector)
+#include "tst_columnlayoutdetector.moc"
@@ -0,0 +1,70 @@
+#include <QtTest>
+#include "ConfigManager.h"
+
+class TestConfigManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void publishesOneSnapshotPerOperation();
+    void heldSnapshotIsUnchanged();
+};
+
+void TestConfigManager::publishesOneSnapshotPerOperation()
+{
+    ConfigManager* config = ConfigManager::GetInstance();
+    QSignalSpy spy(config, &ConfigManager::excelColumnMappingChanged);
+    const quint64 version = config->snapshot()->version;
+
+    config->createDefaultExcelMapping();
+    QCOMPARE(config->snapshot()->version, version + 1);
+    QCOMPARE(config->snapshot()->fieldMappings.size(), ConfigManager::getStandardFieldNames().size());
+    QCOMPARE(spy.count(), 1);
+
+    // 替换已有字段：删除和追加合为一次发布，映射数量不变
+    config->addFieldMapping("经度", 5, true, "经度", "number");
+    QCOMPARE(config->snapshot()->version, version + 2);
+    QCOMPARE(config->snapshot()->fieldMappings.size(), ConfigManager::getStandardFieldNames().size());
+    QCOMPARE(config->snapshot()->columnForField("经度"), 5);
+
+    config->removeFieldMapping("总里程");
+    QCOMPARE(config->snapshot()->version, version + 3);
+    QCOMPARE(config->snapshot()->columnForField("总里程"), 0);
+
+    // 没有可删除的映射时不发布
+    config->removeFieldMapping("总里程");
+    QCOMPARE(config->snapshot()->version, version + 3);
+
+    config->setExcelDataStartRow(3);
+    QCOMPARE(config->snapshot()->version, version + 4);
+    QCOMPARE(config->snapshot()->dataStartRow, 3);
+    QCOMPARE(spy.count(), 3);
+}
+
+void TestConfigManager::heldSnapshotIsUnchanged()
+{
+    ConfigManager* config = ConfigManager::GetInstance();
+    config->createDefaultExcelMapping();
+    config->addFieldMapping("纬度", 4, true, "纬度", "number");
+
+    // 模拟进行中的加载任务持有的快照
+    const ConfigManager::SnapshotPtr held = config->snapshot();
+    const ConfigManager::Snapshot copy = *held;
+
+    config->addFieldMapping("纬度", 9, true, "纬度", "number");
+    config->removeFieldMapping("速度");
+    config->setExcelDataStartRow(copy.dataStartRow + 1);
+    config->setCoordinateConversionEnabled(!copy.coordinateConversionEnabled);
+    QVERIFY(config->snapshot()->version > held->version);
+
+    QCOMPARE(held->version, copy.version);
+    QCOMPARE(held->dataStartRow, copy.dataStartRow);
+    QCOMPARE(held->coordinateConversionEnabled, copy.coordinateConversionEnabled);
+    QCOMPARE(held->fieldMappings, copy.fieldMappings);
+    QCOMPARE(held->columnForField("纬度"), 4);
+
+    config->setCoordinateConversionEnabled(copy.coordinateConversionEnabled);
+}
+
+QTEST_GUILESS_MAIN(TestConfigManager)
+#include "tst_configmanager.moc"
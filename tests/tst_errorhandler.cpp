@@ -0,0 +1,66 @@
+#include <QtTest>
+#include <QThreadPool>
+#include "ErrorHandler.h"
+
+class TestErrorHandler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void staticHelpersReportToInstance();
+    void reportsFromWorkerThreads();
+    void resumesAfterIdle();
+};
+
+void TestErrorHandler::staticHelpersReportToInstance()
+{
+    ErrorHandler handler;
+    QCOMPARE(ErrorHandler::instance(), &handler);
+
+    HANDLE_DATA_ERROR("a.xlsx", "表头缺失");
+    HANDLE_MEMORY_ERROR("解析工作表");
+    QCOMPARE(handler.getErrorCount(ErrorHandler::DataFormatError), 1);
+    QCOMPARE(handler.getErrorCount(ErrorHandler::MemoryError), 1);
+
+    QTRY_COMPARE(handler.getErrorHistory().size(), 2);
+    QCOMPARE(handler.getErrorHistory().at(0).type, ErrorHandler::DataFormatError);
+}
+
+void TestErrorHandler::reportsFromWorkerThreads()
+{
+    ErrorHandler handler;
+    QSignalSpy spy(&handler, &ErrorHandler::errorReported);
+
+    QThreadPool pool;
+    for (int i = 0; i < 4; ++i) {
+        pool.start([&handler, i]() {
+            handler.reportError(ErrorHandler::SystemError, ErrorHandler::Critical,
+                                QString("worker %1").arg(i), QString());
+        });
+    }
+    pool.waitForDone();
+
+    QTRY_COMPARE(spy.count(), 4);
+    QCOMPARE(handler.getErrorCount(), 4);
+}
+
+void TestErrorHandler::resumesAfterIdle()
+{
+    // 队列取空后定时器停止，之后的错误仍能被取出
+    ErrorHandler handler;
+    handler.reportError(ErrorHandler::NetworkError, ErrorHandler::Warning, "first", QString());
+    QTRY_COMPARE(handler.getErrorHistory().size(), 1);
+
+    QTest::qWait(300);
+    QThreadPool pool;
+    pool.start([&handler]() {
+        handler.reportError(ErrorHandler::NetworkError, ErrorHandler::Warning, "second", QString());
+    });
+    pool.waitForDone();
+
+    QTRY_COMPARE(handler.getErrorHistory().size(), 2);
+    QCOMPARE(handler.getErrorHistory().at(1).technicalMessage, QString("second"));
+}
+
+QTEST_GUILESS_MAIN(TestErrorHandler)
+#include "tst_errorhandler.moc"
@@ -0,0 +1,102 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "ExcelDataReader.h"
+#include "XlsxTestFile.h"
+
+class TestExcelDataReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void prescanWithDimension();
+    void prescanWithoutDimension();
+    void prescanReversedOrder();
+
+private:
+    // 表头一行 + rowCount 行数据，时间从 start 起每行加 step 秒；行不带 r 属性
+    static QByteArray trackRows(int rowCount, const QDateTime& start, int step);
+    static QByteArray inlineCell(const QString& text);
+    static bool prescan(const QString& filePath, int& recordCount, QDateTime& first, QDateTime& last);
+
+    QTemporaryDir m_dir;
+};
+
+QByteArray TestExcelDataReader::inlineCell(const QString& text)
+{
+    return "<c t=\"inlineStr\"><is><t>" + text.toUtf8() + "</t></is></c>";
+}
+
+QByteArray TestExcelDataReader::trackRows(int rowCount, const QDateTime& start, int step)
+{
+    QByteArray rows = "<row>";
+    for (const QString& header : {"车牌号", "车牌颜色", "速度", "经度", "纬度", "方向", "上报时间", "总里程"}) {
+        rows += inlineCell(header);
+    }
+    rows += "</row>";
+
+    for (int i = 0; i < rowCount; ++i) {
+        rows += "<row>" + inlineCell("冀JY8706") + inlineCell("黄色") +
+                "<c><v>60</v></c><c><v>117.7</v></c><c><v>39.08</v></c><c><v>90</v></c>" +
+                inlineCell(start.addSecs(qint64(i) * step).toString("yyyy-MM-dd hh:mm:ss")) +
+                "<c><v>55511</v></c></row>";
+    }
+    return rows;
+}
+
+bool TestExcelDataReader::prescan(const QString& filePath, int& recordCount, QDateTime& first, QDateTime& last)
+{
+    // 使用空配置，列布局按表头识别，不依赖 ConfigManager 的持久化设置
+    ExcelDataReader reader;
+    return reader.prescanFile(filePath, recordCount, first, last, std::make_shared<ConfigManager::Snapshot>());
+}
+
+void TestExcelDataReader::prescanWithDimension()
+{
+    QVERIFY(m_dir.isValid());
+    const QDateTime start(QDate(2025, 5, 23), QTime(8, 0));
+    const QString filePath = m_dir.filePath("dimension.xlsx");
+    QVERIFY(XlsxTestFile::writeWorksheet(filePath, trackRows(5000, start, 10), "A1:H5001"));
+
+    int recordCount = 0;
+    QDateTime first;
+    QDateTime last;
+    QVERIFY(prescan(filePath, recordCount, first, last));
+    QCOMPARE(recordCount, 5000);
+    QCOMPARE(first, start);
+    QCOMPARE(last, start.addSecs(4999 * 10));
+}
+
+void TestExcelDataReader::prescanWithoutDimension()
+{
+    QVERIFY(m_dir.isValid());
+    const QDateTime start(QDate(2025, 5, 23), QTime(8, 0));
+    const QString filePath = m_dir.filePath("no_dimension.xlsx");
+    QVERIFY(XlsxTestFile::writeWorksheet(filePath, trackRows(300, start, 60)));
+
+    int recordCount = 0;
+    QDateTime first;
+    QDateTime last;
+    QVERIFY(prescan(filePath, recordCount, first, last));
+    QCOMPARE(recordCount, 300);
+    QCOMPARE(first, start);
+    QCOMPARE(last, start.addSecs(299 * 60));
+}
+
+void TestExcelDataReader::prescanReversedOrder()
+{
+    QVERIFY(m_dir.isValid());
+    const QDateTime end(QDate(2025, 5, 23), QTime(18, 0));
+    const QString filePath = m_dir.filePath("reversed.xlsx");
+    QVERIFY(XlsxTestFile::writeWorksheet(filePath, trackRows(100, end, -30), "A1:H101"));
+
+    int recordCount = 0;
+    QDateTime first;
+    QDateTime last;
+    QVERIFY(prescan(filePath, recordCount, first, last));
+    QCOMPARE(recordCount, 100);
+    QCOMPARE(first, end.addSecs(-99 * 30));
+    QCOMPARE(last, end);
+}
+
+QTEST_GUILESS_MAIN(TestExcelDataReader)
+#include "tst_exceldatareader.moc"
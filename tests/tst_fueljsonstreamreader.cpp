@@ -0,0 +1,156 @@
+#include <QtTest>
+#include "FuelJsonStreamReader.h"
+#include "FuelRecordStore.h"
+
+class TestFuelJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void nestedDocument();
+    void nonArrayContainersAreSkipped();
+    void topLevelFieldsBesideContainer();
+    void ndjsonLines();
+    void malformedInput_data();
+    void malformedInput();
+
+private:
+    static bool read(const QByteArray& json, FuelRecordStore& store, QString& errorMessage);
+};
+
+bool TestFuelJsonStreamReader::read(const QByteArray& json, FuelRecordStore& store, QString& errorMessage)
+{
+    FuelJsonStreamReader reader;
+    return reader.readData(json.constData(), json.size(), store, errorMessage);
+}
+
+void TestFuelJsonStreamReader::nestedDocument()
+{
+    // records 在 plateNumber 之前、非对象元素、未识别字段、转义字符
+    const QByteArray json = R"({
+        "source": {"name": "导出", "rows": [1, 2]},
+        "vehicles": [
+            {"plateNumber": "冀JY8701", "records": [
+                {"date": "2025-05-23", "time": "08:30:00", "fuelType": "柴油", "amount": 12.5,
+                 "longitude": 117.1, "latitude": 39.1, "correctedLongitude": 117.2, "correctedLatitude": 39.2},
+                {"date": "2025/5/24", "fuelType": "汽油", "amount": "n/a", "note": [true, null]}
+            ]},
+            {"records": [{"date": "2025-05-25", "time": "09:15", "amount": 3}], "plateNumber": "\u5180JY8702"},
+            42
+        ]
+    })";
+
+    FuelRecordStore store;
+    QString errorMessage;
+    FuelJsonStreamReader reader;
+    QSignalSpy progress(&reader, &FuelJsonStreamReader::progress);
+    QVERIFY2(reader.readData(json.constData(), json.size(), store, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(progress.count(), 1);
+    QCOMPARE(progress.first().at(0).toLongLong(), qint64(json.size()));
+
+    QCOMPARE(store.size(), 3);
+    QCOMPARE(store.plateCount(), 2);
+    QCOMPARE(store.plateAt(0), QString("冀JY8701"));
+    QCOMPARE(store.plateAt(1), QString("冀JY8702"));
+
+    const FuelRecordStore::Record first = store.record(store.rowsForPlate(0).at(0));
+    QCOMPARE(first.dateTime, QDateTime(QDate(2025, 5, 23), QTime(8, 30)));
+    QVERIFY(first.hasTime);
+    QCOMPARE(first.fuelType, QString("柴油"));
+    QCOMPARE(first.amount, 12.5);
+    QCOMPARE(first.longitude, 117.1);
+    QCOMPARE(first.correctedLatitude, 39.2);
+
+    const FuelRecordStore::Record second = store.record(store.rowsForPlate(0).at(1));
+    QCOMPARE(second.dateTime, QDateTime(QDate(2025, 5, 24), QTime(0, 0)));
+    QVERIFY(!second.hasTime);
+    QCOMPARE(second.amount, 0.0);
+
+    const FuelRecordStore::Record third = store.record(store.rowsForPlate(1).at(0));
+    QCOMPARE(third.plateNumber, QString("冀JY8702"));
+    QCOMPARE(third.dateTime, QDateTime(QDate(2025, 5, 25), QTime(9, 15)));
+}
+
+void TestFuelJsonStreamReader::nonArrayContainersAreSkipped()
+{
+    const QByteArray json = R"({"vehicles": [
+        {"plateNumber": "冀JY8701", "records": null},
+        {"plateNumber": "冀JY8702", "records": {"date": "2025-05-23", "amount": 1}},
+        {"plateNumber": "冀JY8703", "records": "none", "amount": 2}
+    ]}
+    {"vehicles": {"plateNumber": "冀JY8704"}})";
+
+    FuelRecordStore store;
+    QString errorMessage;
+    QVERIFY2(read(json, store, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(store.size(), 0);
+    QCOMPARE(store.plateCount(), 3);
+}
+
+void TestFuelJsonStreamReader::topLevelFieldsBesideContainer()
+{
+    // 顶层已有 vehicles / records 容器时，旁边的记录字段不构成一条记录
+    const QByteArray json = R"({"amount": 99, "date": "2025-05-23", "vehicles": [
+        {"plateNumber": "冀JY8701", "records": [{"date": "2025-05-23", "amount": 1}]}
+    ]}
+    {"plateNumber": "冀JY8702", "amount": 98, "records": [{"date": "2025-05-24", "amount": 2}]})";
+
+    FuelRecordStore store;
+    QString errorMessage;
+    QVERIFY2(read(json, store, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(store.size(), 2);
+    QCOMPARE(store.plateTotalAmount(store.plateId("冀JY8701")), 1.0);
+    QCOMPARE(store.plateTotalAmount(store.plateId("冀JY8702")), 2.0);
+}
+
+void TestFuelJsonStreamReader::ndjsonLines()
+{
+    const QByteArray json =
+        "\xEF\xBB\xBF"
+        "{\"plateNumber\": \"冀JY8701\", \"date\": \"2025-05-23\", \"time\": \"10:00:00\", \"amount\": 4}\r\n"
+        "{\"plateNumber\": \"冀JY8702\", \"records\": [{\"date\": \"2025-05-23\", \"amount\": 5}]}\n"
+        "\n"
+        "{\"date\": \"2025-05-24\", \"amount\": 6, \"plateNumber\": \"冀JY8701\"}\n"
+        "{}\n";
+
+    FuelRecordStore store;
+    QString errorMessage;
+    QVERIFY2(read(json, store, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(store.size(), 3);
+    QCOMPARE(store.plateCount(), 2);
+    QCOMPARE(store.rowsForPlate(store.plateId("冀JY8701")).size(), 2);
+    QCOMPARE(store.plateTotalAmount(store.plateId("冀JY8701")), 10.0);
+    QCOMPARE(store.plateTotalAmount(store.plateId("冀JY8702")), 5.0);
+}
+
+void TestFuelJsonStreamReader::malformedInput_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("line");
+
+    QTest::newRow("empty") << QByteArray("  \n") << 2;
+    QTest::newRow("top-level array") << QByteArray("[{\"amount\": 1}]") << 1;
+    QTest::newRow("truncated object") << QByteArray("{\"vehicles\": [\n{\"plateNumber\": \"A\"") << 2;
+    QTest::newRow("unterminated string") << QByteArray("{\"plateNumber\": \"A}\n") << 2;
+    QTest::newRow("missing colon") << QByteArray("{\"amount\" 1}") << 1;
+    QTest::newRow("bad number") << QByteArray("{\"amount\": 1.2.3}") << 1;
+    QTest::newRow("bad escape") << QByteArray("{\"plateNumber\": \"\\q\"}") << 1;
+    QTest::newRow("bad unicode escape") << QByteArray("{\"plateNumber\": \"\\u12G4\"}") << 1;
+    QTest::newRow("unclosed skipped value") << QByteArray("{\"note\": [1, {\"a\": 2}\n") << 2;
+    QTest::newRow("garbage after object") << QByteArray("{\"amount\": 1}\nnull\n") << 2;
+}
+
+void TestFuelJsonStreamReader::malformedInput()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, line);
+
+    FuelRecordStore store;
+    QString errorMessage;
+    QVERIFY(!read(json, store, errorMessage));
+    QVERIFY(errorMessage.startsWith("JSON解析错误"));
+    QVERIFY2(errorMessage.contains(QString("第 %1 行").arg(line)), qPrintable(errorMessage));
+}
+
+QTEST_GUILESS_MAIN(TestFuelJsonStreamReader)
+#include "tst_fueljsonstreamreader.moc"
@@ -0,0 +1,199 @@
+#include <QtTest>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include "TiandituGeocoder.h"
+#include "GeocodeCache.h"
+#include "MockGeocodeServer.h"
+
+class TestGeocodeCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void repeatedSearchHitsCache();
+    void concurrentSearchesShareRequest();
+    void batchSkipsCachedQueries();
+    void cacheSurvivesRestart();
+    void roundTripThroughFile();
+    void expiredEntriesMiss();
+
+private:
+    void prepare(TiandituGeocoder& geocoder);
+
+    MockGeocodeServer m_server;
+
+    static constexpr const char* REGION = "156110000";
+    static constexpr int REPLY_TIMEOUT_MS = 5000;
+};
+
+void TestGeocodeCache::initTestCase()
+{
+    // 缓存文件写到测试专用目录
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_server.listen());
+}
+
+void TestGeocodeCache::init()
+{
+    m_server.reset();
+    m_server.setResponseDelay(0);
+}
+
+void TestGeocodeCache::prepare(TiandituGeocoder& geocoder)
+{
+    geocoder.setServiceUrl(m_server.url());
+    geocoder.clearCache();
+}
+
+void TestGeocodeCache::repeatedSearchHitsCache()
+{
+    TiandituGeocoder geocoder;
+    prepare(geocoder);
+    QSignalSpy succeeded(&geocoder, &TiandituGeocoder::geocodeSucceeded);
+
+    geocoder.searchInAdminRegion(QStringLiteral("北京 站"), QString::fromLatin1(REGION));
+    QVERIFY(succeeded.wait(REPLY_TIMEOUT_MS));
+    QCOMPARE(m_server.requestCount(), 1);
+    QCOMPARE(succeeded.last().at(2).toString(), QStringLiteral("北京 站"));
+
+    // 规范化后相同的关键字命中缓存，同步返回
+    geocoder.searchInAdminRegion(QStringLiteral("  北京   站 "), QString::fromLatin1(REGION));
+    QCOMPARE(succeeded.size(), 2);
+    QCOMPARE(m_server.requestCount(), 1);
+    QVERIFY(!geocoder.isBusy());
+
+    // 不同的关键字未命中
+    geocoder.searchInAdminRegion(QStringLiteral("天津站"), QString::fromLatin1(REGION));
+    QCOMPARE(succeeded.size(), 2);
+    QVERIFY(succeeded.wait(REPLY_TIMEOUT_MS));
+    QCOMPARE(m_server.requestCount(), 2);
+    QCOMPARE(geocoder.cache()->size(), 2);
+}
+
+void TestGeocodeCache::concurrentSearchesShareRequest()
+{
+    TiandituGeocoder geocoder;
+    prepare(geocoder);
+    QSignalSpy succeeded(&geocoder, &TiandituGeocoder::geocodeSucceeded);
+
+    // 第一次请求返回前再次查询同一关键字：合并到同一请求，每次调用各发一次信号
+    m_server.setResponseDelay(200);
+    geocoder.searchInAdminRegion(QStringLiteral("北京站"), QString::fromLatin1(REGION));
+    geocoder.searchInAdminRegion(QStringLiteral(" 北京站 "), QString::fromLatin1(REGION));
+    QCOMPARE(succeeded.size(), 0);
+    QVERIFY(geocoder.isBusy());
+
+    QTRY_COMPARE_WITH_TIMEOUT(succeeded.size(), 2, REPLY_TIMEOUT_MS);
+    QCOMPARE(m_server.requestCount(), 1);
+    for (const QList<QVariant>& arguments : succeeded) {
+        QCOMPARE(arguments.at(2).toString(), QStringLiteral("北京站"));
+    }
+    QVERIFY(!geocoder.isBusy());
+
+    // 之后的新查询只发一次
+    geocoder.searchInAdminRegion(QStringLiteral("天津站"), QString::fromLatin1(REGION));
+    QVERIFY(succeeded.wait(REPLY_TIMEOUT_MS));
+    QTest::qWait(100);
+    QCOMPARE(succeeded.size(), 3);
+}
+
+void TestGeocodeCache::batchSkipsCachedQueries()
+{
+    TiandituGeocoder geocoder;
+    prepare(geocoder);
+    QSignalSpy succeeded(&geocoder, &TiandituGeocoder::geocodeSucceeded);
+    geocoder.searchInAdminRegion(QStringLiteral("北京站"), QString::fromLatin1(REGION));
+    QVERIFY(succeeded.wait(REPLY_TIMEOUT_MS));
+
+    QSignalSpy results(&geocoder, &TiandituGeocoder::batchResultReady);
+    QSignalSpy finished(&geocoder, &TiandituGeocoder::batchFinished);
+    geocoder.geocodeBatch(QList<TiandituGeocoder::BatchQuery>{
+        {QStringLiteral("北京站"), QString::fromLatin1(REGION)},
+        {QStringLiteral("北京西站"), QString::fromLatin1(REGION)},
+    });
+    QVERIFY(finished.size() == 1 || finished.wait(REPLY_TIMEOUT_MS));
+
+    QCOMPARE(results.size(), 2);
+    QCOMPARE(m_server.requestCount(), 2);
+    QCOMPARE(m_server.requestCount(QStringLiteral("北京站")), 1);
+    QCOMPARE(m_server.requestCount(QStringLiteral("北京西站")), 1);
+}
+
+void TestGeocodeCache::cacheSurvivesRestart()
+{
+    {
+        TiandituGeocoder geocoder;
+        prepare(geocoder);
+        QSignalSpy succeeded(&geocoder, &TiandituGeocoder::geocodeSucceeded);
+        geocoder.searchInAdminRegion(QStringLiteral("北京站"), QString::fromLatin1(REGION));
+        QVERIFY(succeeded.wait(REPLY_TIMEOUT_MS));
+    } // 析构时保存尚未落盘的条目
+
+    TiandituGeocoder geocoder;
+    geocoder.setServiceUrl(m_server.url());
+    QCOMPARE(geocoder.cache()->size(), 1);
+
+    QSignalSpy succeeded(&geocoder, &TiandituGeocoder::geocodeSucceeded);
+    geocoder.searchInAdminRegion(QStringLiteral("北京站"), QString::fromLatin1(REGION));
+    QCOMPARE(succeeded.size(), 1);
+    QCOMPARE(m_server.requestCount(), 1);
+}
+
+void TestGeocodeCache::roundTripThroughFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("geocode_cache.json"));
+    const QString key = GeocodeCache::makeKey(QStringLiteral("北京站"), QString::fromLatin1(REGION));
+
+    GeocodeCache::Entry entry;
+    entry.latitude = 39.902;
+    entry.longitude = 116.427;
+    entry.name = QStringLiteral("北京站");
+    entry.address = QStringLiteral("东城区毛家湾胡同甲13号");
+    {
+        GeocodeCache cache(path);
+        cache.insert(key, entry);
+        cache.flush();
+    }
+
+    GeocodeCache reloaded(path);
+    GeocodeCache::Entry loaded;
+    QVERIFY(reloaded.lookup(key, loaded));
+    QCOMPARE(loaded.latitude, entry.latitude);
+    QCOMPARE(loaded.longitude, entry.longitude);
+    QCOMPARE(loaded.name, entry.name);
+    QCOMPARE(loaded.address, entry.address);
+    QVERIFY(loaded.fetchedAt > 0);
+    QVERIFY(!reloaded.lookup(GeocodeCache::makeKey(QStringLiteral("北京站"), QStringLiteral("156120000")),
+                             loaded));
+}
+
+void TestGeocodeCache::expiredEntriesMiss()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("geocode_cache.json"));
+    const QString key = GeocodeCache::makeKey(QStringLiteral("北京站"), QString::fromLatin1(REGION));
+
+    GeocodeCache::Entry entry;
+    entry.name = QStringLiteral("北京站");
+    entry.fetchedAt = QDateTime::currentSecsSinceEpoch() - 3600;
+    {
+        GeocodeCache cache(path);
+        cache.setTimeToLive(60);
+        cache.insert(key, entry);
+
+        GeocodeCache::Entry loaded;
+        QVERIFY(!cache.lookup(key, loaded));
+    } // 过期条目不写盘
+
+    GeocodeCache reloaded(path);
+    QCOMPARE(reloaded.size(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestGeocodeCache)
+#include "tst_geocodecache.moc"
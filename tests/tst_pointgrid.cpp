@@ -0,0 +1,85 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include "PointGrid.h"
+#include "StopDetector.h"
+
+class TestPointGrid : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesLinearScan();
+    void skipsInvalidCoordinates();
+    void stopsNearUsesCentroids();
+};
+
+void TestPointGrid::matchesLinearScan()
+{
+    // 天津周边约 1 度范围内的随机点，外加一个远处的离群点
+    QRandomGenerator random(20250523);
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+    for (int i = 0; i < 5000; ++i) {
+        latitudes.append(39.0 + random.generateDouble());
+        longitudes.append(117.0 + random.generateDouble());
+    }
+    latitudes.append(22.5);
+    longitudes.append(114.0);
+
+    PointGrid grid;
+    grid.build(latitudes, longitudes);
+    QCOMPARE(grid.size(), latitudes.size());
+
+    const QList<QPair<QGeoCoordinate, double>> queries = {
+        {QGeoCoordinate(39.5, 117.5), 500.0},
+        {QGeoCoordinate(39.5, 117.5), 20000.0},
+        {QGeoCoordinate(39.0, 117.0), 3000.0},
+        {QGeoCoordinate(22.5, 114.0), 10.0},
+        {QGeoCoordinate(30.0, 100.0), 1000.0},
+    };
+    for (const auto& query : queries) {
+        QVector<int> expected;
+        for (int i = 0; i < latitudes.size(); ++i) {
+            if (query.first.distanceTo(QGeoCoordinate(latitudes[i], longitudes[i])) <= query.second) {
+                expected.append(i);
+            }
+        }
+        QCOMPARE(grid.pointsWithin(query.first, query.second), expected);
+    }
+}
+
+void TestPointGrid::skipsInvalidCoordinates()
+{
+    PointGrid grid;
+    grid.build({39.0, qQNaN(), 39.0001}, {117.0, 117.0, 117.0});
+    QCOMPARE(grid.pointsWithin(QGeoCoordinate(39.0, 117.0), 50.0), (QVector<int>{0, 2}));
+
+    grid.build({qQNaN()}, {qQNaN()});
+    QVERIFY(grid.isEmpty());
+    QVERIFY(grid.pointsWithin(QGeoCoordinate(39.0, 117.0), 1e6).isEmpty());
+}
+
+void TestPointGrid::stopsNearUsesCentroids()
+{
+    const QDateTime start(QDate(2025, 5, 23), QTime(8, 0));
+    QList<StopDetector::StopEvent> stops;
+    for (int i = 0; i < 3; ++i) {
+        StopDetector::StopEvent stop;
+        stop.startTime = start.addSecs(i * 3600);
+        stop.endTime = stop.startTime.addSecs(600);
+        stop.centroid = QGeoCoordinate(39.0 + i * 0.1, 117.0);
+        stops.append(stop);
+    }
+
+    StopDetector detector;
+    detector.setStops(stops);
+    const auto near = detector.stopsNear(QGeoCoordinate(39.1, 117.0), 1000.0);
+    QCOMPARE(near.size(), 1);
+    QCOMPARE(near.first().startTime, stops[1].startTime);
+
+    detector.clear();
+    QVERIFY(detector.stopsNear(QGeoCoordinate(39.1, 117.0), 1000.0).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestPointGrid)
+#include "tst_pointgrid.moc"
@@ -0,0 +1,93 @@
+#include <QtTest>
+#include "TripSegmenter.h"
+
+class TestTripSegmenter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void longStopSplitsTrips();
+    void stopNotCountedInNextTrip();
+
+private:
+    static ExcelDataReader::VehicleRecord record(const QDateTime& timestamp, double latitude, double longitude);
+    static StopDetector::StopEvent stop(int trajectoryIndex, const QDateTime& startTime, const QDateTime& endTime);
+};
+
+ExcelDataReader::VehicleRecord TestTripSegmenter::record(const QDateTime& timestamp,
+                                                          double latitude, double longitude)
+{
+    ExcelDataReader::VehicleRecord result;
+    result.plateNumber = QStringLiteral("冀JY8706");
+    result.speed = 60.0;
+    result.latitude = latitude;
+    result.longitude = longitude;
+    result.direction = 0;
+    result.distance = 0.0;
+    result.timestamp = timestamp;
+    return result;
+}
+
+StopDetector::StopEvent TestTripSegmenter::stop(int trajectoryIndex, const QDateTime& startTime,
+                                                const QDateTime& endTime)
+{
+    StopDetector::StopEvent result;
+    result.trajectoryIndex = trajectoryIndex;
+    result.startTime = startTime;
+    result.endTime = endTime;
+    result.pointCount = 2;
+    return result;
+}
+
+void TestTripSegmenter::longStopSplitsTrips()
+{
+    const QDateTime start(QDate(2025, 5, 23), QTime(8, 0));
+    const QList<ExcelDataReader::VehicleRecord> trajectory = {
+        record(start, 39.00, 117.00),
+        record(start.addSecs(600), 39.05, 117.00),
+        record(start.addSecs(3 * 3600 + 1200), 39.10, 117.00),
+    };
+    const QList<StopDetector::StopEvent> stops = {
+        stop(1, start.addSecs(600), start.addSecs(3 * 3600 + 600)),
+    };
+
+    const auto trips = TripSegmenter::segment(trajectory, stops);
+    QCOMPARE(trips.size(), 2);
+    QCOMPARE(trips[0].startIndex, 0);
+    QCOMPARE(trips[0].endIndex, 1);
+    QCOMPARE(trips[1].startIndex, 1);
+    QCOMPARE(trips[1].endIndex, 2);
+}
+
+void TestTripSegmenter::stopNotCountedInNextTrip()
+{
+    // 08:10 到 11:10 停留三小时，之后 20 分钟行驶到下一点
+    const QDateTime start(QDate(2025, 5, 23), QTime(8, 0));
+    const QDateTime stopEnd = start.addSecs(3 * 3600 + 600);
+    const QList<ExcelDataReader::VehicleRecord> trajectory = {
+        record(start, 39.00, 117.00),
+        record(start.addSecs(600), 39.05, 117.00),
+        record(stopEnd.addSecs(600), 39.10, 117.00),
+        record(stopEnd.addSecs(1200), 39.15, 117.00),
+    };
+    const QList<StopDetector::StopEvent> stops = {
+        stop(1, start.addSecs(600), stopEnd),
+    };
+
+    const auto trips = TripSegmenter::segment(trajectory, stops);
+    QCOMPARE(trips.size(), 2);
+
+    const auto& second = trips[1];
+    QCOMPARE(second.startTime, stopEnd);
+    QCOMPARE(second.endTime, stopEnd.addSecs(1200));
+    QCOMPARE(second.durationSecs, qint64(1200));
+
+    const double distanceKm = (trajectory[1].coordinate().distanceTo(trajectory[2].coordinate()) +
+                               trajectory[2].coordinate().distanceTo(trajectory[3].coordinate())) / 1000.0;
+    QVERIFY(qAbs(second.distanceKm - distanceKm) < 1e-9);
+    QVERIFY(qAbs(second.avgSpeed - distanceKm * 3600.0 / 1200.0) < 1e-9);
+    QVERIFY(second.avgSpeed > 30.0);   // 约 11 km / 20 分钟；若计入停留只有约 3.5 km/h
+}
+
+QTEST_GUILESS_MAIN(TestTripSegmenter)
+#include "tst_tripsegmenter.moc"
@@ -0,0 +1,144 @@
+#include <QtTest>
+#include "ValidationReport.h"
+
+class TestValidationReport : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mergeRemapsFileIndices();
+    void chunkReportsJoinCurrentFile();
+    void mergeCapsSamples();
+    void mergeCapsRanges();
+
+private:
+    // 不调用 beginFile 的块报告，rows 中每行记一次 rule 并尽量采样
+    static ValidationReport chunkReport(ValidationReport::Rule rule, const QList<int>& rows);
+};
+
+ValidationReport TestValidationReport::chunkReport(ValidationReport::Rule rule, const QList<int>& rows)
+{
+    ValidationReport report;
+    for (int row : rows) {
+        report.record(rule, row);
+        report.addSample(rule, row, "冀JY8706", QString("row %1").arg(row));
+    }
+    report.addProcessedRows(int(rows.size()));
+    return report;
+}
+
+void TestValidationReport::mergeRemapsFileIndices()
+{
+    ValidationReport total;
+    total.beginFile("a.xlsx");
+    total.record(ValidationReport::ParseFailed, 3);
+    total.addSample(ValidationReport::ParseFailed, 3, QString(), "日期格式错误");
+
+    ValidationReport other;
+    other.beginFile("b.xlsx");
+    other.record(ValidationReport::ParseFailed, 7);
+    other.beginFile("c.xlsx");
+    other.record(ValidationReport::ParseFailed, 8);
+    other.addSample(ValidationReport::ParseFailed, 8, "冀JY8706", "缺少经度");
+    other.addProcessedRows(20);
+
+    total.merge(other);
+    QCOMPARE(total.fileCount(), 3);
+    QCOMPARE(total.count(ValidationReport::ParseFailed), 3);
+    QCOMPARE(total.processedRows(), 20);
+
+    const auto& stats = total.stats(ValidationReport::ParseFailed);
+    QCOMPARE(stats.samples.size(), 2);
+    QCOMPARE(stats.samples[0].fileIndex, 0);
+    QCOMPARE(stats.samples[1].fileIndex, 2);
+    QCOMPARE(total.formatSample(stats.samples[1]), QString("c.xlsx 第8行 冀JY8706：缺少经度"));
+    QCOMPARE(total.formatRanges(ValidationReport::ParseFailed), QString("a.xlsx 第3行；b.xlsx 第7行；c.xlsx 第8行"));
+
+    // 之后记录的问题仍归属合并前的当前文件
+    total.record(ValidationReport::ParseFailed, 4);
+    QCOMPARE(total.stats(ValidationReport::ParseFailed).ranges.last().fileIndex, 0);
+    QCOMPARE(total.formatRanges(ValidationReport::ParseFailed),
+             QString("a.xlsx 第3行；b.xlsx 第7行；c.xlsx 第8行；a.xlsx 第4行"));
+}
+
+void TestValidationReport::chunkReportsJoinCurrentFile()
+{
+    ValidationReport total;
+    total.beginFile("a.xlsx");
+    total.merge(chunkReport(ValidationReport::InvalidRecord, {2, 3, 4}));
+    total.merge(chunkReport(ValidationReport::InvalidRecord, {5, 6, 9}));
+
+    QCOMPARE(total.fileCount(), 1);
+    QCOMPARE(total.processedRows(), 6);
+    QCOMPARE(total.skippedRows(), 6);
+    QCOMPARE(total.stats(ValidationReport::InvalidRecord).ranges.size(), 2);
+    QCOMPARE(total.formatRanges(ValidationReport::InvalidRecord), QString("a.xlsx 第2-6、9行"));
+    QCOMPARE(total.stats(ValidationReport::InvalidRecord).samples.first().fileIndex, 0);
+
+    // 下一个文件的块不与上一个文件末尾的行号相连
+    total.beginFile("b.xlsx");
+    total.merge(chunkReport(ValidationReport::InvalidRecord, {10}));
+    QCOMPARE(total.formatRanges(ValidationReport::InvalidRecord), QString("a.xlsx 第2-6、9行；b.xlsx 第10行"));
+}
+
+void TestValidationReport::mergeCapsSamples()
+{
+    ValidationReport total;
+    total.beginFile("a.xlsx");
+    for (int chunk = 0; chunk < 3; ++chunk) {
+        QList<int> rows;
+        for (int i = 0; i < 10; ++i) {
+            rows.append(chunk * 100 + i * 2);
+        }
+        ValidationReport report = chunkReport(ValidationReport::SpeedTooHigh, rows);
+        QCOMPARE(report.stats(ValidationReport::SpeedTooHigh).samples.size(), ValidationReport::MAX_SAMPLES);
+        total.merge(report);
+    }
+
+    const auto& stats = total.stats(ValidationReport::SpeedTooHigh);
+    QCOMPARE(total.count(ValidationReport::SpeedTooHigh), 30);
+    QCOMPARE(stats.samples.size(), ValidationReport::MAX_SAMPLES);
+    for (int i = 0; i < stats.samples.size(); ++i) {
+        QCOMPARE(stats.samples[i].row, i * 2);  // 按块顺序保留最早的示例
+    }
+    QVERIFY(!total.needsSample(ValidationReport::SpeedTooHigh));
+}
+
+void TestValidationReport::mergeCapsRanges()
+{
+    QList<int> rows;
+    for (int i = 0; i < ValidationReport::MAX_RANGES; ++i) {
+        rows.append(i * 10);
+    }
+
+    ValidationReport total;
+    total.beginFile("a.xlsx");
+    total.merge(chunkReport(ValidationReport::OutOfChinaRange, rows));
+    QCOMPARE(total.stats(ValidationReport::OutOfChinaRange).ranges.size(), ValidationReport::MAX_RANGES);
+    QVERIFY(!total.stats(ValidationReport::OutOfChinaRange).rangesTruncated);
+
+    // 与末尾相邻的区间仍可延长，其余超出上限
+    QList<int> more = {rows.last() + 1};
+    for (int i = 0; i < 10; ++i) {
+        more.append(10000 + i * 10);
+    }
+    total.merge(chunkReport(ValidationReport::OutOfChinaRange, more));
+    const auto& stats = total.stats(ValidationReport::OutOfChinaRange);
+    QCOMPARE(stats.ranges.size(), ValidationReport::MAX_RANGES);
+    QCOMPARE(stats.ranges.last().lastRow, rows.last() + 1);
+    QVERIFY(stats.rangesTruncated);
+    QCOMPARE(total.count(ValidationReport::OutOfChinaRange), qint64(ValidationReport::MAX_RANGES + more.size()));
+    QVERIFY(total.formatRanges(ValidationReport::OutOfChinaRange).endsWith(" 等"));
+
+    // 块报告自身已截断时合并结果同样标记
+    ValidationReport truncatedChunk = chunkReport(ValidationReport::SpeedTooHigh, rows);
+    truncatedChunk.record(ValidationReport::SpeedTooHigh, 100000);
+    QVERIFY(truncatedChunk.stats(ValidationReport::SpeedTooHigh).rangesTruncated);
+    ValidationReport other;
+    other.beginFile("b.xlsx");
+    other.merge(truncatedChunk);
+    QVERIFY(other.stats(ValidationReport::SpeedTooHigh).rangesTruncated);
+}
+
+QTEST_GUILESS_MAIN(TestValidationReport)
+#include "tst_validationreport.moc"
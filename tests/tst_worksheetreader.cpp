@@ -0,0 +1,95 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "WorksheetReader.h"
+#include "XlsxTestFile.h"
+
+class TestWorksheetReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rowsWithoutReferenceAcrossChunks();
+    void rowReferencesAcrossChunks();
+
+private:
+    // 按块读取并解析，返回解析出的 (行号, 第一列) 序列
+    static QList<QPair<int, QString>> readAll(const QString& filePath, qsizetype chunkSize, int& chunkCount);
+
+    QTemporaryDir m_dir;
+};
+
+QList<QPair<int, QString>> TestWorksheetReader::readAll(const QString& filePath, qsizetype chunkSize,
+                                                        int& chunkCount)
+{
+    QList<QPair<int, QString>> rows;
+    chunkCount = 0;
+
+    WorksheetReader reader;
+    QString errorMessage;
+    if (!reader.open(filePath, errorMessage)) {
+        qWarning() << errorMessage;
+        return rows;
+    }
+    reader.readChunks(chunkSize, [&](const QByteArray& chunk, int previousRow) {
+        chunkCount++;
+        WorksheetReader::parseRows(chunk, previousRow, reader.sharedStrings(), 0,
+                                   [&](int row, const WorksheetReader::RowCells& cells) {
+            rows.append({row, cells.isEmpty() ? QString() : cells[0].toString()});
+            return true;
+        });
+        return true;
+    }, errorMessage);
+    return rows;
+}
+
+void TestWorksheetReader::rowsWithoutReferenceAcrossChunks()
+{
+    QVERIFY(m_dir.isValid());
+    const int rowCount = 20000;     // 约 1.3MB，解压回调每次 256KB，切成多块
+    QByteArray rows;
+    for (int row = 1; row <= rowCount; ++row) {
+        rows += "<row><c t=\"inlineStr\"><is><t>R" + QByteArray::number(row) + "</t></is></c>"
+                "<c><v>" + QByteArray::number(row * 10) + "</v></c></row>";
+    }
+    const QString filePath = m_dir.filePath("no_reference.xlsx");
+    QVERIFY(XlsxTestFile::writeWorksheet(filePath, rows));
+
+    int chunkCount = 0;
+    const auto parsed = readAll(filePath, 4096, chunkCount);
+    QVERIFY(chunkCount > 2);
+    QCOMPARE(parsed.size(), rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        QCOMPARE(parsed[i].first, i + 1);
+        QCOMPARE(parsed[i].second, QString("R%1").arg(i + 1));
+    }
+}
+
+void TestWorksheetReader::rowReferencesAcrossChunks()
+{
+    // 只有部分行带 r：带 r 的行按属性编号，之后的行顺延，跨块时保持一致
+    QVERIFY(m_dir.isValid());
+    QByteArray rows;
+    QList<int> expected;
+    int row = 0;
+    for (int i = 0; i < 20000; ++i) {
+        row += (i % 100 == 0) ? 3 : 1;
+        const QByteArray reference = (i % 100 == 0) ? " r=\"" + QByteArray::number(row) + "\"" : QByteArray();
+        rows += "<row" + reference + "><c t=\"inlineStr\"><is><t>R" + QByteArray::number(row) +
+                "</t></is></c></row>";
+        expected.append(row);
+    }
+    const QString filePath = m_dir.filePath("partial_reference.xlsx");
+    QVERIFY(XlsxTestFile::writeWorksheet(filePath, rows, "A1:A" + QByteArray::number(row)));
+
+    int chunkCount = 0;
+    const auto parsed = readAll(filePath, 4096, chunkCount);
+    QVERIFY(chunkCount > 2);
+    QCOMPARE(parsed.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QCOMPARE(parsed[i].first, expected[i]);
+        QCOMPARE(parsed[i].second, QString("R%1").arg(expected[i]));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestWorksheetReader)
+#include "tst_worksheetreader.moc"
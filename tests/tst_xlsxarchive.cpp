@@ -0,0 +1,89 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "XlsxArchive.h"
+#include "XlsxTestFile.h"
+
+class TestXlsxArchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readsStoredEntry();
+    void rejectsStoredSizeMismatch();
+    void rejectsDirectoryOutOfRange();
+
+private:
+    // 修改已写好的文件中某个位置的 32 位字段
+    static bool patchU32(const QString& filePath, qint64 offset, quint32 value);
+
+    QTemporaryDir m_dir;
+};
+
+bool TestXlsxArchive::patchU32(const QString& filePath, qint64 offset, quint32 value)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(offset)) {
+        return false;
+    }
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    return file.write(bytes, 4) == 4;
+}
+
+void TestXlsxArchive::readsStoredEntry()
+{
+    QVERIFY(m_dir.isValid());
+    const QString filePath = m_dir.filePath("stored.xlsx");
+    QVERIFY(XlsxTestFile::write(filePath, {{"a.txt", "hello"}, {"b.txt", QByteArray(1000, 'x')}}));
+
+    XlsxArchive archive;
+    QString errorMessage;
+    QVERIFY2(archive.open(filePath, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(archive.entryNames(), QStringList({"a.txt", "b.txt"}));
+
+    QByteArray buffer;
+    QVERIFY(archive.readEntry(*archive.findEntry("a.txt"), buffer, errorMessage));
+    QCOMPARE(buffer, QByteArray("hello"));
+    QVERIFY(archive.readEntry(*archive.findEntry("b.txt"), buffer, errorMessage));
+    QCOMPARE(buffer, QByteArray(1000, 'x'));
+}
+
+void TestXlsxArchive::rejectsStoredSizeMismatch()
+{
+    QVERIFY(m_dir.isValid());
+    const QString filePath = m_dir.filePath("mismatch.xlsx");
+    QVERIFY(XlsxTestFile::write(filePath, {{"a.txt", "hello"}}));
+
+    // 中央目录紧跟在唯一条目之后：本地头 30 + 名称 5 + 数据 5；原始大小字段偏移 24
+    QVERIFY(patchU32(filePath, 30 + 5 + 5 + 24, 1 << 20));
+
+    XlsxArchive archive;
+    QString errorMessage;
+    QVERIFY2(archive.open(filePath, errorMessage), qPrintable(errorMessage));
+    const XlsxArchive::Entry* entry = archive.findEntry("a.txt");
+    QVERIFY(entry);
+    QCOMPARE(entry->uncompressedSize, qint64(1 << 20));
+
+    QByteArray buffer;
+    QVERIFY(!archive.readEntry(*entry, buffer, errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void TestXlsxArchive::rejectsDirectoryOutOfRange()
+{
+    QVERIFY(m_dir.isValid());
+    const QString filePath = m_dir.filePath("directory.xlsx");
+    QVERIFY(XlsxTestFile::write(filePath, {{"a.txt", "hello"}}));
+
+    // 结束记录中的中央目录大小（偏移 12）改为接近 32 位上限
+    const qint64 endOffset = QFileInfo(filePath).size() - 22;
+    QVERIFY(patchU32(filePath, endOffset + 12, 0xFFFFFFF0));
+
+    XlsxArchive archive;
+    QString errorMessage;
+    QVERIFY(!archive.open(filePath, errorMessage));
+    QVERIFY(!archive.isOpen());
+}
+
+QTEST_GUILESS_MAIN(TestXlsxArchive)
+#include "tst_xlsxarchive.moc"